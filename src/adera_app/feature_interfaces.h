@@ -162,6 +162,7 @@ struct FIMainApp {
         DataId resources;
         DataId mainLoopCtrl;
         DataId frameworkModify;
+        DataId workerPool;
     };
 
     struct Pipelines {
@@ -238,6 +239,8 @@ struct FIPhysics {
         DataId phys;
         DataId hierBody;
         DataId physIn;
+        DataId stepper;
+        DataId interp;
     };
 
     struct Pipelines {
@@ -477,6 +480,14 @@ struct FIRocketsJolt {
     struct Pipelines { };
 };
 
+struct FITerrainCollidersJolt {
+    struct DataIds {
+        DataId terrainColliders;
+    };
+
+    struct Pipelines { };
+};
+
 
 struct FITerrain {
     struct DataIds {
@@ -601,6 +612,7 @@ struct FISceneRenderer {
     struct DataIds {
         DataId scnRender;
         DataId drawTfObservers;
+        DataId culling;
     };
 
     struct Pipelines {
@@ -617,6 +629,7 @@ struct FISceneRenderer {
         PipelineDef<EStgIntr> materialDirty     {"materialDirty"};
 
         PipelineDef<EStgIntr> drawTransforms    {"drawTransforms"};
+        PipelineDef<EStgIntr> culling           {"culling           - DrawEnts in view of the camera, see ACtxCulling"};
 
         PipelineDef<EStgCont> group             {"group"};
         PipelineDef<EStgCont> groupEnts         {"groupEnts"};
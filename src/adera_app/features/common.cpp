@@ -31,9 +31,14 @@
 #include <osp/activescene/basic_fn.h>
 #include <osp/core/Resources.h>
 #include <osp/core/unpack.h>
+#include <osp/drawing/culling.h>
 #include <osp/drawing/drawing_fn.h>
+#include <osp/drawing/own_restypes.h>
+#include <osp/tasks/worker_pool.h>
 #include <osp/util/UserInputHandler.h>
 
+#include <algorithm>
+
 using namespace adera;
 using namespace ftr_inter::stages;
 using namespace ftr_inter;
@@ -51,6 +56,7 @@ FeatureDef const ftrMain = feature_def("Main", [] (FeatureBuilder &rFB, Implemen
     rFB.data_emplace< MainLoopControl >         (mainApp.di.mainLoopCtrl);
     rFB.data_emplace< osp::Resources >          (mainApp.di.resources);
     rFB.data_emplace< FrameworkModify >         (mainApp.di.frameworkModify);
+    rFB.data_emplace< osp::WorkerPool >         (mainApp.di.workerPool, osp::WorkerPool::default_thread_count());
 
     rFB.pipeline(mainApp.pl.mainLoop).loops(true).wait_for_signal(ModifyOrSignal);
     rFB.pipeline(mainApp.pl.stupidWorkaround).parent(mainApp.pl.mainLoop);
@@ -114,8 +120,13 @@ FeatureDef const ftrCommonScene = feature_def("CommonScene", [] (
         .name       ("Cancel entity delete tasks stuff if no entities were deleted")
         .run_on     ({comScn.pl.activeEntDelete(Schedule_)})
         .args       ({     comScn.di.basic,  comScn.di.activeEntDel })
-        .func       ([] (ACtxBasic &rBasic, ActiveEntVec_t const &rActiveEntDel) noexcept
+        .func       ([] (ACtxBasic &rBasic, ActiveEntVec_t &rActiveEntDel) noexcept
     {
+        // Sorted and unique, so delete tasks below remove from each container in a single
+        // ascending pass. Duplicates come from queueing an entity along with its ancestor.
+        std::sort(rActiveEntDel.begin(), rActiveEntDel.end());
+        rActiveEntDel.erase(std::unique(rActiveEntDel.begin(), rActiveEntDel.end()), rActiveEntDel.end());
+
         return rActiveEntDel.empty() ? TaskAction::Cancel : TaskActions{};
     });
 
@@ -193,6 +204,19 @@ FeatureDef const ftrCommonScene = feature_def("CommonScene", [] (
     rNamedMeshes.m_shapeToMesh.emplace(EShape::Sphere,    quick_add_mesh("sphere"));
     rNamedMeshes.m_namedMeshs.emplace("floor", quick_add_mesh("grid64solid"));
 
+    // Meshes loaded from glTF files may come with levels of detail named "<name>_LOD1", ...
+    // Register them so SysMeshLod can swap them in for DrawEnts using the full detail mesh.
+    PkgId const pkg = entt::any_cast<PkgId>(userData);
+    for (ResId const meshRes : rResources.ids(restypes::gc_mesh))
+    {
+        std::string_view const name = rResources.name(restypes::gc_mesh, meshRes);
+        if (   rResources.find(restypes::gc_mesh, pkg, name) == meshRes
+            && rResources.find(restypes::gc_mesh, pkg, string_concat(name, "_LOD1")) != lgrn::id_null<ResId>() )
+        {
+            SysRender::add_mesh_lods(rDrawing, rDrawingRes, rResources, pkg, name, {});
+        }
+    }
+
 }); // ftrCommonScene
 
 
@@ -249,6 +273,7 @@ FeatureDef const ftrSceneRenderer = feature_def("SceneRenderer", [] (
     rFB.pipeline(scnRender.pl.entTextureDirty) .parent(windowApp.pl.sync);
     rFB.pipeline(scnRender.pl.entMeshDirty)    .parent(windowApp.pl.sync);
     rFB.pipeline(scnRender.pl.drawTransforms)  .parent(scnRender.pl.render);
+    rFB.pipeline(scnRender.pl.culling)         .parent(scnRender.pl.render);
     rFB.pipeline(scnRender.pl.material)        .parent(windowApp.pl.sync);
     rFB.pipeline(scnRender.pl.materialDirty)   .parent(windowApp.pl.sync);
     rFB.pipeline(scnRender.pl.group)           .parent(windowApp.pl.sync);
@@ -262,6 +287,7 @@ FeatureDef const ftrSceneRenderer = feature_def("SceneRenderer", [] (
 
     auto &rScnRender = rFB.data_emplace<ACtxSceneRender>(scnRender.di.scnRender);
     /* unused */       rFB.data_emplace<DrawTfObservers>(scnRender.di.drawTfObservers);
+    /* unused */       rFB.data_emplace<ACtxCulling>    (scnRender.di.culling);
 
     // TODO: format after framework changes
 
@@ -330,20 +356,23 @@ FeatureDef const ftrSceneRenderer = feature_def("SceneRenderer", [] (
         .run_on     ({scnRender.pl.render(Run)})
         .sync_with  ({comScn.pl.hierarchy(Ready), comScn.pl.transform(Ready), comScn.pl.activeEnt(Ready), scnRender.pl.drawTransforms(Modify_), scnRender.pl.drawEnt(Ready), scnRender.pl.drawEntResized(Done), comScn.pl.activeEntResized(Done)})
         .args       ({            comScn.di.basic,                   comScn.di.drawing,                 scnRender.di.scnRender,                 scnRender.di.drawTfObservers })
-        .func([] (ACtxBasic const &rBasic, ACtxDrawing const &rDrawing, ACtxSceneRender &rScnRender, DrawTfObservers &rDrawTfObservers) noexcept
+        .func([] (ACtxBasic &rBasic, ACtxDrawing const &rDrawing, ACtxSceneRender &rScnRender, DrawTfObservers &rDrawTfObservers) noexcept
     {
-        auto rootChildren = SysSceneGraph::children(rBasic.m_scnGraph);
-        SysRender::update_draw_transforms(
-                {
-                    .scnGraph     = rBasic    .m_scnGraph,
-                    .transforms   = rBasic    .m_transform,
-                    .activeToDraw = rScnRender.m_activeToDraw,
-                    .needDrawTf   = rScnRender.m_needDrawTf,
-                    .rDrawTf      = rScnRender.m_drawTransform
-                },
-                rootChildren.begin(),
-                rootChildren.end(),
-                [&rDrawTfObservers, &rScnRender] (Matrix4 const &transform, active::ActiveEnt ent, int depth)
+        ACtxSceneGraph &rScnGraph = rBasic.m_scnGraph;
+
+        auto const treeSize = TreePos_t(rScnGraph.m_treeToEnt.size());
+        rScnRender.m_treeDrawTf.resize(treeSize);
+
+        SysRender::ArgsForUpdDrawTransform const args
+        {
+            .scnGraph     = rScnGraph,
+            .transforms   = rBasic    .m_transform,
+            .activeToDraw = rScnRender.m_activeToDraw,
+            .needDrawTf   = rScnRender.m_needDrawTf,
+            .rDrawTf      = rScnRender.m_drawTransform
+        };
+
+        auto const notify_observers = [&rDrawTfObservers, &rScnRender] (Matrix4 const &transform, active::ActiveEnt ent, int depth)
         {
             auto const enableInt  = std::array{rScnRender.drawTfObserverEnable[ent]};
             auto const enableBits = lgrn::bit_view(enableInt);
@@ -353,7 +382,41 @@ FeatureDef const ftrSceneRenderer = feature_def("SceneRenderer", [] (
                 DrawTfObservers::Observer const &rObserver = rDrawTfObservers.observers[idx];
                 rObserver.func(rScnRender, transform, ent, depth, rObserver.data);
             }
-        });
+        };
+
+        // Ancestors may have been added to m_needDrawTf too, so recalculate the entire top-level
+        // subtree of each changed entity
+        for (ActiveEnt ent : rScnRender.m_drawTfChanged)
+        {
+            if (rScnGraph.m_entToTreePos[ent] == lgrn::id_null<TreePos_t>())
+            {
+                continue; // Deleted since
+            }
+            while (rScnGraph.m_entParent[ent] != lgrn::id_null<ActiveEnt>())
+            {
+                ent = rScnGraph.m_entParent[ent];
+            }
+            rScnGraph.m_transformDirty.insert(ent);
+        }
+        rScnRender.m_drawTfChanged.clear();
+
+        if (rScnRender.m_treeDrawTfVersion == rScnGraph.m_version)
+        {
+            // Static and sleeping entities are not visited at all
+            SysRender::update_draw_transforms_dirty(args, rScnRender.m_treeDrawTf,
+                                                    rScnGraph.m_transformDirty.begin(),
+                                                    rScnGraph.m_transformDirty.end(),
+                                                    notify_observers);
+        }
+        else
+        {
+            // Position 0 is the root, which has no entity
+            SysRender::gather_tree_transforms(args, rScnRender.m_treeDrawTf);
+            SysRender::update_draw_transforms_linear(args, rScnRender.m_treeDrawTf, 1, treeSize, notify_observers);
+            rScnRender.m_treeDrawTfVersion = rScnGraph.m_version;
+        }
+
+        rScnGraph.m_transformDirty.clear();
     });
 
     rFB.task()
@@ -365,7 +428,7 @@ FeatureDef const ftrSceneRenderer = feature_def("SceneRenderer", [] (
     {
         for (ActiveEnt const ent : rActiveEntDel)
         {
-            if (rScnRender.m_activeToDraw.size() < std::size_t(ent))
+            if (rScnRender.m_activeToDraw.size() <= std::size_t(ent))
             {
                 continue;
             }
@@ -375,6 +438,10 @@ FeatureDef const ftrSceneRenderer = feature_def("SceneRenderer", [] (
                 rDrawEntDel.push_back(drawEnt);
             }
         }
+
+        // Same as ActiveEnts, delete tasks below walk each per-DrawEnt container in a single
+        // ascending pass
+        std::sort(rDrawEntDel.begin(), rDrawEntDel.end());
     });
 
     rFB.task()
@@ -410,9 +477,10 @@ FeatureDef const ftrSceneRenderer = feature_def("SceneRenderer", [] (
         .args       ({            scnRender.di.scnRender,                    comScn.di.drawEntDel })
         .func([] (ACtxSceneRender &rScnRender, DrawEntVec_t const &rDrawEntDel) noexcept
     {
-        for (DrawEnt const ent : rDrawEntDel)
+        // One pass through each material's set instead of visiting every material per DrawEnt
+        for (Material &rMat : rScnRender.m_materials)
         {
-            for (Material &rMat : rScnRender.m_materials)
+            for (DrawEnt const ent : rDrawEntDel)
             {
                 if (std::size_t(ent) < rMat.m_ents.size())
                 {
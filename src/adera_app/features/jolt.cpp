@@ -39,6 +39,16 @@
 
 #include <ospjolt/activescene/joltinteg_fn.h>
 
+#include <planet-a/activescene/terrain.h>
+#include <planet-a/chunk_utils.h>
+#include <planet-a/icosahedron.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
 using namespace ftr_inter::stages;
 using namespace ftr_inter;
 using namespace osp::active;
@@ -57,18 +67,23 @@ namespace adera
 FeatureDef const ftrJolt = feature_def("Jolt", [] (
         FeatureBuilder              &rFB,
         Implement<FIJolt>           jolt,
+        DependOn<FIMainApp>         mainApp,
         DependOn<FIScene>           scn,
         DependOn<FICommonScene>     comScn,
-        DependOn<FIPhysics>         phys)
+        DependOn<FIPhysics>         phys,
+        entt::any                   userData)
 {
     //Mandatory Jolt setup steps (start of program)
     ACtxJoltWorld::initJoltGlobal();
     JPH_IF_ENABLE_ASSERTS(AssertFailed = AssertFailedImpl;)
 
+    auto const layers = userData /* if not null */ ? entt::any_cast<JoltLayerConfig>(userData)
+                                                   : JoltLayerConfig::make_default();
 
     rFB.pipeline(jolt.pl.joltBody).parent(scn.pl.update);
 
-    rFB.data_emplace< ACtxJoltWorld >(jolt.di.jolt, 2);
+    // Jolt jobs share the process-wide worker threads
+    rFB.data_emplace< ACtxJoltWorld >(jolt.di.jolt, rFB.data_get<osp::WorkerPool>(mainApp.di.workerPool), layers);
 
     using ospjolt::SysJolt;
 
@@ -86,13 +101,14 @@ FeatureDef const ftrJolt = feature_def("Jolt", [] (
         .name       ("Update Jolt world")
         .run_on     ({scn.pl.update(Run)})
         .sync_with  ({jolt.pl.joltBody(Prev), comScn.pl.hierarchy(Prev), phys.pl.physBody(Prev), phys.pl.physUpdate(Run), comScn.pl.transform(Prev)})
-        .args({             comScn.di.basic,             phys.di.phys,              jolt.di.jolt,           scn.di.deltaTimeIn })
-        .func([] (ACtxBasic& rBasic, ACtxPhysics& rPhys, ACtxJoltWorld& rJolt, float const deltaTimeIn) noexcept
+        .args({             comScn.di.basic,             phys.di.phys,              jolt.di.jolt,                   phys.di.stepper,                phys.di.interp })
+        .func([] (ACtxBasic& rBasic, ACtxPhysics& rPhys, ACtxJoltWorld& rJolt, ACtxPhysStepper const& rStepper, ACtxPhysInterp& rInterp) noexcept
     {
-        SysJolt::update_world(rPhys, rJolt, deltaTimeIn, rBasic.m_transform);
+        SysJolt::update_translate(rPhys, rJolt, rBasic.m_transform, rBasic.m_scnGraph.m_transformDirty);
+        SysJolt::update_world(rPhys, rJolt, rStepper.fixedStep, rStepper.substeps,
+                              rBasic.m_transform, rBasic.m_scnGraph.m_transformDirty,
+                              rInterp.enabled ? &rInterp : nullptr);
     });
-
-    rFB.data_emplace< ACtxJoltWorld >(jolt.di.jolt, 2);
 }); // ftrJolt
 
 
@@ -115,14 +131,14 @@ ForceFactors_t add_constant_acceleration(
 
     ACtxJoltWorld::ForceFactorFunc factor
     {
-        .m_func = [] (BodyId const bodyId, ACtxJoltWorld const& rJolt, entt::any userData, Vector3& rForce, Vector3& rTorque) noexcept
+        .m_func = [] (ForceFactorBatch const& batch, ACtxJoltWorld const& rJolt, entt::any const& userData) noexcept
         {
-            Vector3 const force = entt::any_cast<Vector3>(userData);
-            PhysicsSystem *pJoltWorld = rJolt.m_pPhysicsSystem.get();
-
-            float inv_mass = SysJolt::get_inverse_mass_no_lock(*pJoltWorld, bodyId);
+            Vector3 const accel = entt::any_cast<Vector3>(userData);
 
-            rForce += force / inv_mass;
+            for (std::size_t i = 0; i < batch.bodies.size(); ++i)
+            {
+                batch.forces[i] += accel / batch.invMass[i];
+            }
         },
         .m_userData = entt::make_any<Vector3>(forceVec)
     };
@@ -159,30 +175,35 @@ FeatureDef const ftrPhysicsShapesJolt = feature_def("PhysicsShapesJolt", [] (
         .args       ({           comScn.di.basic,    physShapes.di.physShapes,       phys.di.phys,         jolt.di.jolt,    physShapesJolt.di.factors})
         .func       ([] (ACtxBasic const &rBasic, ACtxPhysShapes& rPhysShapes, ACtxPhysics& rPhys, ACtxJoltWorld& rJolt, ForceFactors_t const factors) noexcept
     {
-        PhysicsSystem *pJoltWorld = rJolt.m_pPhysicsSystem.get();
-        BodyInterface &bodyInterface = pJoltWorld->GetBodyInterface();
+        BodyInterface &bodyInterface = rJolt.m_pPhysicsSystem->GetBodyInterface();
 
-        int numBodies = static_cast<int>(rPhysShapes.m_spawnRequest.size());
+        std::size_t const numBodies = rPhysShapes.m_spawnRequest.size();
+        if (numBodies == 0)
+        {
+            return;
+        }
+
+        // Create all IDs first so body data only needs to be resized once per batch
+        std::vector<BodyId> addedBodies(numBodies);
+        rJolt.m_bodyIds.create(addedBodies.begin(), addedBodies.end());
+        SysJolt::resize_body_data(rJolt);
 
-        std::vector<JPH::BodyID> addedBodies;
-        addedBodies.reserve(numBodies);
-        
         for (std::size_t i = 0; i < numBodies; ++i)
         {
             SpawnShape const &spawn = rPhysShapes.m_spawnRequest[i];
             ActiveEnt const root    = rPhysShapes.m_ents[i * 2];
-            ActiveEnt const child   = rPhysShapes.m_ents[i * 2 + 1];
+            BodyId const bodyId     = addedBodies[i];
 
-            Ref<Shape> pShape = SysJolt::create_primitive(rJolt, spawn.m_shape, Vec3MagnumToJolt(spawn.m_size));
-            
-            BodyId const bodyId = rJolt.m_bodyIds.create();
-            SysJolt::resize_body_data(rJolt);
+            // Spawns of the same shape and size share one Jolt shape
+            Ref<Shape> pShape = SysJolt::get_primitive(rJolt, spawn.m_shape, spawn.m_size);
 
+            // Debris doesn't collide with other debris, so large numbers of it don't add pairs
+            // to the broadphase. Spawners opt into this through SpawnShape::m_debris.
             BodyCreationSettings bodyCreation(pShape, 
                                             Vec3MagnumToJolt(spawn.m_position), 
                                             Quat::sIdentity(), 
                                             EMotionType::Dynamic, 
-                                            Layers::MOVING);
+                                            spawn.m_debris ? Layers::DEBRIS : Layers::MOVING);
             
             if (spawn.m_mass > 0.0f) 
             { 
@@ -196,77 +217,23 @@ FeatureDef const ftrPhysicsShapesJolt = feature_def("PhysicsShapesJolt", [] (
             else
             {   
                 bodyCreation.mMotionType = EMotionType::Static;
-                bodyCreation.mObjectLayer = Layers::MOVING;
+                bodyCreation.mObjectLayer = Layers::NON_MOVING;
             }
             //TODO helper function ? 
             
-            JPH::BodyID joltBodyId = BToJolt(bodyId);
-            bodyInterface.CreateBodyWithID(joltBodyId, bodyCreation);
-            addedBodies.push_back(joltBodyId);
+            bodyInterface.CreateBodyWithID(BToJolt(bodyId), bodyCreation);
 
             rJolt.m_bodyToEnt[bodyId]    = root;
             rJolt.m_bodyFactors[bodyId]  = factors;
             rJolt.m_entToBody.emplace(root, bodyId);
-
         }
+
         //Bodies are added all at once for performance reasons.
-        BodyInterface::AddState addState = bodyInterface.AddBodiesPrepare(addedBodies.data(), numBodies);
-        bodyInterface.AddBodiesFinalize(addedBodies.data(), numBodies, addState, EActivation::Activate);
+        SysJolt::add_bodies(rJolt, arrayView(std::as_const(addedBodies)), EActivation::Activate);
     });
 
 }); // ftrPhysicsShapesJolt
 
-void compound_collect_recurse(
-        ACtxPhysics const&      rCtxPhys,
-        ACtxJoltWorld&          rCtxWorld,
-        ACtxBasic const&        rBasic,
-        ActiveEnt               ent,
-        Matrix4 const&          transform,
-        CompoundShapeSettings&  rCompound)
-{
-    EShape const shape = rCtxPhys.m_shape[ent];
-
-    if (shape != EShape::None)
-    {
-        bool entExists = rCtxWorld.m_shapes.contains(ent);
-        Ref<Shape> rShape = entExists
-                               ? rCtxWorld.m_shapes.get(ent)
-                               : rCtxWorld.m_shapes.emplace(ent);
-
-        if (!entExists)
-        {
-            rShape = SysJolt::create_primitive(rCtxWorld, shape, Vec3MagnumToJolt(transform.scaling()));
-        }
-        else 
-        {
-            SysJolt::scale_shape(rShape, Vec3MagnumToJolt(transform.scaling()));
-        }
-
-        rCompound.AddShape( Vec3MagnumToJolt(transform.translation()), 
-                            QuatMagnumToJolt(osp::Quaternion::fromMatrix(transform.rotation())), 
-                            rShape);
-    }
-
-    if ( ! rCtxPhys.m_hasColliders.contains(ent) )
-    {
-        return;
-    }
-
-    // Recurse into children if there are more colliders
-    for (ActiveEnt child : SysSceneGraph::children(rBasic.m_scnGraph, ent))
-    {
-        if (rBasic.m_transform.contains(child))
-        {
-            ACompTransform const &rChildTransform = rBasic.m_transform.get(child);
-
-            Matrix4 const childMatrix = transform * rChildTransform.m_transform;
-
-            compound_collect_recurse(
-                    rCtxPhys, rCtxWorld, rBasic, child, childMatrix, rCompound);
-        }
-    }
-} // void compound_collect_recurse
-
 
 FeatureDef const ftrVehicleSpawnJolt = feature_def("VehicleSpawnJolt", [] (
         FeatureBuilder              &rFB,
@@ -381,7 +348,8 @@ FeatureDef const ftrVehicleSpawnJolt = feature_def("VehicleSpawnJolt", [] (
         PhysicsSystem *pJoltWorld = rJolt.m_pPhysicsSystem.get();
         BodyInterface &bodyInterface = pJoltWorld->GetBodyInterface();
 
-        std::vector<JPH::BodyID> addedBodies;
+        std::vector<JPH::BodyID>    addedBodies;
+        std::vector<CompoundLeaf>   leaves;
 
         for (ACtxVehicleSpawn::TmpToInit const& toInit : rVehicleSpawn.spawnRequest)
         {
@@ -392,18 +360,18 @@ FeatureDef const ftrVehicleSpawnJolt = feature_def("VehicleSpawnJolt", [] (
 
             std::for_each(itWeldsFirst + std::ptrdiff_t{*itWeldOffsets},
                           itWeldsFirst + std::ptrdiff_t{weldOffsetNext},
-                          [&rBasic, &rScnParts, &rVehicleSpawn, &toInit, &rPhys, &rJolt, &addedBodies, factors] (WeldId const weld)
+                          [&rBasic, &rScnParts, &rVehicleSpawn, &toInit, &rPhys, &rJolt, &addedBodies, &leaves, factors] (WeldId const weld)
             {
                 ActiveEnt const weldEnt = rScnParts.weldToActive[weld];
 
-                MutableCompoundShapeSettings compound;
-
                 rPhys.m_hasColliders.insert(weldEnt);
 
-                // Collect all colliders from hierarchy.
-                compound_collect_recurse( rPhys, rJolt, rBasic, weldEnt, Matrix4{}, compound );
+                // Collect all colliders from hierarchy. Welds with identical colliders, such as
+                // copies of the same vehicle, share a single compound shape.
+                leaves.clear();
+                SysPhysics::collect_compound_leaves(rPhys, rBasic.m_scnGraph, rBasic.m_transform, weldEnt, Matrix4{}, leaves);
 
-                Ref<Shape> compoundShape = compound.Create().Get();
+                Ref<Shape> compoundShape = SysJolt::get_compound(rJolt, arrayView(std::as_const(leaves)));
                 BodyCreationSettings bodyCreation(compoundShape, Vec3Arg::sZero(), Quat::sZero(), EMotionType::Dynamic, Layers::MOVING);
 
                 BodyId const bodyId = rJolt.m_bodyIds.create();
@@ -597,6 +565,14 @@ static void assign_weld_rockets(
         rBodyFactors.set(rRocketsJolt.factorIndex);
         rRocketsJolt.m_bodyRockets.emplace(body.value, rRocketsFoundTemp.begin(), rRocketsFoundTemp.end());
     }
+
+    // Force factors are only evaluated for active bodies. Keep bodies with rockets awake, so
+    // throttling up a resting vehicle still moves it.
+    JPH::BodyLockWrite lock(rJolt.m_pPhysicsSystem->GetBodyLockInterface(), BToJolt(body));
+    if (lock.Succeeded())
+    {
+        lock.GetBody().SetAllowSleeping(rRocketsFoundTemp.empty());
+    }
 }
 
 struct RocketThrustUserData
@@ -606,24 +582,24 @@ struct RocketThrustUserData
     SignalValues_t<float> const &rSigValFloat;
 };
 
-// ACtxjoltWorld::ForceFactorFunc::Func_t
-static void rocket_thrust_force(BodyId const bodyId, ACtxJoltWorld const& rJolt, entt::any userData, Vector3& rForce, Vector3& rTorque) noexcept
+static void add_rocket_thrust(
+        BodyId                  const bodyId,
+        ACtxRocketsJolt         const &rRocketsJolt,
+        SignalValues_t<float>   const &rSigValFloat,
+        BodyInterface                 &rBodyInterface,
+        Vector3                       &rForce,
+        Vector3                       &rTorque) noexcept
 {
-    auto const [rRocketsJolt, rMachines, rSigValFloat] = entt::any_cast<RocketThrustUserData>(userData);
     auto &rBodyRockets = rRocketsJolt.m_bodyRockets[bodyId.value];
 
-    PhysicsSystem *pJoltWorld = rJolt.m_pPhysicsSystem.get();
-    //no lock as all bodies are locked in callbacks
-    BodyInterface &bodyInterface = pJoltWorld->GetBodyInterfaceNoLock();
-
     if (rBodyRockets.empty())
     {
         return;
     }
 
     JPH::BodyID joltBodyId = BToJolt(bodyId);
-    Quaternion const rot = QuatJoltToMagnum(bodyInterface.GetRotation(joltBodyId));
-    RVec3 joltCOM = bodyInterface.GetCenterOfMassPosition(joltBodyId) - bodyInterface.GetPosition(joltBodyId);
+    Quaternion const rot = QuatJoltToMagnum(rBodyInterface.GetRotation(joltBodyId));
+    RVec3 joltCOM = rBodyInterface.GetCenterOfMassPosition(joltBodyId) - rBodyInterface.GetPosition(joltBodyId);
     Vector3 com = Vec3JoltToMagnum(joltCOM);
 
     for (BodyRocket const& bodyRocket : rBodyRockets)
@@ -649,6 +625,21 @@ static void rocket_thrust_force(BodyId const bodyId, ACtxJoltWorld const& rJolt,
     }
 }
 
+// ACtxjoltWorld::ForceFactorFunc::Func_t
+static void rocket_thrust_force(ForceFactorBatch const& batch, ACtxJoltWorld const& rJolt, entt::any const& userData) noexcept
+{
+    auto const [rRocketsJolt, rMachines, rSigValFloat] = entt::any_cast<RocketThrustUserData>(userData);
+
+    PhysicsSystem *pJoltWorld = rJolt.m_pPhysicsSystem.get();
+    //no lock as all bodies are locked in callbacks
+    BodyInterface &bodyInterface = pJoltWorld->GetBodyInterfaceNoLock();
+
+    for (std::size_t i = 0; i < batch.bodies.size(); ++i)
+    {
+        add_rocket_thrust(batch.bodies[i], rRocketsJolt, rSigValFloat, bodyInterface, batch.forces[i], batch.torques[i]);
+    }
+}
+
 FeatureDef const ftrRocketThrustJolt = feature_def("RocketThrustJolt", [] (
         FeatureBuilder              &rFB,
         Implement<FIRocketsJolt>    rktJolt,
@@ -707,4 +698,298 @@ FeatureDef const ftrRocketThrustJolt = feature_def("RocketThrustJolt", [] (
 }); // ftrRocketThrustJolt
 
 
+struct TerrainColliderJolt
+{
+    BodyId          body;
+
+    /// Body position when built, relative to builtOrigin
+    Vector3         builtPos;
+
+    /// BasicChunkMeshGeometry::originSkelPos when built
+    Vector3l        builtOrigin;
+};
+
+struct ACtxTerrainCollidersJolt
+{
+    osp::KeyedVec<planeta::ChunkId, TerrainColliderJolt> chunkColliders;
+
+    /// originSkelPos that collider positions were last set relative to
+    Vector3l        appliedOrigin;
+
+    /// Build colliders for chunks within this distance of a dynamic body
+    float           nearDistance        {64.0f};
+
+    /// Colliders are removed once all dynamic bodies are further than nearDistance * farMultiplier.
+    /// Prevents rebuilding colliders over and over for a body moving along the edge of the range.
+    float           farMultiplier       {2.0f};
+
+    /// Max number of colliders built per update. Creating a mesh shape builds a BVH; building
+    /// many at once stalls the frame.
+    std::uint32_t   maxBuildsPerUpdate  {4};
+
+    // Temporaries
+    std::vector< std::pair<float, planeta::ChunkId> >       toBuild;
+    osp::KeyedVec<planeta::ChunkId, float>                  nearestBody;
+    std::vector< std::pair<planeta::SkTriId, int> >         triStack;
+    std::unordered_map<planeta::VertexIdx, std::uint32_t>   vrtxRemap;
+};
+
+static void terrain_collider_remove(ACtxJoltWorld &rJolt, TerrainColliderJolt &rCollider)
+{
+    BodyInterface &bodyInterface = rJolt.m_pPhysicsSystem->GetBodyInterface();
+    JPH::BodyID const joltBodyId = BToJolt(rCollider.body);
+
+    bodyInterface.RemoveBody(joltBodyId);
+    bodyInterface.DestroyBody(joltBodyId);
+    rJolt.m_bodyIds.remove(rCollider.body);
+
+    rCollider = {};
+}
+
+/**
+ * @brief Create a static mesh body from a chunk's faces
+ *
+ * Vertices are made relative to the chunk's first corner, which becomes the body's position.
+ * This keeps float precision for chunks far from the scene origin.
+ */
+static void terrain_collider_build(
+        planeta::ChunkId                const chunkId,
+        planeta::ACtxTerrain            const &rTerrain,
+        ACtxJoltWorld                         &rJolt,
+        ACtxTerrainCollidersJolt              &rColliders)
+{
+    using namespace planeta;
+
+    ChunkMeshBufferInfo     const &rChInfo  = rTerrain.chunkInfo;
+    BasicChunkMeshGeometry  const &rChGeo   = rTerrain.chunkGeom;
+
+    auto    const vbufPos   = rChGeo.vbufPositions.view_const(rChGeo.vrtxBuffer, rChInfo.vrtxTotal);
+    auto    const faces     = as_2d(arrayView(rChGeo.indxBuffer), rChInfo.chunkMaxFaceCount).row(chunkId.value);
+    Vector3 const bodyPos   = vbufPos[rChInfo.vbufSharedOffset + rTerrain.skChunks.shared_vertices_used(chunkId)[0].value().value];
+
+    VertexList          vertices;
+    IndexedTriangleList triangles;
+    triangles.reserve(faces.size());
+    rColliders.vrtxRemap.clear();
+
+    auto const local_vrtx = [&vertices, &rColliders, &vbufPos, bodyPos] (VertexIdx const vertex) -> uint32
+    {
+        auto const [it, isNew] = rColliders.vrtxRemap.try_emplace(vertex, uint32(vertices.size()));
+        if (isNew)
+        {
+            Vector3 const pos = vbufPos[vertex] - bodyPos;
+            vertices.push_back(Float3{pos.x(), pos.y(), pos.z()});
+        }
+        return it->second;
+    };
+
+    for (Vector3u const& face : faces)
+    {
+        if (face[0] == face[1])
+        {
+            continue; // Unused faces are filled with zeros
+        }
+        triangles.push_back(IndexedTriangle{local_vrtx(face[0]), local_vrtx(face[1]), local_vrtx(face[2])});
+    }
+
+    if (triangles.empty())
+    {
+        return;
+    }
+
+    MeshShapeSettings                const settings{std::move(vertices), std::move(triangles)};
+    ShapeSettings::ShapeResult       const result = settings.Create();
+    if (result.HasError())
+    {
+        OSP_LOG_WARN("Failed to create terrain chunk collider: {}", result.GetError().c_str());
+        return;
+    }
+
+    BodyId const bodyId = rJolt.m_bodyIds.create();
+    SysJolt::resize_body_data(rJolt);
+
+    BodyCreationSettings const bodyCreation(result.Get(),
+                                            Vec3MagnumToJolt(bodyPos),
+                                            Quat::sIdentity(),
+                                            EMotionType::Static,
+                                            Layers::NON_MOVING);
+
+    BodyInterface &bodyInterface = rJolt.m_pPhysicsSystem->GetBodyInterface();
+    JPH::BodyID const joltBodyId = BToJolt(bodyId);
+    bodyInterface.CreateBodyWithID(joltBodyId, bodyCreation);
+    bodyInterface.AddBody(joltBodyId, EActivation::DontActivate);
+
+    rColliders.chunkColliders[chunkId] = {
+        .body           = bodyId,
+        .builtPos       = bodyPos,
+        .builtOrigin    = rChGeo.originSkelPos
+    };
+}
+
+FeatureDef const ftrTerrainCollidersJolt = feature_def("TerrainCollidersJolt", [] (
+        FeatureBuilder                      &rFB,
+        Implement<FITerrainCollidersJolt>   terrainColJolt,
+        DependOn<FIScene>                   scn,
+        DependOn<FITerrain>                 terrain,
+        DependOn<FITerrainIco>              terrainIco,
+        DependOn<FIJolt>                    jolt)
+{
+    rFB.data_emplace< ACtxTerrainCollidersJolt >(terrainColJolt.di.terrainColliders);
+
+    rFB.task()
+        .name       ("Add and remove Jolt colliders of terrain chunks near dynamic bodies")
+        .run_on     ({scn.pl.update(Run)})
+        .sync_with  ({terrain.pl.terrainFrame(Ready), terrain.pl.chunkMesh(Ready), jolt.pl.joltBody(New)})
+        .args       ({                           terrain.di.terrainFrame,                     terrain.di.terrain,                     terrainIco.di.terrainIco,         jolt.di.jolt,          terrainColJolt.di.terrainColliders })
+        .func       ([] (planeta::ACtxTerrainFrame const &rTerrainFrame, planeta::ACtxTerrain const &rTerrain, planeta::ACtxTerrainIco const &rTerrainIco, ACtxJoltWorld &rJolt, ACtxTerrainCollidersJolt &rColliders) noexcept
+    {
+        using namespace planeta;
+
+        if ( ! rTerrainFrame.active )
+        {
+            return; // Chunk scratchpad isn't updated, its added/removed sets are stale
+        }
+
+        ChunkSkeleton           const &rSkCh    = rTerrain.skChunks;
+        ChunkMeshBufferInfo     const &rChInfo  = rTerrain.chunkInfo;
+        BasicChunkMeshGeometry  const &rChGeo   = rTerrain.chunkGeom;
+        auto                          &rChunkColliders = rColliders.chunkColliders;
+
+        rChunkColliders.resize(rSkCh.m_chunkIds.capacity());
+
+        auto const remove_if_exists = [&rJolt, &rChunkColliders] (ChunkId const chunkId)
+        {
+            if (rChunkColliders[chunkId].body.has_value())
+            {
+                terrain_collider_remove(rJolt, rChunkColliders[chunkId]);
+            }
+        };
+
+        // Colliders of removed chunks, and chunks whose faces changed (restitched or reused) are
+        // stale. They are rebuilt below if still near a body.
+        for (ChunkId const chunkId : rTerrain.chunkSP.chunksRemoved)
+        {
+            remove_if_exists(chunkId);
+        }
+        for (DirtyRanges::Range const& range : rChGeo.dirtyFaces.ranges())
+        {
+            std::uint32_t const first = range.first       / rChInfo.chunkMaxFaceCount;
+            std::uint32_t const last  = (range.last - 1)  / rChInfo.chunkMaxFaceCount;
+            for (std::uint32_t chunkInt = first; chunkInt <= last; ++chunkInt)
+            {
+                remove_if_exists(ChunkId(chunkInt));
+            }
+        }
+
+        BodyInterface &bodyInterface = rJolt.m_pPhysicsSystem->GetBodyInterface();
+
+        float const scale = std::exp2(float(-rTerrain.skData.precision));
+
+        // Follow the chunk mesh's floating origin. Colliders are placed relative to the origin
+        // they were built with.
+        if (rColliders.appliedOrigin != rChGeo.originSkelPos)
+        {
+            rColliders.appliedOrigin = rChGeo.originSkelPos;
+            for (TerrainColliderJolt const& collider : rChunkColliders)
+            {
+                if (collider.body.has_value())
+                {
+                    Vector3 const pos = collider.builtPos + Vector3(collider.builtOrigin - rChGeo.originSkelPos) * scale;
+                    bodyInterface.SetPosition(BToJolt(collider.body), Vec3MagnumToJolt(pos), EActivation::DontActivate);
+                }
+            }
+        }
+
+        float const farDistance = rColliders.nearDistance * rColliders.farMultiplier;
+
+        // Distance from each chunk's bounding sphere to the nearest dynamic body. Each body walks
+        // down the skeleton from the icosahedron's root triangles, skipping triangles further than
+        // farDistance. Sleeping bodies are included, so resting bodies keep the ground below them.
+        // Bodies are only read from outside of the physics update, so per-body locks are skipped.
+        SubdivTriangleSkeleton  const &rSkel                = rTerrain.skeleton;
+        SkeletonVertexData      const &rSkData              = rTerrain.skData;
+        JPH::BodyLockInterfaceNoLock const &bodyLockNoLock  = rJolt.m_pPhysicsSystem->GetBodyLockInterfaceNoLock();
+
+        rColliders.nearestBody.resize(rSkCh.m_chunkIds.capacity());
+        std::fill(rColliders.nearestBody.begin(), rColliders.nearestBody.end(), std::numeric_limits<float>::max());
+
+        for (BodyId const bodyId : rJolt.m_bodyIds)
+        {
+            JPH::Body const *pBody = bodyLockNoLock.TryGetBody(BToJolt(bodyId));
+            if (pBody == nullptr || ! pBody->IsDynamic() || ! pBody->IsInBroadPhase())
+            {
+                continue; // Not created or not added yet, or static (including terrain colliders)
+            }
+
+            Vector3  const bodyPos   = Vec3JoltToMagnum(pBody->GetCenterOfMassPosition());
+            Vector3l const bodySkPos = rChGeo.originSkelPos + Vector3l{Vector3d{bodyPos} / double(scale)};
+
+            rColliders.triStack.clear();
+            for (SkTriId const sktriId : rTerrainIco.icoTri)
+            {
+                rColliders.triStack.emplace_back(sktriId, 0);
+            }
+
+            while ( ! rColliders.triStack.empty() )
+            {
+                auto const [sktriId, level] = rColliders.triStack.back();
+                rColliders.triStack.pop_back();
+
+                // Good-enough bounding sphere is ~75% of the edge length, see subdivision thresholds
+                double const triRadius = 0.75 * gc_icoMaxEdgeVsLevel[level] * rTerrainIco.radius
+                                       + rTerrainIco.height;
+                double const distance  = (Vector3d{bodySkPos - rSkData.centers[sktriId]} * double(scale)).length()
+                                       - triRadius;
+                if (distance > double(farDistance))
+                {
+                    continue;
+                }
+
+                if (ChunkId const chunkId = rSkCh.m_triToChunk[sktriId]; chunkId.has_value())
+                {
+                    rColliders.nearestBody[chunkId] = std::min(rColliders.nearestBody[chunkId], float(distance));
+                }
+
+                if (rSkel.is_tri_subdivided(sktriId))
+                {
+                    SkTriGroupId const children = rSkel.tri_at(sktriId).children;
+                    for (std::uint8_t sibling = 0; sibling < 4; ++sibling)
+                    {
+                        rColliders.triStack.emplace_back(tri_id(children, sibling), level + 1);
+                    }
+                }
+            }
+        }
+
+        rColliders.toBuild.clear();
+        for (ChunkId const chunkId : rSkCh.m_chunkIds)
+        {
+            bool  const hasCollider = rChunkColliders[chunkId].body.has_value();
+            float const distance    = rColliders.nearestBody[chunkId];
+
+            if (hasCollider && distance > farDistance)
+            {
+                terrain_collider_remove(rJolt, rChunkColliders[chunkId]);
+            }
+            else if ( ! hasCollider && distance < rColliders.nearDistance)
+            {
+                rColliders.toBuild.emplace_back(distance, chunkId);
+            }
+        }
+
+        // Nearest chunks first, remaining ones are built in later updates
+        auto const buildCount = std::min<std::size_t>(rColliders.toBuild.size(), rColliders.maxBuildsPerUpdate);
+        std::partial_sort(rColliders.toBuild.begin(),
+                          rColliders.toBuild.begin() + std::ptrdiff_t(buildCount),
+                          rColliders.toBuild.end(),
+                          [] (auto const& lhs, auto const& rhs) noexcept { return lhs.first < rhs.first; });
+
+        for (std::size_t i = 0; i < buildCount; ++i)
+        {
+            terrain_collider_build(rColliders.toBuild[i].second, rTerrain, rJolt, rColliders);
+        }
+    });
+}); // ftrTerrainCollidersJolt
+
+
 } // namespace adera
@@ -47,6 +47,9 @@ struct ACtxConstAccel
 
 /**
  * @brief Jolt physics integration
+ *
+ * Optionally takes an ospjolt::JoltLayerConfig as setup data to configure collision layers and
+ * broadphase trees. Defaults to ospjolt::JoltLayerConfig::make_default.
  */
 extern osp::fw::FeatureDef const ftrJolt;
 
@@ -85,5 +88,13 @@ extern osp::fw::FeatureDef const ftrVehicleSpawnJolt;
  */
 extern osp::fw::FeatureDef const ftrRocketThrustJolt;
 
+/**
+ * @brief Static Jolt mesh colliders for terrain chunks near dynamic bodies
+ *
+ * Colliders are built from the chunk mesh a few at a time, nearest first, and are removed when
+ * their chunk is removed, restitched, or when no dynamic bodies are nearby.
+ */
+extern osp::fw::FeatureDef const ftrTerrainCollidersJolt;
+
 } // namespace adera
 
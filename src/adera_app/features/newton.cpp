@@ -39,6 +39,8 @@
 
 #include <ospnewton/activescene/newtoninteg_fn.h>
 
+#include <utility>
+
 using namespace osp;
 using namespace osp::active;
 using namespace osp::link;
@@ -92,10 +94,13 @@ Session setup_newton(
         .run_on     ({scn.pl.update(Run)})
         .sync_with  ({tgNwt.nwtBody(Prev), comScn.pl.hierarchy(Prev), phys.pl.physBody(Prev), phys.pl.physUpdate(Run), comScn.pl.transform(Prev)})
         .push_to    (out.m_tasks)
-        .args({             comScn.di.basic,             phys.di.phys,              idNwt,           scn.di.deltaTimeIn })
-        .func([] (ACtxBasic& rBasic, ACtxPhysics& rPhys, ACtxNwtWorld& rNwt, float const deltaTimeIn, WorkerContext ctx) noexcept
+        .args({             comScn.di.basic,             phys.di.phys,              idNwt,                  phys.di.stepper,                phys.di.interp })
+        .func([] (ACtxBasic& rBasic, ACtxPhysics& rPhys, ACtxNwtWorld& rNwt, ACtxPhysStepper const& rStepper, ACtxPhysInterp& rInterp, WorkerContext ctx) noexcept
     {
-        SysNewton::update_world(rPhys, rNwt, deltaTimeIn, rBasic.m_scnGraph, rBasic.m_transform);
+        SysNewton::update_translate(rPhys, rNwt, rBasic.m_transform, rBasic.m_scnGraph.m_transformDirty);
+        SysNewton::update_world(rPhys, rNwt, rStepper.fixedStep, rStepper.substeps,
+                                rBasic.m_scnGraph, rBasic.m_transform, rBasic.m_scnGraph.m_transformDirty,
+                                rInterp.enabled ? &rInterp : nullptr);
     });
 
     rFB.data_emplace< ACtxNwtWorld >(idNwt, 2);
@@ -199,18 +204,23 @@ Session setup_phys_shapes_newton(
         .args({                   comScn.di.basic,                physShapes.di.physShapes,             phys.di.phys,              idNwt,              idNwtFactors })
         .func([] (ACtxBasic const &rBasic, ACtxPhysShapes& rPhysShapes, ACtxPhysics& rPhys, ACtxNwtWorld& rNwt, ForceFactors_t nwtFactors) noexcept
     {
-        for (std::size_t i = 0; i < rPhysShapes.m_spawnRequest.size(); ++i)
+        std::size_t const numBodies = rPhysShapes.m_spawnRequest.size();
+
+        // Create all IDs first so body data only needs to be resized once per batch
+        std::vector<BodyId> addedBodies(numBodies);
+        rNwt.m_bodyIds.create(addedBodies.begin(), addedBodies.end());
+        SysNewton::resize_body_data(rNwt);
+
+        for (std::size_t i = 0; i < numBodies; ++i)
         {
             SpawnShape const &spawn = rPhysShapes.m_spawnRequest[i];
             ActiveEnt const root    = rPhysShapes.m_ents[i * 2];
-            ActiveEnt const child   = rPhysShapes.m_ents[i * 2 + 1];
-
-            NwtColliderPtr_t pCollision{ SysNewton::create_primative(rNwt, spawn.m_shape) };
-            SysNewton::orient_collision(pCollision.get(), spawn.m_shape, {0.0f, 0.0f, 0.0f}, Matrix3{}, spawn.m_size);
-            NewtonBody *pBody = NewtonCreateDynamicBody(rNwt.m_world.get(), pCollision.get(), Matrix4{}.data());
+            BodyId const bodyId     = addedBodies[i];
 
-            BodyId const bodyId = rNwt.m_bodyIds.create();
-            SysNewton::resize_body_data(rNwt);
+            // Spawns of the same shape and size share one collision. Creating the body at its
+            // final position avoids moving it in the broadphase right after adding it.
+            NewtonCollision const *pCollision = SysNewton::get_primitive(rNwt, spawn.m_shape, spawn.m_size);
+            NewtonBody *pBody = NewtonCreateDynamicBody(rNwt.m_world.get(), pCollision, Matrix4::translation(spawn.m_position).data());
 
             rNwt.m_bodyPtrs[bodyId].reset(pBody);
 
@@ -221,7 +231,6 @@ Session setup_phys_shapes_newton(
             Vector3 const inertia = collider_inertia_tensor(spawn.m_shape, spawn.m_size, spawn.m_mass);
 
             NewtonBodySetMassMatrix(pBody, spawn.m_mass, inertia.x(), inertia.y(), inertia.z());
-            NewtonBodySetMatrix(pBody, Matrix4::translation(spawn.m_position).data());
             NewtonBodySetLinearDamping(pBody, 0.0f);
             NewtonBodySetForceAndTorqueCallback(pBody, &SysNewton::cb_force_torque);
             NewtonBodySetTransformCallback(pBody, &SysNewton::cb_set_transform);
@@ -236,53 +245,6 @@ Session setup_phys_shapes_newton(
 
 
 
-void compound_collect_recurse(
-        ACtxPhysics const&  rCtxPhys,
-        ACtxNwtWorld&       rCtxWorld,
-        ACtxBasic const&    rBasic,
-        ActiveEnt           ent,
-        Matrix4 const&      transform,
-        NewtonCollision*    pCompound)
-{
-    EShape const shape = rCtxPhys.m_shape[ent];
-
-    if (shape != EShape::None)
-    {
-        NwtColliderPtr_t &rPtr = rCtxWorld.m_colliders.contains(ent)
-                               ? rCtxWorld.m_colliders.get(ent)
-                               : rCtxWorld.m_colliders.emplace(ent);
-
-        if (rPtr.get() == nullptr)
-        {
-            rPtr = SysNewton::create_primative(rCtxWorld, shape);
-        }
-
-        SysNewton::orient_collision(rPtr.get(), shape, transform.translation(), transform.rotation(), transform.scaling());
-        NewtonCompoundCollisionAddSubCollision(pCompound, rPtr.get());
-    }
-
-    if ( ! rCtxPhys.m_hasColliders.contains(ent) )
-    {
-        return;
-    }
-
-    // Recurse into children if there are more colliders
-    for (ActiveEnt child : SysSceneGraph::children(rBasic.m_scnGraph, ent))
-    {
-        if (rBasic.m_transform.contains(child))
-        {
-            ACompTransform const &rChildTransform = rBasic.m_transform.get(child);
-
-            Matrix4 const childMatrix = transform * rChildTransform.m_transform;
-
-            compound_collect_recurse(
-                    rCtxPhys, rCtxWorld, rBasic, child, childMatrix, pCompound);
-        }
-    }
-}
-
-
-
 Session setup_vehicle_spawn_newton(
         TopTaskBuilder&             rFB,
         ArrayView<entt::any> const  topData,
@@ -409,6 +371,8 @@ Session setup_vehicle_spawn_newton(
         auto const& itWeldOffsetsLast   = std::end(rVehicleSpawn.spawnedWeldOffsets);
         auto itWeldOffsets              = std::begin(rVehicleSpawn.spawnedWeldOffsets);
 
+        std::vector<CompoundLeaf> leaves;
+
         for (ACtxVehicleSpawn::TmpToInit const& toInit : rVehicleSpawn.spawnRequest)
         {
             auto const itWeldOffsetsNext = std::next(itWeldOffsets);
@@ -418,21 +382,22 @@ Session setup_vehicle_spawn_newton(
 
             std::for_each(itWeldsFirst + std::ptrdiff_t{*itWeldOffsets},
                           itWeldsFirst + std::ptrdiff_t{weldOffsetNext},
-                          [&rBasic, &rScnParts, &rVehicleSpawn, &toInit, &rPhys, &rNwt] (WeldId const weld)
+                          [&rBasic, &rScnParts, &rVehicleSpawn, &toInit, &rPhys, &rNwt, &leaves] (WeldId const weld)
             {
                 ActiveEnt const weldEnt = rScnParts.weldToActive[weld];
 
                 auto const transform = Matrix4::from(toInit.rotation.toMatrix(), toInit.position);
-                NwtColliderPtr_t pCompound{ NewtonCreateCompoundCollision(rNwt.m_world.get(), 0) };
 
                 rPhys.m_hasColliders.insert(weldEnt);
 
-                // Collect all colliders from hierarchy.
-                NewtonCompoundCollisionBeginAddRemove(pCompound.get());
-                compound_collect_recurse( rPhys, rNwt, rBasic, weldEnt, Matrix4{}, pCompound.get() );
-                NewtonCompoundCollisionEndAddRemove(pCompound.get());
+                // Collect all colliders from hierarchy. Welds with identical colliders, such as
+                // copies of the same vehicle, share a single compound collision.
+                leaves.clear();
+                SysPhysics::collect_compound_leaves(rPhys, rBasic.m_scnGraph, rBasic.m_transform, weldEnt, Matrix4{}, leaves);
+
+                NewtonCollision const *pCompound = SysNewton::get_compound(rNwt, arrayView(std::as_const(leaves)));
 
-                NewtonBody *pBody = NewtonCreateDynamicBody(rNwt.m_world.get(), pCompound.get(), Matrix4{}.data());
+                NewtonBody *pBody = NewtonCreateDynamicBody(rNwt.m_world.get(), pCompound, transform.data());
 
                 BodyId const bodyId = rNwt.m_bodyIds.create();
                 SysNewton::resize_body_data(rNwt);
@@ -56,16 +56,44 @@ FeatureDef const ftrPhysics = feature_def("Physics", [] (
     rFB.pipeline(phys.pl.physBody)  .parent(scn.pl.update);
     rFB.pipeline(phys.pl.physUpdate).parent(scn.pl.update);
 
-    rFB.data_emplace< ACtxPhysics >  (phys.di.phys);
+    rFB.data_emplace< ACtxPhysics >     (phys.di.phys);
+    rFB.data_emplace< ACtxPhysStepper > (phys.di.stepper);
+    rFB.data_emplace< ACtxPhysInterp >  (phys.di.interp);
 
     rFB.task()
         .name       ("Delete Physics components")
         .run_on     ({comScn.pl.activeEntDelete(UseOrRun)})
         .sync_with  ({phys.pl.physBody(Delete)})
-        .args       ({         phys.di.phys,              comScn.di.activeEntDel })
-        .func       ([] (ACtxPhysics &rPhys, ActiveEntVec_t const &rActiveEntDel) noexcept
+        .args       ({         phys.di.phys,                 phys.di.interp,              comScn.di.activeEntDel })
+        .func       ([] (ACtxPhysics &rPhys, ACtxPhysInterp &rInterp, ActiveEntVec_t const &rActiveEntDel) noexcept
     {
-        SysPhysics::update_delete_phys(rPhys, rActiveEntDel.cbegin(), rActiveEntDel.cend());
+        SysPhysics::update_delete_phys  (rPhys,   rActiveEntDel.cbegin(), rActiveEntDel.cend());
+        SysPhysics::update_delete_interp(rInterp, rActiveEntDel.cbegin(), rActiveEntDel.cend());
+    });
+
+    // Physics engines step ACtxPhysStepper::substeps times at fixedStep, which may be zero times
+    // on fast frames
+    rFB.task()
+        .name       ("Accumulate physics time")
+        .run_on     ({scn.pl.update(Run)})
+        .sync_with  ({phys.pl.physUpdate(ModifyOrSignal)})
+        .args       ({             phys.di.stepper,     scn.di.deltaTimeIn })
+        .func       ([] (ACtxPhysStepper &rStepper, float const deltaTimeIn) noexcept
+    {
+        SysPhysics::accumulate(rStepper, deltaTimeIn);
+    });
+
+    rFB.task()
+        .name       ("Interpolate physics transforms")
+        .run_on     ({scn.pl.update(Run)})
+        .sync_with  ({phys.pl.physUpdate(Done), comScn.pl.transform(Prev)})
+        .args       ({      comScn.di.basic,             phys.di.stepper,            phys.di.interp })
+        .func       ([] (ACtxBasic &rBasic, ACtxPhysStepper const &rStepper, ACtxPhysInterp &rInterp) noexcept
+    {
+        if (rInterp.enabled)
+        {
+            SysPhysics::interp_apply(rInterp, rStepper.alpha, rBasic.m_transform, rBasic.m_scnGraph.m_transformDirty);
+        }
     });
 }); // ftrPhysics
 
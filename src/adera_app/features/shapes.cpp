@@ -227,6 +227,7 @@ FeatureDef const ftrPhysicsShapesDraw = feature_def("PhysicsShapesDraw", [] (
         {
             ActiveEnt const child            = rPhysShapes.m_ents[i * 2 + 1];
             rScnRender.m_activeToDraw[child] = rScnRender.m_drawIds.create();
+            rScnRender.m_drawTfChanged.push_back(child);
         }
     });
 
@@ -278,6 +279,7 @@ FeatureDef const ftrPhysicsShapesDraw = feature_def("PhysicsShapesDraw", [] (
             ActiveEnt const child = *children.begin();
 
             rScnRender.m_activeToDraw[child] = rScnRender.m_drawIds.create();
+            rScnRender.m_drawTfChanged.push_back(child);
         }
     });
 
@@ -40,6 +40,9 @@ struct SpawnShape
     osp::Vector3    m_size;
     float           m_mass;
     osp::EShape     m_shape;
+
+    /// Spawn on the debris layer, which collides with terrain and vehicles but not other debris
+    bool            m_debris{false};
 };
 
 struct ACtxPhysShapes
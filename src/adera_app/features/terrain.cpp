@@ -27,6 +27,7 @@
 #include "../feature_interfaces.h"
 
 #include <planet-a/activescene/terrain.h>
+#include <planet-a/chunk_cache.h>
 #include <planet-a/chunk_generate.h>
 #include <planet-a/chunk_utils.h>
 #include <planet-a/icosahedron.h>
@@ -41,6 +42,8 @@
 
 #include <longeron/utility/asserts.hpp>
 
+#include <algorithm>
+
 using namespace adera;
 using namespace ftr_inter::stages;
 using namespace ftr_inter;
@@ -57,6 +60,7 @@ FeatureDef const ftrTerrain = feature_def("Terrain", [] (
         FeatureBuilder              &rFB,
         Implement<FITerrain>        terrain,
         DependOn<FICleanupContext>  cleanup,
+        DependOn<FIMainApp>         mainApp,
         DependOn<FIScene>           scn,
         DependOn<FICommonScene>     comScn)
 {
@@ -72,6 +76,10 @@ FeatureDef const ftrTerrain = feature_def("Terrain", [] (
 
     rTerrain.terrainMesh = rDrawing.m_meshRefCounts.ref_add(rDrawing.m_meshIds.create());
 
+    // Distance tests within a subdivision level can be split across workers. Mostly helps when
+    // many levels are subdivided at once, such as when first approaching the planet.
+    rTerrain.scratchpad.workers = rFB.data_get<osp::WorkerPool>(mainApp.di.workerPool);
+
     rFB.task()
         .name       ("Clear surfaceAdded & surfaceRemoved once we're done with it")
         .run_on     ({terrain.pl.surfaceChanges(Clear)})
@@ -92,6 +100,11 @@ FeatureDef const ftrTerrain = feature_def("Terrain", [] (
         // rTerrain.skeleton can't be obtained during destruction, we must clear it separately.
         rTerrain.skChunks.clear(rTerrain.skeleton);
 
+        if ( ! save_chunk_cache(rTerrain.chunkCache) )
+        {
+            OSP_LOG_WARN("Failed to write terrain chunk cache: {}", rTerrain.chunkCache.path);
+        }
+
         // rTerrain.skeleton will clean itself up in its destructor, since it only holds owners
         // referring to itself.
 
@@ -199,12 +212,15 @@ FeatureDef const ftrTerrainSubdivDist = feature_def("TerrainSubdivDist", [] (
         BasicChunkMeshGeometry     &rChGeo     = rTerrain.chunkGeom;
         ChunkScratchpad            &rChSP      = rTerrain.chunkSP;
         SkeletonSubdivScratchpad   &rSkSP      = rTerrain.scratchpad;
+        ChunkGeometryCache         &rChCache   = rTerrain.chunkCache;
 
         rChSP.chunksAdded       .clear();
         rChSP.chunksRemoved     .clear();
         rChSP.sharedNormalsDirty.clear();
         rChSP.sharedAdded       .clear();
         rChSP.sharedRemoved     .clear();
+        rChGeo.dirtyVrtx        .clear();
+        rChGeo.dirtyFaces       .clear();
 
         // Delete chunks of now-deleted Skeleton Triangles
         for (SkTriId const sktriId : rSkSP.surfaceRemoved)
@@ -279,6 +295,7 @@ FeatureDef const ftrTerrainSubdivDist = feature_def("TerrainSubdivDist", [] (
 
             rChGeo.sharedPosNoHeightmap[sharedVrtxId] = posOut;
             vbufPosView[vbufVertex]                   = posOut + radialDir * heightmap(skPos);
+            rChGeo.dirtyVrtx.add(vbufVertex, 1);
         };
 
         // TODO: Limit rChGeo.originSkelPos to always be near the surface. There isn't a point in
@@ -324,6 +341,7 @@ FeatureDef const ftrTerrainSubdivDist = feature_def("TerrainSubdivDist", [] (
                 {
                     rPos += deltaOffsetF;
                 }
+                rChGeo.dirtyVrtx.add(std::uint32_t(fillOffset), rChInfo.fillVrtxCount);
             }
         }
 
@@ -335,6 +353,25 @@ FeatureDef const ftrTerrainSubdivDist = feature_def("TerrainSubdivDist", [] (
             std::size_t const fillOffset = rChInfo.vbufFillOffset + chunkId.value*rChInfo.fillVrtxCount;
             osp::ArrayView<SharedVrtxOwner_t const> sharedUsed = rSkCh.shared_vertices_used(chunkId);
 
+            auto    const fillPosView = vbufPosView.sliceSize(fillOffset, rChInfo.fillVrtxCount);
+            Vector3 const cornerPos   = rChGeo.sharedPosNoHeightmap[sharedUsed[0]];
+
+            // Cached positions are relative to the first corner, as the mesh origin may differ
+            SkTriPath_t const triPath = rChCache.enabled() ? tri_path(rSkCh.m_chunkToTri[chunkId], rSkel) : 0;
+            if (rChCache.enabled())
+            {
+                ArrayView<Vector3 const> const cached = rChCache.find(triPath);
+                if ( ! cached.isEmpty() )
+                {
+                    for (std::size_t i = 0; i < cached.size(); ++i)
+                    {
+                        fillPosView[i] = cornerPos + cached[i];
+                    }
+                    rChGeo.dirtyVrtx.add(std::uint32_t(fillOffset), rChInfo.fillVrtxCount);
+                    continue;
+                }
+            }
+
             // Use ChunkFillSubdivLUT to generate a spherically curved triangle fill through
             // building up and subdividing pairs of vertices. Don't apply heightmap yet, as this
             // will interfere with middle position and curvature calculations.
@@ -358,7 +395,7 @@ FeatureDef const ftrTerrainSubdivDist = feature_def("TerrainSubdivDist", [] (
             }
 
             // Apply heightmap afterwards
-            for (Vector3 &rPos : vbufPosView.sliceSize(fillOffset, rChInfo.fillVrtxCount))
+            for (Vector3 &rPos : fillPosView)
             {
                 Vector3d   const centerDiff = Vector3d(rPos) - center;
                 double     const centerDist = centerDiff.length();
@@ -368,6 +405,25 @@ FeatureDef const ftrTerrainSubdivDist = feature_def("TerrainSubdivDist", [] (
 
                 rPos += radialDir * heightmap(bigpos);
             }
+            rChGeo.dirtyVrtx.add(std::uint32_t(fillOffset), rChInfo.fillVrtxCount);
+
+            if (rChCache.enabled())
+            {
+                std::vector<Vector3> &rCached = rChCache.added[triPath];
+                rCached.resize(rChInfo.fillVrtxCount);
+                for (std::size_t i = 0; i < rCached.size(); ++i)
+                {
+                    rCached[i] = fillPosView[i] - cornerPos;
+                }
+            }
+        }
+
+        // Write new chunks to disk in batches instead of holding on to all of them until cleanup.
+        // Each batch goes to its own segment file; merging into one file is left to cleanup.
+        if (rChCache.should_flush() && ! flush_chunk_cache(rChCache))
+        {
+            OSP_LOG_WARN("Failed to write terrain chunk cache: {}", rChCache.path);
+            rChCache.added.clear(); // Don't grow forever if the file can't be written
         }
 
         // Normal is not cleaned up by the previous user; Initially set them to zero.
@@ -400,6 +456,9 @@ FeatureDef const ftrTerrainSubdivDist = feature_def("TerrainSubdivDist", [] (
             {
                 auto const indicesView = ibuf2d.row(chunkId.value);
                 std::fill(indicesView.begin(), indicesView.end(), Vector3u{0, 0, 0});
+
+                DirtyRanges::Range const faceRange = chunk_face_range(rChInfo, chunkId);
+                rChGeo.dirtyFaces.add(faceRange.first, faceRange.size());
             }
         }
 
@@ -408,8 +467,15 @@ FeatureDef const ftrTerrainSubdivDist = feature_def("TerrainSubdivDist", [] (
         {
             Vector3 const normalSum = rChGeo.sharedNormalSum[sharedId];
             vbufNrmView[rChInfo.vbufSharedOffset + sharedId.value] = normalSum.normalized();
+            rChGeo.dirtyVrtx.add(rChInfo.vbufSharedOffset + sharedId.value, 1);
         }
 
+        // Merge dirty ranges for consumers of the chunk mesh. Shared vertices are scattered, so
+        // small gaps between them are merged too; copying a few hundred extra bytes is cheaper
+        // than issuing another upload.
+        rChGeo.dirtyVrtx .coalesce(32);
+        rChGeo.dirtyFaces.coalesce();
+
         // Uncomment these if some new change breaks something
         //debug_check_invariants(rChGeo, rChInfo, rSkCh);
 
@@ -575,9 +641,22 @@ void initialize_ico_terrain(
 
     // ## Prepare Chunk scratchpad
 
-    rTerrain.chunkSP.lut = make_chunk_vrtx_subdiv_lut(chunkSubdivLevels);
+    rTerrain.chunkSP.lut         = make_chunk_vrtx_subdiv_lut(chunkSubdivLevels);
+    rTerrain.chunkSP.fillFaceLut = make_chunk_fill_face_lut(chunkSubdivLevels);
     rTerrain.chunkSP.resize(rTerrain.skChunks);
 
+    // ## Open chunk cache
+
+    ChunkGeometryCache &rChCache = rTerrain.chunkCache;
+    rChCache.path           = specs.chunkCachePath;
+    rChCache.planetId       = specs.planetId;
+    rChCache.fillVrtxCount  = rTerrain.chunkInfo.fillVrtxCount;
+    if (rChCache.enabled())
+    {
+        open_chunk_cache(rChCache);
+        OSP_LOG_INFO("Terrain chunk cache '{}': {} chunks loaded", rChCache.path, rChCache.file.record_count());
+    }
+
     OSP_LOG_INFO("Terrain Chunk Properties:\n"
                  "* MaxChunks: {}\n"
                  "* FillVerticesPerChunk: {}\n"
@@ -26,6 +26,8 @@
 
 #include <osp/framework/builder.h>
 
+#include <string>
+
 namespace adera
 {
 
@@ -63,6 +65,12 @@ struct TerrainTestPlanetSpecs
     /// Number of times an initial triangle is subdivided to form a chunk.
     /// Due to bugs (LOL XD): Minimum is 2, Maximum is 8.
     std::uint8_t    chunkSubdivLevels   {};
+
+    /// File to load and save generated chunk geometry from. Empty to disable caching.
+    std::string     chunkCachePath      {};
+
+    /// Identifies this planet in the chunk cache. Change it when any of the above change.
+    std::uint64_t   planetId            {};
 };
 
 
@@ -495,6 +495,7 @@ FeatureDef const ftrVehicleSpawnDraw = feature_def("VehicleSpawnDraw", [] (
         for (ActiveEnt const ent : rVehicleSpawn.rootEnts)
         {
             rScnRender.m_needDrawTf.insert(ent);
+            rScnRender.m_drawTfChanged.push_back(ent);
         }
     });
 
@@ -182,7 +182,15 @@ FeatureDef const ftrMagicRocketThrustIndicator = feature_def("MagicRocketThrustI
             rScnRender.m_color              [drawEnt] = rThrustIndicator.color;
             rScnRender.drawTfObserverEnable [partEnt] = 1;
 
-            SysRender::needs_draw_transforms(rBasic.m_scnGraph, rScnRender.m_needDrawTf, partEnt);
+            if ( ! rScnRender.m_needDrawTf.contains(partEnt) )
+            {
+                SysRender::needs_draw_transforms(rBasic.m_scnGraph, rScnRender.m_needDrawTf, partEnt);
+                rScnRender.m_drawTfChanged.push_back(partEnt);
+            }
+
+            // Indicator is positioned by the draw transform observer, which only runs for
+            // recalculated transforms. Recalculate even if the part didn't move.
+            rBasic.m_scnGraph.m_transformDirty.insert(partEnt);
         }
     });
 
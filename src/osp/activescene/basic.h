@@ -66,6 +66,12 @@ struct ACtxSceneGraph
     // descendants is positioned directly after it within the array.
     // Example for tree structure "A(  B(C(D)), E(F(G(H,I)))  )"
     // * Descendant Count array: [A:8, B:2, C:1, D:0, E:4, F:3, G:2, H:0, I:0]
+    //
+    // To avoid shifting the entire tree when adding to or removing from a subtree, runs of unused
+    // positions (gaps) are kept directly after children of the root. Only positions within the
+    // root child's subtree and its gap are shifted. A gap run is stored like a subtree with a null
+    // entity, where its descendant count is the run's length minus one. Descendant count of the
+    // root (position 0) includes gaps, all other descendant counts don't.
     osp::KeyedVec<TreePos_t, ActiveEnt>  m_treeToEnt{{lgrn::id_null<ActiveEnt>()}};
     osp::KeyedVec<TreePos_t, uint32_t>   m_treeDescendants{std::initializer_list<uint32_t>{0}};
 
@@ -74,12 +80,27 @@ struct ACtxSceneGraph
 
     std::vector<TreePos_t>  m_delete;
 
+    /// Entities with an ACompTransform that was added or modified since draw transforms were
+    /// last calculated. Entities added to the tree and subtrees with shifted tree positions are
+    /// marked automatically. Anything else that writes transforms (eg. physics) must mark them.
+    ActiveEntSet_t          m_transformDirty;
+
+    /// Incremented when tree positions of many entities change at once, such as compaction
+    uint32_t                m_version{0};
+
+    /// Total number of unused tree positions
+    uint32_t m_gapCount{0};
+
+    /// Don't bother compacting the tree if there are fewer unused positions than this
+    static constexpr uint32_t smc_minCompactGap = 1024;
+
     void resize(std::size_t ents)
     {
         m_treeToEnt         .reserve(ents);
         m_treeDescendants   .reserve(ents);
         m_entParent         .resize(ents);
         m_entToTreePos      .resize(ents, lgrn::id_null<TreePos_t>());
+        m_transformDirty    .resize(ents);
     }
 };
 
@@ -99,18 +120,7 @@ struct ACtxBasic
 template<typename IT_T>
 void update_delete_basic(ACtxBasic &rCtxBasic, IT_T first, IT_T const& last)
 {
-    while (first != last)
-    {
-        ActiveEnt const ent = *first;
-
-        if (rCtxBasic.m_transform.contains(ent))
-        {
-            rCtxBasic.m_transform           .remove(ent);
-
-        }
-
-        std::advance(first, 1);
-    }
+    rCtxBasic.m_transform.remove(first, last); // checks contains(ent) internally
 }
 
 } // namespace osp::active
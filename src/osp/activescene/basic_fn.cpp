@@ -40,6 +40,7 @@ SubtreeBuilder SubtreeBuilder::add_child(ActiveEnt ent, uint32_t descendantCount
     m_rScnGraph.m_treeDescendants[m_first]  = descendantCount;
     m_rScnGraph.m_entParent[ent]            = m_root;
     m_rScnGraph.m_entToTreePos[ent]         = m_first;
+    m_rScnGraph.m_transformDirty.insert(ent);
 
     TreePos_t const childFirst = m_first + 1;
     TreePos_t const childLast  = childFirst + descendantCount;
@@ -49,56 +50,157 @@ SubtreeBuilder SubtreeBuilder::add_child(ActiveEnt ent, uint32_t descendantCount
     return {m_rScnGraph, ent, childFirst, childLast};
 }
 
-SubtreeBuilder SysSceneGraph::add_descendants(ACtxSceneGraph& rScnGraph, uint32_t descendantCount, ActiveEnt root)
+/**
+ * @return Child of the root that ent is part of the subtree of
+ */
+static ActiveEnt top_level_ancestor(ACtxSceneGraph const& rScnGraph, ActiveEnt ent)
 {
-    TreePos_t const rootPos         = (root == lgrn::id_null<ActiveEnt>())
-                                    ? 0
-                                    : rScnGraph.m_entToTreePos[root];
+    ActiveEnt parent = rScnGraph.m_entParent[ent];
+    while (parent != lgrn::id_null<ActiveEnt>())
+    {
+        ent     = parent;
+        parent  = rScnGraph.m_entParent[ent];
+    }
+    return ent;
+}
 
-    uint32_t rootdescendants        = rScnGraph.m_treeDescendants[rootPos];
+/**
+ * @brief Get length of the gap run starting at pos, merging it with any runs directly after it
+ *
+ * @return Length of gap, or 0 if pos is not the start of a gap run
+ */
+static uint32_t merge_gap_runs(ACtxSceneGraph& rScnGraph, TreePos_t const pos)
+{
+    auto const treeSize = TreePos_t(rScnGraph.m_treeToEnt.size());
 
-    TreePos_t const subFirst        = rootPos + 1 + rootdescendants;
-    TreePos_t const subLast         = subFirst + descendantCount;
+    if (pos >= treeSize || rScnGraph.m_treeToEnt[pos] != lgrn::id_null<ActiveEnt>())
+    {
+        return 0;
+    }
 
-    TreePos_t const treeOldSize     = rScnGraph.m_treeDescendants[0] + 1;
-    TreePos_t const treeNewSize     = treeOldSize + descendantCount;
+    uint32_t length = 1 + rScnGraph.m_treeDescendants[pos];
+    while (pos + length < treeSize && rScnGraph.m_treeToEnt[pos + length] == lgrn::id_null<ActiveEnt>())
+    {
+        length += 1 + rScnGraph.m_treeDescendants[pos + length];
+    }
 
-    rScnGraph.m_treeToEnt.resize(treeNewSize);
-    rScnGraph.m_treeDescendants.resize(treeNewSize);
+    rScnGraph.m_treeDescendants[pos] = length - 1;
+    return length;
+}
 
-    SubtreeBuilder out(rScnGraph, root, subFirst, subLast);
+/**
+ * @brief Mark [pos, pos + length) as a gap run, merging it with any runs directly after it
+ */
+static void make_gap_run(ACtxSceneGraph& rScnGraph, TreePos_t const pos, uint32_t const length)
+{
+    std::fill_n(rScnGraph.m_treeToEnt.begin() + pos,       length, lgrn::id_null<ActiveEnt>());
+    std::fill_n(rScnGraph.m_treeDescendants.begin() + pos, length, 0u);
+    rScnGraph.m_treeDescendants[pos] = length - 1;
+    merge_gap_runs(rScnGraph, pos);
+}
 
-    if (subFirst != treeOldSize)
-    {
-        // Right-shift tree vectors from subFirst and onwards to make
-        // space for the new subtree
+/**
+ * @brief Insert count unused positions at pos, shifting all positions after it to the right
+ *
+ * This is the only O(total entities) part of adding entities, and is amortized by making new gaps
+ * at least as large as the subtree they follow.
+ */
+static void insert_gap(ACtxSceneGraph& rScnGraph, TreePos_t const pos, uint32_t const count)
+{
+    auto const treeOldSize = TreePos_t(rScnGraph.m_treeToEnt.size());
+
+    rScnGraph.m_treeToEnt      .resize(treeOldSize + count, lgrn::id_null<ActiveEnt>());
+    rScnGraph.m_treeDescendants.resize(treeOldSize + count, 0u);
 
-        for (ActiveEnt const ent : arrayView(rScnGraph.m_treeToEnt.data(), rScnGraph.m_treeToEnt.size()).slice(subFirst, treeOldSize))
+    if (pos != treeOldSize)
+    {
+        for (ActiveEnt const ent : arrayView(rScnGraph.m_treeToEnt.data(), treeOldSize).slice(pos, treeOldSize))
         {
-            rScnGraph.m_entToTreePos[ent] += descendantCount;
+            if (ent != lgrn::id_null<ActiveEnt>())
+            {
+                rScnGraph.m_entToTreePos[ent] += count;
+            }
         }
-        std::shift_right(rScnGraph.m_treeToEnt.begin() + subFirst,
-                         rScnGraph.m_treeToEnt.end(),
-                         descendantCount);
-        std::shift_right(rScnGraph.m_treeDescendants.begin() + subFirst,
-                         rScnGraph.m_treeDescendants.end(),
-                         descendantCount);
+        std::shift_right(rScnGraph.m_treeToEnt.begin() + pos,       rScnGraph.m_treeToEnt.end(),       count);
+        std::shift_right(rScnGraph.m_treeDescendants.begin() + pos, rScnGraph.m_treeDescendants.end(), count);
     }
-    // else, subtree was inserted at end. no shifting required.
 
-    // Update descendant counts of this and ancestors
-    ActiveEnt parent = root;
-    bool parentNotNull = true;
-    while (parentNotNull)
+    rScnGraph.m_treeDescendants[0] += count;
+    rScnGraph.m_gapCount           += count;
+    ++rScnGraph.m_version;
+
+    make_gap_run(rScnGraph, pos, count);
+}
+
+SubtreeBuilder SysSceneGraph::add_descendants(ACtxSceneGraph& rScnGraph, uint32_t descendantCount, ActiveEnt root)
+{
+    if (root == lgrn::id_null<ActiveEnt>())
     {
-        parentNotNull = (parent != lgrn::id_null<ActiveEnt>());
-        TreePos_t const parentPos = parentNotNull ? rScnGraph.m_entToTreePos[parent] : 0;
-        rScnGraph.m_treeDescendants[parentPos] += descendantCount;
-        parent = parentNotNull ? rScnGraph.m_entParent[parent] : parent;
+        // Add to the end of the tree as children of the root. No shifting required.
+        TreePos_t const subFirst    = TreePos_t(rScnGraph.m_treeToEnt.size());
+        TreePos_t const subLast     = subFirst + descendantCount;
+
+        rScnGraph.m_treeToEnt      .resize(subLast);
+        rScnGraph.m_treeDescendants.resize(subLast);
+        rScnGraph.m_treeDescendants[0] += descendantCount;
+
+        return {rScnGraph, root, subFirst, subLast};
     }
 
+    // Adding to a subtree only shifts positions within the root's child subtree (top) that it's
+    // part of, moving them into the gap run directly after it. The gap is made larger first if
+    // there isn't enough space.
+
+    TreePos_t const rootPos     = rScnGraph.m_entToTreePos[root];
+    TreePos_t const subFirst    = rootPos + 1 + rScnGraph.m_treeDescendants[rootPos];
+    TreePos_t const subLast     = subFirst + descendantCount;
+
+    ActiveEnt const top         = top_level_ancestor(rScnGraph, root);
+    TreePos_t const topPos      = rScnGraph.m_entToTreePos[top];
+    TreePos_t const topLast     = topPos + 1 + rScnGraph.m_treeDescendants[topPos];
+
+    uint32_t gapLength = merge_gap_runs(rScnGraph, topLast);
+    if (gapLength < descendantCount)
+    {
+        uint32_t const slack = std::max(descendantCount, topLast - topPos);
+        insert_gap(rScnGraph, topLast, descendantCount - gapLength + slack);
+        gapLength = merge_gap_runs(rScnGraph, topLast);
+    }
 
-    return out;
+    if (descendantCount == 0)
+    {
+        return {rScnGraph, root, subFirst, subLast};
+    }
+
+    for (ActiveEnt const ent : arrayView(rScnGraph.m_treeToEnt.data(), rScnGraph.m_treeToEnt.size()).slice(subFirst, topLast))
+    {
+        rScnGraph.m_entToTreePos[ent] += descendantCount;
+    }
+    std::move_backward(rScnGraph.m_treeToEnt.begin() + subFirst,
+                       rScnGraph.m_treeToEnt.begin() + topLast,
+                       rScnGraph.m_treeToEnt.begin() + topLast + descendantCount);
+    std::move_backward(rScnGraph.m_treeDescendants.begin() + subFirst,
+                       rScnGraph.m_treeDescendants.begin() + topLast,
+                       rScnGraph.m_treeDescendants.begin() + topLast + descendantCount);
+
+    if (uint32_t const gapRemaining = gapLength - descendantCount;
+        gapRemaining != 0)
+    {
+        make_gap_run(rScnGraph, topLast + descendantCount, gapRemaining);
+    }
+    rScnGraph.m_gapCount -= descendantCount;
+    rScnGraph.m_transformDirty.insert(top); // Tree positions within it were shifted
+
+    // Update descendant counts of this and ancestors. The root's count includes gaps, and stays
+    // the same.
+    ActiveEnt parent = root;
+    while (parent != lgrn::id_null<ActiveEnt>())
+    {
+        rScnGraph.m_treeDescendants[rScnGraph.m_entToTreePos[parent]] += descendantCount;
+        parent = rScnGraph.m_entParent[parent];
+    }
+
+    return {rScnGraph, root, subFirst, subLast};
 }
 
 ArrayView<ActiveEnt const> SysSceneGraph::descendants(ACtxSceneGraph const& rScnGraph, ActiveEnt root)
@@ -129,84 +231,142 @@ ChildRange_t SysSceneGraph::children(ACtxSceneGraph const& rScnGraph, ActiveEnt
     TreePos_t const childFirst  = parentPos + 1;
     TreePos_t const childLast   = parentPos + 1 + descendants;
 
-    return ChildRange_t{ChildIterator{&rScnGraph, childFirst},
-                        ChildIterator{&rScnGraph, childLast}};
+    return ChildRange_t{ChildIterator{&rScnGraph, childFirst, childLast},
+                        ChildIterator{&rScnGraph, childLast,  childLast}};
 }
 
 void SysSceneGraph::do_delete(ACtxSceneGraph& rScnGraph)
 {
-    // Delete subtrees by carefully shifting elements left
-    // Operation being a single left->right swoop. This should be pretty fast
-    // since this is only a few KB in size, and is done once per update
+    // Nothing is shifted until each top-level subtree's sweep below, so all positions in
+    // m_delete are valid. Sorting them groups deletions by the top-level subtree they're part of,
+    // and places ancestors before their descendants.
+    std::vector<TreePos_t> &rDelete = rScnGraph.m_delete;
+    std::sort(rDelete.begin(), rDelete.end());
 
-    std::sort(rScnGraph.m_delete.begin(), rScnGraph.m_delete.end());
+    auto const clear_removed = [&rScnGraph] (TreePos_t const first, TreePos_t const last)
+    {
+        for (TreePos_t pos = first; pos != last; ++pos)
+        {
+            ActiveEnt const delEnt = rScnGraph.m_treeToEnt[pos];
+            rScnGraph.m_entParent[delEnt]      = lgrn::id_null<ActiveEnt>();
+            rScnGraph.m_entToTreePos[delEnt]   = lgrn::id_null<TreePos_t>();
+        }
+        rScnGraph.m_gapCount += last - first;
+    };
 
-    TreePos_t const treeLast    = 1 + rScnGraph.m_treeDescendants[0];
+    // Move [first, last) left to out
+    auto const shift_kept = [&rScnGraph] (TreePos_t const first, TreePos_t const last, TreePos_t const out)
+    {
+        if (first == out)
+        {
+            return;
+        }
+        for (ActiveEnt const keepEnt : arrayView(rScnGraph.m_treeToEnt.data(), rScnGraph.m_treeToEnt.size()).slice(first, last))
+        {
+            rScnGraph.m_entToTreePos[keepEnt] -= first - out;
+        }
+        std::move(rScnGraph.m_treeToEnt.begin() + first,
+                  rScnGraph.m_treeToEnt.begin() + last,
+                  rScnGraph.m_treeToEnt.begin() + out);
+        std::move(rScnGraph.m_treeDescendants.begin() + first,
+                  rScnGraph.m_treeDescendants.begin() + last,
+                  rScnGraph.m_treeDescendants.begin() + out);
+    };
+
+    auto it = rDelete.begin();
+    while (it != rDelete.end())
+    {
+        ActiveEnt const firstEnt    = rScnGraph.m_treeToEnt[*it];
+        ActiveEnt const top         = top_level_ancestor(rScnGraph, firstEnt);
+        TreePos_t const topPos      = rScnGraph.m_entToTreePos[top];
+        TreePos_t const topLast     = topPos + 1 + rScnGraph.m_treeDescendants[topPos];
+        auto const      groupLast   = std::lower_bound(it, rDelete.end(), topLast);
 
-    auto const& itTreeDescFirst = rScnGraph.m_treeDescendants.begin();
-    auto const& itTreeEntsFirst = rScnGraph.m_treeToEnt.begin();
+        if (firstEnt == top)
+        {
+            // Child of the root, its positions simply become unused. Deletions within it are
+            // already covered.
+            clear_removed(topPos, topLast);
+            make_gap_run(rScnGraph, topPos, topLast - topPos);
+            it = groupLast;
+            continue;
+        }
 
-    auto const& itDelFirst      = rScnGraph.m_delete.begin();
-    auto const& itDelLast       = rScnGraph.m_delete.end();
-    auto        itDel           = itDelFirst;
+        // Remove every deleted subtree within top in one left-shifting sweep, leaving a single
+        // gap at its end
 
-    TreePos_t const untouched = (*itDel);
-    TreePos_t done = untouched;
+        TreePos_t out           = *it;
+        TreePos_t keepFirst     = *it;
+        uint32_t  removedTotal  = 0;
 
-    while (itDel != itDelLast)
-    {
-        auto const itDelNext = std::next(itDel);
-        bool const notLast = (itDelNext != itDelLast);
+        for (; it != groupLast; ++it)
+        {
+            TreePos_t const pos = *it;
+            if (pos < keepFirst)
+            {
+                continue; // Duplicate, or descendant of a subtree already removed
+            }
+
+            shift_kept(keepFirst, pos, out);
+            out += pos - keepFirst;
+
+            // Kept positions before pos are written to, but pos itself is not yet
+            ActiveEnt const ent         = rScnGraph.m_treeToEnt[pos];
+            uint32_t  const removeTotal = 1 + rScnGraph.m_treeDescendants[pos];
+
+            // Ancestors are before pos, and are already shifted if needed
+            for (ActiveEnt ancestor = rScnGraph.m_entParent[ent]; ancestor != lgrn::id_null<ActiveEnt>(); ancestor = rScnGraph.m_entParent[ancestor])
+            {
+                rScnGraph.m_treeDescendants[rScnGraph.m_entToTreePos[ancestor]] -= removeTotal;
+            }
+
+            clear_removed(pos, pos + removeTotal);
+            keepFirst       = pos + removeTotal;
+            removedTotal    += removeTotal;
+        }
 
-        uint32_t const removeTotal = 1 + rScnGraph.m_treeDescendants[*itDel];
+        shift_kept(keepFirst, topLast, out);
 
-        // State of array each iteration:
-        //
-        // [Done] [Prev. shifted] [Delete] [Keep] [Delete Next] ....
-        //        <--------SHIFT-----------|----|
+        make_gap_run(rScnGraph, topLast - removedTotal, removedTotal);
+        rScnGraph.m_transformDirty.insert(top);
+    }
+    rDelete.clear();
 
-        TreePos_t const keepFirst   = (*itDel) + removeTotal;
-        TreePos_t const keepLast    = (notLast) ? (*itDelNext) : (treeLast);
-        assert(keepFirst <= keepLast);
+    // Amortized compaction, once most of the tree is unused
+    if (rScnGraph.m_gapCount > rScnGraph.smc_minCompactGap
+        && rScnGraph.m_gapCount * 2 > rScnGraph.m_treeToEnt.size())
+    {
+        compact(rScnGraph);
+    }
+}
 
-        std::ptrdiff_t const shift  = keepFirst - done;
+void SysSceneGraph::compact(ACtxSceneGraph& rScnGraph)
+{
+    auto const treeSize = TreePos_t(rScnGraph.m_treeToEnt.size());
 
-        // Update descendant count of ancestors
-        ActiveEnt parent = rScnGraph.m_treeToEnt[*itDel];
-        bool parentNotNull = true;
-        while (parentNotNull)
+    // Gap runs are only placed between children of the root, so only whole runs need to be
+    // skipped. Descendant counts of entities don't change.
+    TreePos_t out = 1;
+    TreePos_t pos = 1;
+    while (pos < treeSize)
+    {
+        ActiveEnt const ent = rScnGraph.m_treeToEnt[pos];
+        if (ent == lgrn::id_null<ActiveEnt>())
         {
-            parent = rScnGraph.m_entParent[parent];
-            parentNotNull = (parent != lgrn::id_null<ActiveEnt>());
-            TreePos_t const parentPos = parentNotNull ? rScnGraph.m_entToTreePos[parent] : 0;
-            rScnGraph.m_treeDescendants[parentPos] -= removeTotal;
+            pos += 1 + rScnGraph.m_treeDescendants[pos];
+            continue;
         }
 
-        // Clear values for entities to delete
-        std::for_each(itTreeEntsFirst + (*itDel), itTreeEntsFirst + (*itDel) + removeTotal,
-                      [&rScnGraph] (ActiveEnt const ent)
-        {
-            rScnGraph.m_entParent[ent]      = lgrn::id_null<ActiveEnt>();
-            rScnGraph.m_entToTreePos[ent]   = lgrn::id_null<TreePos_t>();
-        });
-
-        // Update tree positions for elements to shift
-        std::for_each(itTreeEntsFirst + keepFirst, itTreeEntsFirst + keepLast,
-                      [&rScnGraph, shift] (ActiveEnt const ent)
-        {
-            rScnGraph.m_entToTreePos[ent] -= shift;
-        });
-
-        // Shift over tree data
-        std::shift_left(itTreeDescFirst + done, itTreeDescFirst + keepLast, shift);
-        std::shift_left(itTreeEntsFirst + done, itTreeEntsFirst + keepLast, shift);
-
-        done += keepLast - keepFirst;
-        itDel = itDelNext;
+        rScnGraph.m_treeToEnt[out]        = ent;
+        rScnGraph.m_treeDescendants[out]  = rScnGraph.m_treeDescendants[pos];
+        rScnGraph.m_entToTreePos[ent]     = out;
+        ++out;
+        ++pos;
     }
 
-    rScnGraph.m_treeToEnt      .resize(done);
-    rScnGraph.m_treeDescendants.resize(done);
-
-    rScnGraph.m_delete.clear();
+    rScnGraph.m_treeToEnt      .resize(out);
+    rScnGraph.m_treeDescendants.resize(out);
+    rScnGraph.m_treeDescendants[0] = out - 1;
+    rScnGraph.m_gapCount = 0;
+    ++rScnGraph.m_version;
 }
@@ -93,10 +93,13 @@ public:
     using reference         = void;
 
     constexpr ChildIterator() noexcept = default;
-    constexpr ChildIterator(ACtxSceneGraph const* pScnGraph, TreePos_t pos) noexcept
+    ChildIterator(ACtxSceneGraph const* pScnGraph, TreePos_t pos, TreePos_t last) noexcept
      : m_pScnGraph{pScnGraph}
      , m_pos{pos}
-    { }
+     , m_last{last}
+    {
+        skip_gaps();
+    }
     constexpr ChildIterator(ChildIterator const& copy) noexcept = default;
     constexpr ChildIterator(ChildIterator&& move) noexcept = default;
 
@@ -106,6 +109,7 @@ public:
     ChildIterator& operator++() noexcept
     {
         m_pos += 1 + m_pScnGraph->m_treeDescendants[m_pos];
+        skip_gaps();
         return *this;
     }
 
@@ -117,8 +121,18 @@ public:
     }
 
 private:
+    /// Unused tree positions only exist between children of the root, see ACtxSceneGraph
+    void skip_gaps() noexcept
+    {
+        while (m_pos < m_last && m_pScnGraph->m_treeToEnt[m_pos] == lgrn::id_null<ActiveEnt>())
+        {
+            m_pos += 1 + m_pScnGraph->m_treeDescendants[m_pos];
+        }
+    }
+
     ACtxSceneGraph const    * m_pScnGraph   {nullptr};
     TreePos_t               m_pos           {0};
+    TreePos_t               m_last          {0};
 
 }; // class ChildIterator
 
@@ -142,6 +156,8 @@ public:
 
     /**
      * @return Iterable range of an entity's descendants by tree position
+     *
+     * @warning For the root (position 0), this includes unused positions with null entities
      */
     static ArrayView<ActiveEnt const> descendants(ACtxSceneGraph const& rScnGraph, TreePos_t rootPos);
 
@@ -152,11 +168,11 @@ public:
     static ChildRange_t children(ACtxSceneGraph const& rScnGraph, ActiveEnt parent = lgrn::id_null<ActiveEnt>());
 
     /**
-     * @brief Remove multiple entities from a scene graph
+     * @brief Remove multiple entities and their descendants from a scene graph
      *
-     * @warning Do not include entities that are ancestors of any other entity
-     *          in the same range. All given entities should be a root of a
-     *          unique subtree.
+     * Deletions are batched; each affected subtree of the root is shifted once no matter how
+     * many entities are removed from it. Entities that are descendants of (or the same as) other
+     * entities in the range are ignored.
      */
     template<typename ITA_T, typename ITB_T>
     static void cut(ACtxSceneGraph& rScnGraph, ITA_T first, ITB_T const& last);
@@ -167,6 +183,13 @@ public:
     template<typename ITA_T, typename ITB_T>
     static void queue_delete_entities(ACtxSceneGraph& rScnGraph, ActiveEntVec_t &rDelete, ITA_T const& first, ITB_T const& last);
 
+    /**
+     * @brief Remove all unused tree positions, shifting entities to the left
+     *
+     * Called automatically once most of the tree is unused.
+     */
+    static void compact(ACtxSceneGraph& rScnGraph);
+
 private:
 
     static void do_delete(ACtxSceneGraph& rScnGraph);
@@ -198,11 +221,9 @@ void SysSceneGraph::queue_delete_entities(ACtxSceneGraph& rScnGraph, ActiveEntVe
 {
     std::for_each(first, last, [&] (ActiveEnt const ent)
     {
+        ArrayView<ActiveEnt const> const descendants = SysSceneGraph::descendants(rScnGraph, ent);
         rDelete.push_back(ent);
-        for (ActiveEnt const descendent : SysSceneGraph::descendants(rScnGraph, ent))
-        {
-            rDelete.push_back(descendent);
-        }
+        rDelete.insert(rDelete.end(), descendants.begin(), descendants.end());
     });
 
     SysSceneGraph::cut(rScnGraph, first, last);
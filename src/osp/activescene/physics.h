@@ -42,6 +42,17 @@ struct ACompMass
     float   m_mass;
 };
 
+/**
+ * @brief Primitive shape within a compound collider, relative to the compound's origin
+ */
+struct CompoundLeaf
+{
+    Matrix4 transform;
+    EShape  shape;
+
+    bool operator==(CompoundLeaf const&) const = default;
+};
+
 /**
  * @brief Physics components and other data needed to support physics in a scene
  */
@@ -57,5 +68,70 @@ struct ACtxPhysics
 
 }; // struct ACtxPhysics
 
+/**
+ * @brief Fixed timestep accumulator, decoupling the physics step rate from the frame rate
+ *
+ * Frame time is added to the accumulator, then consumed in whole steps of fixedStep. See
+ * SysPhysics::accumulate.
+ */
+struct ACtxPhysStepper
+{
+    /// Physics time step in seconds, must be greater than zero
+    float   fixedStep{1.0f / 60.0f};
+
+    /// Most steps to run in a single frame. Time beyond this is dropped, so a slow frame can't
+    /// cause even more work the next frame (spiral of death).
+    int     maxSubsteps{4};
+
+    /// Time not yet simulated, always less than fixedStep after accumulate
+    float   accumulator{0.0f};
+
+    /// Steps to run this frame, written by accumulate
+    int     substeps{0};
+
+    /// How far rendering is between the last two steps, [0, 1)
+    float   alpha{0.0f};
+};
+
+/**
+ * @brief Pose of a physics body at the two most recent steps it moved
+ */
+struct ACompPhysPose
+{
+    Vector3     prevPos;
+    Vector3     currPos;
+    Quaternion  prevRot;
+    Quaternion  currRot;
+    Vector3     scale{1.0f};
+
+    /// ACtxPhysInterp::step when this was last recorded
+    std::uint32_t step{0};
+
+    /// True if in ACtxPhysInterp::moving
+    bool        moving{false};
+};
+
+/**
+ * @brief Interpolates transforms of physics bodies between fixed steps
+ *
+ * Physics integrations record body poses each step with SysPhysics::interp_record. After
+ * stepping, SysPhysics::interp_apply writes blended poses to the transforms, so motion looks
+ * smooth when the frame rate differs from the physics rate.
+ */
+struct ACtxPhysInterp
+{
+    Storage_t<ActiveEnt, ACompPhysPose> poses;
+
+    /// Entities recorded since they were last written at rest. Only these are interpolated;
+    /// sleeping bodies are not visited.
+    ActiveEntVec_t                      moving;
+
+    /// Incremented every physics step by SysPhysics::interp_begin_step
+    std::uint32_t                       step{0};
+
+    /// If false, physics integrations don't record poses and transforms are written directly
+    bool                                enabled{true};
+};
+
 
 }
@@ -25,6 +25,12 @@
 #include "physics_fn.h"
 #include "basic_fn.h"
 
+#include <longeron/utility/asserts.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
 using namespace osp;
 using namespace osp::active;
 
@@ -94,3 +100,154 @@ void SysPhysics::calculate_subtree_mass_inertia(
         }
     }
 }
+
+void SysPhysics::collect_compound_leaves(
+        ACtxPhysics const&                      rCtxPhys,
+        ACtxSceneGraph const&                   rScnGraph,
+        ACompTransformStorage_t const&          rTf,
+        ActiveEnt                               ent,
+        Matrix4 const&                          transform,
+        std::vector<CompoundLeaf>&              rLeaves)
+{
+    if (EShape const shape = rCtxPhys.m_shape[ent];
+        shape != EShape::None)
+    {
+        rLeaves.push_back({transform, shape});
+    }
+
+    if ( ! rCtxPhys.m_hasColliders.contains(ent) )
+    {
+        return;
+    }
+
+    for (ActiveEnt const child : SysSceneGraph::children(rScnGraph, ent))
+    {
+        if (rTf.contains(child))
+        {
+            collect_compound_leaves(rCtxPhys, rScnGraph, rTf, child, transform * rTf.get(child).m_transform, rLeaves);
+        }
+    }
+}
+
+std::uint64_t SysPhysics::hash_compound(ArrayView<CompoundLeaf const> leaves) noexcept
+{
+    // FNV-1a over the exact bits. Copies of the same prefab give bit-identical transforms, and
+    // near-misses only cost a cache miss.
+    std::uint64_t hash = 14695981039346656037ull;
+    auto const add = [&hash] (std::uint32_t const value) noexcept
+    {
+        hash = (hash ^ value) * 1099511628211ull;
+    };
+
+    for (CompoundLeaf const& leaf : leaves)
+    {
+        add(std::uint32_t(leaf.shape));
+        for (float const value : ArrayView<float const>{leaf.transform.data(), 16})
+        {
+            add(std::bit_cast<std::uint32_t>(value));
+        }
+    }
+
+    return hash;
+}
+
+int SysPhysics::accumulate(ACtxPhysStepper& rStepper, float const deltaTime) noexcept
+{
+    LGRN_ASSERTM(rStepper.fixedStep > 0.0f, "Fixed physics step must be positive");
+
+    // Largest float below 1.0f
+    constexpr float c_alphaMax = 1.0f - std::numeric_limits<float>::epsilon() / 2.0f;
+
+    rStepper.accumulator += deltaTime;
+
+    auto wholeSteps = static_cast<int>(rStepper.accumulator / rStepper.fixedStep);
+    rStepper.accumulator -= float(wholeSteps) * rStepper.fixedStep;
+
+    // Division and subtraction can round either way, keep the remainder in [0, fixedStep)
+    if (rStepper.accumulator >= rStepper.fixedStep)
+    {
+        ++wholeSteps;
+        rStepper.accumulator -= rStepper.fixedStep;
+    }
+    rStepper.accumulator = std::max(rStepper.accumulator, 0.0f);
+
+    // Drop whole steps over the limit, but keep the remainder for smooth interpolation
+    rStepper.substeps   = std::min(wholeSteps, rStepper.maxSubsteps);
+    rStepper.alpha      = std::min(rStepper.accumulator / rStepper.fixedStep, c_alphaMax);
+
+    return rStepper.substeps;
+}
+
+void SysPhysics::interp_record(ACtxPhysInterp& rInterp, ActiveEnt const ent, Matrix4 const& transform)
+{
+    Vector3    const pos = transform.translation();
+    Quaternion const rot = Quaternion::fromMatrix(transform.rotation());
+
+    if ( ! rInterp.poses.contains(ent) )
+    {
+        rInterp.poses.emplace(ent, ACompPhysPose{ .prevPos = pos, .currPos = pos,
+                                                  .prevRot = rot, .currRot = rot,
+                                                  .scale   = transform.scaling() });
+    }
+
+    ACompPhysPose &rPose = rInterp.poses.get(ent);
+
+    rPose.prevPos   = rPose.currPos;
+    rPose.prevRot   = rPose.currRot;
+    rPose.currPos   = pos;
+    rPose.currRot   = rot;
+    rPose.step      = rInterp.step;
+
+    if ( ! rPose.moving )
+    {
+        rPose.moving = true;
+        rInterp.moving.push_back(ent);
+    }
+}
+
+void SysPhysics::interp_apply(
+        ACtxPhysInterp&             rInterp,
+        float const                 alpha,
+        ACompTransformStorage_t&    rTf,
+        ActiveEntSet_t&             rTfDirty)
+{
+    auto const write = [&rTf, &rTfDirty] (ActiveEnt const ent, Vector3 const pos, Quaternion const rot, Vector3 const scale)
+    {
+        rTf.get(ent).m_transform = Matrix4::from(rot.toMatrix(), pos) * Matrix4::scaling(scale);
+        rTfDirty.insert(ent);
+    };
+
+    for (std::size_t i = 0; i < rInterp.moving.size(); )
+    {
+        ActiveEnt const ent   = rInterp.moving[i];
+        ACompPhysPose &rPose  = rInterp.poses.get(ent);
+
+        if (rPose.step == rInterp.step)
+        {
+            write(ent, Magnum::Math::lerp(rPose.prevPos, rPose.currPos, alpha),
+                       Magnum::Math::slerpShortestPath(rPose.prevRot, rPose.currRot, alpha),
+                       rPose.scale);
+            ++i;
+        }
+        else
+        {
+            // Stopped moving (eg. asleep). Settle at the last pose and stop visiting
+            write(ent, rPose.currPos, rPose.currRot, rPose.scale);
+            rPose.prevPos   = rPose.currPos;
+            rPose.prevRot   = rPose.currRot;
+            rPose.moving    = false;
+
+            rInterp.moving[i] = rInterp.moving.back();
+            rInterp.moving.pop_back();
+        }
+    }
+}
+
+void SysPhysics::interp_translate(ACtxPhysInterp& rInterp, Vector3 const translate) noexcept
+{
+    for (auto const [ent, rPose] : rInterp.poses.each())
+    {
+        rPose.prevPos += translate;
+        rPose.currPos += translate;
+    }
+}
@@ -27,6 +27,10 @@
 #include "physics.h"
 #include "basic.h"
 
+#include "../core/array_view.h"
+
+#include <vector>
+
 namespace osp::active
 {
 
@@ -53,9 +57,80 @@ public:
             Matrix3&                                rInertiaTensor,
             Matrix4 const&                          currentTf = {});
 
+    /**
+     * @brief Collect primitive shapes in an entity's subtree, with transforms relative to it
+     *
+     * Only descends into entities in ACtxPhysics::m_hasColliders. Identical subtrees, such as
+     * welds of the same vehicle, give identical leaves in the same order.
+     *
+     * @param transform [in] Transform of ent relative to the compound's origin
+     * @param rLeaves   [out] Leaves are appended to this
+     */
+    static void collect_compound_leaves(
+            ACtxPhysics const&                      rCtxPhys,
+            ACtxSceneGraph const&                   rScnGraph,
+            ACompTransformStorage_t const&          rTf,
+            ActiveEnt                               ent,
+            Matrix4 const&                          transform,
+            std::vector<CompoundLeaf>&              rLeaves);
+
+    /**
+     * @brief Hash shapes and transforms of compound leaves, for caching compound colliders
+     */
+    [[nodiscard]] static std::uint64_t hash_compound(ArrayView<CompoundLeaf const> leaves) noexcept;
+
     template<typename IT_T, typename ITB_T>
     static void update_delete_phys(ACtxPhysics& rCtxPhys, IT_T const& first, ITB_T const& last);
 
+    /**
+     * @brief Add frame time to the accumulator and calculate steps to run this frame
+     *
+     * Writes ACtxPhysStepper::substeps and alpha.
+     *
+     * @return Number of fixed steps to run this frame, at most maxSubsteps
+     */
+    static int accumulate(ACtxPhysStepper& rStepper, float deltaTime) noexcept;
+
+    /**
+     * @brief Call once per physics step, before any interp_record for that step
+     */
+    static void interp_begin_step(ACtxPhysInterp& rInterp) noexcept
+    {
+        ++rInterp.step;
+    }
+
+    /**
+     * @brief Record the pose of a physics body after a step
+     *
+     * The previously recorded pose becomes the previous pose. Entities recorded for the first
+     * time don't interpolate until their next record.
+     */
+    static void interp_record(ACtxPhysInterp& rInterp, ActiveEnt ent, Matrix4 const& transform);
+
+    /**
+     * @brief Write interpolated transforms of moving bodies
+     *
+     * Bodies that were not recorded in the latest step are written at their last pose once, then
+     * no longer visited until recorded again.
+     *
+     * @param alpha     [in] Blend factor between previous and current poses, see ACtxPhysStepper
+     * @param rTf       [ref] Transforms to write
+     * @param rTfDirty  [ref] Marked for entities written
+     */
+    static void interp_apply(
+            ACtxPhysInterp&             rInterp,
+            float                       alpha,
+            ACompTransformStorage_t&    rTf,
+            ActiveEntSet_t&             rTfDirty);
+
+    /**
+     * @brief Shift all recorded poses, used when the scene origin is moved
+     */
+    static void interp_translate(ACtxPhysInterp& rInterp, Vector3 translate) noexcept;
+
+    template<typename IT_T, typename ITB_T>
+    static void update_delete_interp(ACtxPhysInterp& rInterp, IT_T const& first, ITB_T const& last);
+
 };
 
 template<typename IT_T, typename ITB_T>
@@ -64,5 +139,16 @@ void SysPhysics::update_delete_phys(ACtxPhysics& rCtxPhys, IT_T const& first, IT
     rCtxPhys.m_mass.remove(first, last);
 }
 
+template<typename IT_T, typename ITB_T>
+void SysPhysics::update_delete_interp(ACtxPhysInterp& rInterp, IT_T const& first, ITB_T const& last)
+{
+    rInterp.poses.remove(first, last);
+
+    std::erase_if(rInterp.moving, [&rInterp] (ActiveEnt const ent)
+    {
+        return ! rInterp.poses.contains(ent);
+    });
+}
+
 
 }
@@ -0,0 +1,287 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include "bitvector.h"
+
+#include <longeron/utility/enum_traits.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace osp
+{
+
+/**
+ * @brief Set of (strong typedef) enum class IDs stored as a bitset split into fixed-size pages
+ *
+ * Drop-in for lgrn::IdSetStl where IDs are added in bursts. Growing only appends to the page
+ * table; pages already allocated are never reallocated or copied. Pages are allocated on first
+ * insert, so sparse sets (eg. per-material) of a large ID space stay small.
+ *
+ * Unlike lgrn::IdSetStl, insert() grows the set if the ID is out of range, and contains() and
+ * erase() accept out-of-range IDs.
+ */
+template <typename ID_T>
+class PagedIdSet
+{
+    using int_t = lgrn::underlying_int_type_t<ID_T>;
+
+public:
+
+    static constexpr std::size_t smc_intsPerPage  = 64;
+    static constexpr std::size_t smc_bitsPerInt   = 64;
+    static constexpr std::size_t smc_bitsPerPage  = smc_intsPerPage * smc_bitsPerInt;
+
+    using Page_t = std::vector<bitint_t>;
+
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = ID_T;
+        using pointer           = void;
+        using reference         = ID_T;
+
+        Iterator() = default;
+        Iterator(PagedIdSet const* pSet, std::size_t const pos) noexcept
+         : m_pSet{pSet}
+         , m_pos{pos}
+        { }
+
+        [[nodiscard]] ID_T operator*() const noexcept { return ID_T(int_t(m_pos)); }
+
+        Iterator& operator++() noexcept
+        {
+            m_pos = m_pSet->next_set(m_pos + 1);
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator const copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        [[nodiscard]] friend bool operator==(Iterator const& lhs, Iterator const& rhs) noexcept
+        {
+            return lhs.m_pos == rhs.m_pos;
+        }
+
+    private:
+        PagedIdSet const    *m_pSet{nullptr};
+        std::size_t         m_pos{0};
+    };
+
+    /**
+     * @brief Set capacity in number of IDs
+     *
+     * Growing only adds empty page table entries. Shrinking frees pages past the new size.
+     */
+    void resize(std::size_t const size)
+    {
+        std::size_t const pageCount = size / smc_bitsPerPage + (size % smc_bitsPerPage != 0);
+        m_pages.resize(pageCount);
+        m_size = size;
+
+        // Clear bits past size within the last page, so iteration never yields them
+        if (std::size_t const lastBits = size % smc_bitsPerPage;
+            lastBits != 0 && ! m_pages.back().empty())
+        {
+            Page_t &rPage = m_pages.back();
+            std::size_t const lastInt = lastBits / smc_bitsPerInt;
+            if (std::size_t const tailBits = lastBits % smc_bitsPerInt; tailBits != 0)
+            {
+                rPage[lastInt] &= (bitint_t(1) << tailBits) - 1;
+                std::fill(std::next(rPage.begin(), lastInt + 1), rPage.end(), 0);
+            }
+            else
+            {
+                std::fill(std::next(rPage.begin(), lastInt), rPage.end(), 0);
+            }
+        }
+    }
+
+    /**
+     * @return Capacity in number of IDs, same as lgrn::IdSetStl::size()
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    /**
+     * @return Number of IDs in the set
+     */
+    [[nodiscard]] std::size_t count() const noexcept
+    {
+        std::size_t total = 0;
+        for (Page_t const& page : m_pages)
+        {
+            for (bitint_t const bits : page)
+            {
+                total += std::size_t(std::popcount(bits));
+            }
+        }
+        return total;
+    }
+
+    [[nodiscard]] bool contains(ID_T const id) const noexcept
+    {
+        std::size_t const pos = std::size_t(id);
+        if (pos >= m_size)
+        {
+            return false;
+        }
+        Page_t const &page = m_pages[pos / smc_bitsPerPage];
+        return ! page.empty() && bit_test(page, pos);
+    }
+
+    /**
+     * @return true if the ID was newly added
+     */
+    bool insert(ID_T const id)
+    {
+        std::size_t const pos = std::size_t(id);
+        if (pos >= m_size)
+        {
+            resize(pos + 1);
+        }
+        Page_t &rPage = m_pages[pos / smc_bitsPerPage];
+        if (rPage.empty())
+        {
+            rPage.resize(smc_intsPerPage, 0);
+        }
+        bitint_t &rInt = rPage[(pos % smc_bitsPerPage) / smc_bitsPerInt];
+        bitint_t const mask = bitint_t(1) << (pos % smc_bitsPerInt);
+        bool const added = (rInt & mask) == 0;
+        rInt |= mask;
+        return added;
+    }
+
+    template <typename IT_T, typename ITB_T>
+    void insert(IT_T first, ITB_T const& last)
+    {
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    /**
+     * @return true if the ID was removed
+     */
+    bool erase(ID_T const id) noexcept
+    {
+        std::size_t const pos = std::size_t(id);
+        if (pos >= m_size)
+        {
+            return false;
+        }
+        Page_t &rPage = m_pages[pos / smc_bitsPerPage];
+        if (rPage.empty())
+        {
+            return false;
+        }
+        bitint_t &rInt = rPage[(pos % smc_bitsPerPage) / smc_bitsPerInt];
+        bitint_t const mask = bitint_t(1) << (pos % smc_bitsPerInt);
+        bool const removed = (rInt & mask) != 0;
+        rInt &= ~mask;
+        return removed;
+    }
+
+    /**
+     * @brief Remove all IDs, keeping capacity and allocated pages
+     */
+    void clear() noexcept
+    {
+        for (Page_t &rPage : m_pages)
+        {
+            std::fill(rPage.begin(), rPage.end(), 0);
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return next_set(0) == m_size; }
+
+    [[nodiscard]] Iterator begin() const noexcept { return { this, next_set(0) }; }
+    [[nodiscard]] Iterator end()   const noexcept { return { this, m_size }; }
+
+    /**
+     * @return Number of pages with storage allocated
+     */
+    [[nodiscard]] std::size_t pages_allocated() const noexcept
+    {
+        return std::size_t(std::count_if(m_pages.begin(), m_pages.end(),
+                                         [] (Page_t const& page) { return ! page.empty(); }));
+    }
+
+private:
+
+    static bool bit_test(Page_t const& page, std::size_t const pos) noexcept
+    {
+        bitint_t const bits = page[(pos % smc_bitsPerPage) / smc_bitsPerInt];
+        return (bits >> (pos % smc_bitsPerInt)) & 1;
+    }
+
+    /**
+     * @return Position of the first ID in the set at or after pos, or m_size if none
+     */
+    [[nodiscard]] std::size_t next_set(std::size_t pos) const noexcept
+    {
+        while (pos < m_size)
+        {
+            std::size_t const pageIdx = pos / smc_bitsPerPage;
+            Page_t const &page = m_pages[pageIdx];
+            if (page.empty())
+            {
+                pos = (pageIdx + 1) * smc_bitsPerPage;
+                continue;
+            }
+
+            std::size_t intIdx = (pos % smc_bitsPerPage) / smc_bitsPerInt;
+            bitint_t bits = page[intIdx] & (~bitint_t(0) << (pos % smc_bitsPerInt));
+            while (bits == 0 && ++intIdx != smc_intsPerPage)
+            {
+                bits = page[intIdx];
+            }
+
+            if (bits != 0)
+            {
+                return std::min(m_size, pageIdx * smc_bitsPerPage
+                                        + intIdx * smc_bitsPerInt
+                                        + std::size_t(std::countr_zero(bits)));
+            }
+            pos = (pageIdx + 1) * smc_bitsPerPage;
+        }
+        return m_size;
+    }
+
+    std::vector<Page_t> m_pages;
+    std::size_t         m_size{0};
+};
+
+} // namespace osp
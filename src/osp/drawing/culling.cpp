@@ -0,0 +1,332 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "culling.h"
+
+#include <Magnum/Math/Functions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace osp;
+using namespace osp::draw;
+
+namespace
+{
+
+/**
+ * @brief Spread the lower 10 bits of a value out so that there are 2 zero bits between each bit
+ */
+constexpr std::uint32_t morton_spread_3(std::uint32_t x) noexcept
+{
+    x &= 0x3FFu;
+    x = (x | (x << 16u)) & 0x030000FFu;
+    x = (x | (x <<  8u)) & 0x0300F00Fu;
+    x = (x | (x <<  4u)) & 0x030C30C3u;
+    x = (x | (x <<  2u)) & 0x09249249u;
+    return x;
+}
+
+/**
+ * @return Sphere enclosing all spheres in [first, last) of the SoA arrays
+ */
+BoundingSphere enclose_spheres(ACtxCulling const& culling, std::uint32_t const first, std::uint32_t const last) noexcept
+{
+    Vector3 min{std::numeric_limits<float>::max()};
+    Vector3 max{-std::numeric_limits<float>::max()};
+    for (std::uint32_t i = first; i != last; ++i)
+    {
+        Vector3 const pos{culling.posX[i], culling.posY[i], culling.posZ[i]};
+        min = Magnum::Math::min(min, pos - Vector3{culling.radius[i]});
+        max = Magnum::Math::max(max, pos + Vector3{culling.radius[i]});
+    }
+
+    BoundingSphere out{.center = (min + max) * 0.5f, .radius = 0.0f};
+    for (std::uint32_t i = first; i != last; ++i)
+    {
+        Vector3 const pos{culling.posX[i], culling.posY[i], culling.posZ[i]};
+        out.radius = std::max(out.radius, (pos - out.center).length() + culling.radius[i]);
+    }
+    return out;
+}
+
+} // namespace
+
+Frustum osp::draw::frustum_from_view_proj(Matrix4 const& viewProj) noexcept
+{
+    Vector4 const row0 = viewProj.row(0);
+    Vector4 const row1 = viewProj.row(1);
+    Vector4 const row2 = viewProj.row(2);
+    Vector4 const row3 = viewProj.row(3);
+
+    Frustum out{{
+        row3 + row0,  // left
+        row3 - row0,  // right
+        row3 + row1,  // bottom
+        row3 - row1,  // top
+        row3 + row2,  // near
+        row3 - row2   // far
+    }};
+
+    for (Vector4 &rPlane : out.planes)
+    {
+        rPlane /= rPlane.xyz().length();
+    }
+
+    return out;
+}
+
+BoundingSphere osp::draw::bounding_sphere(ArrayView<Vector3 const> positions) noexcept
+{
+    if (positions.isEmpty())
+    {
+        return {};
+    }
+
+    Vector3 min = positions.front();
+    Vector3 max = positions.front();
+    for (Vector3 const& pos : positions)
+    {
+        min = Magnum::Math::min(min, pos);
+        max = Magnum::Math::max(max, pos);
+    }
+
+    BoundingSphere out{.center = (min + max) * 0.5f, .radius = 0.0f};
+    float radiusSqr = 0.0f;
+    for (Vector3 const& pos : positions)
+    {
+        radiusSqr = std::max(radiusSqr, (pos - out.center).dot());
+    }
+    out.radius = std::sqrt(radiusSqr);
+    return out;
+}
+
+void SysCulling::update_bounds(
+        ACtxCulling&                rCulling,
+        ACtxSceneRender const&      scnRender,
+        ACtxDrawing const&          drawing)
+{
+    rCulling.ents       .clear();
+    rCulling.unbounded  .clear();
+    rCulling.sortKeys   .clear();
+    rCulling.unsorted   .clear();
+
+    // Calculate world-space bounding spheres
+
+    for (DrawEnt const drawEnt : scnRender.m_visible)
+    {
+        MeshIdOwner_t const &meshOwner = scnRender.m_mesh[drawEnt];
+        if ( ! meshOwner.has_value() )
+        {
+            rCulling.unbounded.push_back(drawEnt);
+            continue;
+        }
+
+        MeshId const meshId = meshOwner.value();
+        if (std::size_t(meshId) >= drawing.m_meshBounds.size()
+            || std::isinf(drawing.m_meshBounds[meshId].radius))
+        {
+            rCulling.unbounded.push_back(drawEnt);
+            continue;
+        }
+
+        BoundingSphere const &local = drawing.m_meshBounds[meshId];
+        Matrix4        const &tf    = scnRender.m_drawTransform[drawEnt];
+
+        float const scale = std::sqrt(std::max({tf[0].xyz().dot(),
+                                                tf[1].xyz().dot(),
+                                                tf[2].xyz().dot()}));
+
+        rCulling.unsorted.push_back({
+                .ent    = drawEnt,
+                .sphere = {.center = tf.transformPoint(local.center), .radius = local.radius * scale}});
+    }
+
+    auto const count = std::uint32_t(rCulling.unsorted.size());
+
+    // Sort along a Morton curve so that nearby spheres end up in the same cluster
+
+    Vector3 min{std::numeric_limits<float>::max()};
+    Vector3 max{-std::numeric_limits<float>::max()};
+    for (ACtxCulling::EntSphere const& entSphere : rCulling.unsorted)
+    {
+        min = Magnum::Math::min(min, entSphere.sphere.center);
+        max = Magnum::Math::max(max, entSphere.sphere.center);
+    }
+
+    Vector3 const extent = max - min;
+    Vector3 const toGrid = 1023.0f / Magnum::Math::max(extent, Vector3{1e-6f});
+
+    rCulling.sortKeys.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        Vector3 const cell = (rCulling.unsorted[i].sphere.center - min) * toGrid;
+        std::uint32_t const morton = (morton_spread_3(std::uint32_t(cell.x())) << 2u)
+                                   | (morton_spread_3(std::uint32_t(cell.y())) << 1u)
+                                   |  morton_spread_3(std::uint32_t(cell.z()));
+
+        // Morton code in the high 32 bits, index in the low 32 bits
+        rCulling.sortKeys.push_back((std::uint64_t(morton) << 32u) | i);
+    }
+    std::sort(rCulling.sortKeys.begin(), rCulling.sortKeys.end());
+
+    rCulling.ents   .resize(count);
+    rCulling.posX   .resize(count);
+    rCulling.posY   .resize(count);
+    rCulling.posZ   .resize(count);
+    rCulling.radius .resize(count);
+
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        ACtxCulling::EntSphere const &entSphere = rCulling.unsorted[rCulling.sortKeys[i] & 0xFFFFFFFFu];
+
+        rCulling.ents[i]    = entSphere.ent;
+        rCulling.posX[i]    = entSphere.sphere.center.x();
+        rCulling.posY[i]    = entSphere.sphere.center.y();
+        rCulling.posZ[i]    = entSphere.sphere.center.z();
+        rCulling.radius[i]  = entSphere.sphere.radius;
+    }
+
+    // Build clusters
+
+    LGRN_ASSERTM(rCulling.clusterSize != 0, "clusterSize must be non-zero");
+
+    rCulling.clusters.clear();
+    for (std::uint32_t first = 0; first < count; first += rCulling.clusterSize)
+    {
+        std::uint32_t const last = std::min(first + rCulling.clusterSize, count);
+        rCulling.clusters.push_back({
+                .bounds = enclose_spheres(rCulling, first, last),
+                .first  = first,
+                .last   = last});
+    }
+}
+
+void SysCulling::cull(ACtxCulling& rCulling, Frustum const& frustum, std::size_t const drawEntCapacity)
+{
+    rCulling.inView.clear();
+    rCulling.inView.resize(drawEntCapacity);
+    rCulling.stats = {};
+
+    for (DrawEnt const drawEnt : rCulling.unbounded)
+    {
+        rCulling.inView.insert(drawEnt);
+    }
+
+    rCulling.testResults.resize(rCulling.clusterSize);
+
+    for (ACtxCulling::Cluster const& cluster : rCulling.clusters)
+    {
+        bool outside = false;
+        bool inside  = true;
+        for (Vector4 const& plane : frustum.planes)
+        {
+            float const dist = Magnum::Math::dot(plane.xyz(), cluster.bounds.center) + plane.w();
+            if (dist < -cluster.bounds.radius)
+            {
+                outside = true;
+                break;
+            }
+            inside = inside && (dist >= cluster.bounds.radius);
+        }
+
+        if (outside)
+        {
+            ++rCulling.stats.clustersOutside;
+        }
+        else if (inside)
+        {
+            ++rCulling.stats.clustersInside;
+            for (std::uint32_t i = cluster.first; i != cluster.last; ++i)
+            {
+                rCulling.inView.insert(rCulling.ents[i]);
+            }
+        }
+        else
+        {
+            ++rCulling.stats.clustersIntersecting;
+
+            std::size_t const size = cluster.last - cluster.first;
+            ArrayView<std::uint8_t> const results = arrayView(rCulling.testResults).prefix(size);
+
+            test_spheres(frustum,
+                         arrayView(rCulling.posX)  .sliceSize(cluster.first, size),
+                         arrayView(rCulling.posY)  .sliceSize(cluster.first, size),
+                         arrayView(rCulling.posZ)  .sliceSize(cluster.first, size),
+                         arrayView(rCulling.radius).sliceSize(cluster.first, size),
+                         results);
+
+            rCulling.stats.entsTested += std::uint32_t(size);
+
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                if (results[i] != 0)
+                {
+                    rCulling.inView.insert(rCulling.ents[cluster.first + i]);
+                }
+            }
+        }
+    }
+
+    rCulling.stats.entsInView = std::uint32_t(rCulling.inView.count());
+}
+
+void SysCulling::test_spheres(
+        Frustum const&              frustum,
+        ArrayView<float const>      posX,
+        ArrayView<float const>      posY,
+        ArrayView<float const>      posZ,
+        ArrayView<float const>      radius,
+        ArrayView<std::uint8_t>     rInside) noexcept
+{
+    std::size_t const count = rInside.size();
+
+    LGRN_ASSERT(posX.size() == count && posY.size() == count && posZ.size() == count && radius.size() == count);
+
+    float         const *pX   = posX.data();
+    float         const *pY   = posY.data();
+    float         const *pZ   = posZ.data();
+    float         const *pR   = radius.data();
+    std::uint8_t        *pOut = rInside.data();
+
+    std::fill_n(pOut, count, std::uint8_t(1));
+
+    // Planes in the outer loop and branch-free entities in the inner loop, this lets the compiler
+    // vectorize the inner loop.
+    for (Vector4 const& plane : frustum.planes)
+    {
+        float const nx = plane.x();
+        float const ny = plane.y();
+        float const nz = plane.z();
+        float const d  = plane.w();
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            float const dist = nx * pX[i] + ny * pY[i] + nz * pZ[i] + d;
+            pOut[i] &= std::uint8_t(dist >= -pR[i]);
+        }
+    }
+}
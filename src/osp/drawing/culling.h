@@ -0,0 +1,157 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/**
+ * @file
+ * @brief CPU frustum culling of DrawEnts using bounding spheres
+ */
+#pragma once
+
+#include "drawing.h"
+
+#include "../core/array_view.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace osp::draw
+{
+
+/**
+ * @brief View frustum as 6 planes facing inwards
+ *
+ * Each plane is (normal.x, normal.y, normal.z, distance). A point p is on the inner side of a
+ * plane if dot(normal, p) + distance >= 0.
+ */
+struct Frustum
+{
+    std::array<Vector4, 6> planes;
+};
+
+/**
+ * @brief Extract frustum planes from a view-projection matrix (Gribb-Hartmann)
+ *
+ * Planes are in the space that the view-projection matrix transforms from, usually world space.
+ */
+[[nodiscard]] Frustum frustum_from_view_proj(Matrix4 const& viewProj) noexcept;
+
+/**
+ * @return Sphere enclosing all positions, infinite if there are no positions
+ */
+[[nodiscard]] BoundingSphere bounding_sphere(ArrayView<Vector3 const> positions) noexcept;
+
+/**
+ * @brief World-space bounding spheres of DrawEnts, grouped into clusters of nearby entities
+ *
+ * This is a two-level bounding volume hierarchy. Entities are sorted along a Morton (Z-order)
+ * curve, then split into clusters of clusterSize. A cluster that is entirely outside or inside
+ * the frustum doesn't need its entities tested individually.
+ *
+ * Spheres are stored as structure-of-arrays so that the per-entity test vectorizes.
+ */
+struct ACtxCulling
+{
+    struct Cluster
+    {
+        BoundingSphere  bounds;
+        std::uint32_t   first;
+        std::uint32_t   last;
+    };
+
+    // Parallel, ordered by cluster
+    std::vector<DrawEnt>        ents;
+    std::vector<float>          posX;
+    std::vector<float>          posY;
+    std::vector<float>          posZ;
+    std::vector<float>          radius;
+
+    std::vector<Cluster>        clusters;
+
+    /// Entities with unknown bounds that are never culled
+    std::vector<DrawEnt>        unbounded;
+
+    /// Output, entities of ACtxSceneRender::m_visible that are in view
+    DrawEntSet_t                inView;
+
+    std::uint32_t               clusterSize{64};
+
+    struct Stats
+    {
+        std::uint32_t clustersOutside{};
+        std::uint32_t clustersInside{};
+        std::uint32_t clustersIntersecting{};
+        std::uint32_t entsTested{};
+        std::uint32_t entsInView{};
+    };
+
+    /// Statistics from the most recent SysCulling::cull
+    Stats                       stats;
+
+    // Temporaries
+    struct EntSphere
+    {
+        DrawEnt         ent;
+        BoundingSphere  sphere;
+    };
+    std::vector<EntSphere>      unsorted;
+    std::vector<std::uint64_t>  sortKeys;
+    std::vector<std::uint8_t>   testResults;
+};
+
+class SysCulling
+{
+public:
+
+    /**
+     * @brief Calculate world-space bounds of all visible DrawEnts and rebuild clusters
+     *
+     * Bounds are taken from ACtxDrawing::m_meshBounds of each entity's mesh and transformed by
+     * ACtxSceneRender::m_drawTransform. Draw transforms must already be calculated.
+     */
+    static void update_bounds(
+            ACtxCulling&                rCulling,
+            ACtxSceneRender const&      scnRender,
+            ACtxDrawing const&          drawing);
+
+    /**
+     * @brief Write ACtxCulling::inView with entities that touch the frustum
+     */
+    static void cull(ACtxCulling& rCulling, Frustum const& frustum, std::size_t drawEntCapacity);
+
+    /**
+     * @brief Test spheres against a frustum
+     *
+     * @param rInside   [out] Set to 1 if the sphere touches the frustum, 0 otherwise
+     */
+    static void test_spheres(
+            Frustum const&              frustum,
+            ArrayView<float const>      posX,
+            ArrayView<float const>      posY,
+            ArrayView<float const>      posZ,
+            ArrayView<float const>      radius,
+            ArrayView<std::uint8_t>     rInside) noexcept;
+};
+
+} // namespace osp::draw
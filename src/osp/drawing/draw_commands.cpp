@@ -0,0 +1,105 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "draw_commands.h"
+
+#include <algorithm>
+#include <atomic>
+#include <latch>
+#include <optional>
+
+using namespace osp;
+using namespace osp::draw;
+
+void SysDrawCommands::record(DrawCommandBuffer& rBuffer, RenderQueue const& queue, ERenderPass const pass)
+{
+    rBuffer.pass = pass;
+    rBuffer.commands.clear();
+    rBuffer.ents    = queue.ents;
+    rBuffer.shaders = queue.shaders;
+
+    std::optional<std::uint32_t>    boundShader;
+    std::optional<MeshId>           boundMesh;
+    std::optional<TexId>            boundTexture;
+
+    for (RenderQueue::Batch const& batch : queue.batches)
+    {
+        RenderQueue::Entry const &entry = queue.entries[batch.first];
+
+        if (boundShader != entry.shader)
+        {
+            rBuffer.commands.push_back({EDrawCmd::BindShader, entry.shader, 0});
+            boundShader = entry.shader;
+        }
+        if (boundMesh != entry.mesh)
+        {
+            rBuffer.commands.push_back({EDrawCmd::BindMesh, std::uint32_t(entry.mesh), 0});
+            boundMesh = entry.mesh;
+        }
+        if (boundTexture != entry.texture)
+        {
+            rBuffer.commands.push_back({EDrawCmd::BindTexture, std::uint32_t(entry.texture), 0});
+            boundTexture = entry.texture;
+        }
+
+        rBuffer.commands.push_back({EDrawCmd::Draw, batch.first, batch.count});
+    }
+}
+
+void SysDrawCommands::record_parallel(
+        ArrayView<RecordJob const>  const jobs,
+        ACtxSceneRender const&      scnRender,
+        ViewProjMatrix const&       viewProj,
+        WorkerPool&                 rWorkers)
+{
+    std::atomic<std::size_t> nextJob{0};
+
+    // Threads take jobs one at a time, since RenderGroups can be very different in size
+    auto const run_jobs = [&] () noexcept
+    {
+        for (std::size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+        {
+            RecordJob const &job = jobs[i];
+            SysRenderQueue::build(*job.pQueue, *job.pGroup, *job.pVisible, scnRender, viewProj, job.pass);
+            record(*job.pBuffer, *job.pQueue, job.pass);
+        }
+    };
+
+    // The calling thread takes jobs too, so no more than one worker is needed per other job
+    std::size_t const helperCount = (jobs.size() > 1) ? std::min(jobs.size() - 1, rWorkers.thread_count()) : 0;
+
+    std::latch done{std::ptrdiff_t(helperCount)};
+    for (std::size_t i = 0; i < helperCount; ++i)
+    {
+        rWorkers.submit([&run_jobs, &done]
+        {
+            run_jobs();
+            done.count_down();
+        });
+    }
+
+    run_jobs(); // Calling thread takes jobs too
+    done.wait();
+}
@@ -0,0 +1,156 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/**
+ * @file
+ * @brief Backend-agnostic draw command buffers recorded from RenderQueues
+ */
+#pragma once
+
+#include "render_queue.h"
+
+#include "../tasks/worker_pool.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace osp::draw
+{
+
+enum class EDrawCmd : std::uint8_t
+{
+    BindShader,     ///< value: index to DrawCommandBuffer::shaders
+    BindMesh,       ///< value: MeshId
+    BindTexture,    ///< value: TexId
+    Draw            ///< value: first index to DrawCommandBuffer::ents, count: number of ents
+};
+
+struct DrawCommand
+{
+    EDrawCmd        type;
+    std::uint32_t   value;
+    std::uint32_t   count;
+};
+
+/**
+ * @brief Recorded bind and draw commands of a single RenderGroup
+ *
+ * Bind commands are only recorded when the bound shader, mesh, or texture changes. Recording only
+ * reads scene data and writes to the buffer, so buffers of different RenderGroups can be recorded
+ * on different threads. Only submitting needs to happen on the graphics thread.
+ */
+struct DrawCommandBuffer
+{
+    ERenderPass                 pass{ERenderPass::Opaque};
+    std::vector<DrawCommand>    commands;
+    std::vector<DrawEnt>        ents;
+    std::vector<EntityToDraw>   shaders;
+};
+
+/**
+ * @brief Null backend that counts submitted commands, for tests and benchmarks without a GPU
+ */
+struct DrawCommandCounter
+{
+    void bind_shader(EntityToDraw const&) noexcept          { ++shaderBinds; }
+    void bind_mesh(MeshId) noexcept                         { ++meshBinds; }
+    void bind_texture(TexId) noexcept                       { ++textureBinds; }
+    void draw(ArrayView<DrawEnt const> ents) noexcept       { ++draws; entsDrawn += ents.size(); }
+
+    std::size_t shaderBinds {0};
+    std::size_t meshBinds   {0};
+    std::size_t textureBinds{0};
+    std::size_t draws       {0};
+    std::size_t entsDrawn   {0};
+};
+
+class SysDrawCommands
+{
+public:
+
+    /**
+     * @brief Record commands to draw a RenderQueue
+     *
+     * @param rBuffer   [out] Buffer to write, previous contents are discarded
+     * @param queue     [in] Queue built by SysRenderQueue::build
+     * @param pass      [in] Pass the queue was built for
+     */
+    static void record(DrawCommandBuffer& rBuffer, RenderQueue const& queue, ERenderPass pass);
+
+    struct RecordJob
+    {
+        RenderGroup         const   *pGroup;
+        DrawEntSet_t        const   *pVisible;
+        ERenderPass                 pass;
+        RenderQueue                 *pQueue;
+        DrawCommandBuffer           *pBuffer;
+    };
+
+    /**
+     * @brief Build RenderQueues and record DrawCommandBuffers for many RenderGroups in parallel
+     *
+     * Each job is independent and writes only to its own queue and buffer. The calling thread
+     * runs jobs too, and returns once all of them are done. Runs serially if rWorkers is empty.
+     */
+    static void record_parallel(
+            ArrayView<RecordJob const>  jobs,
+            ACtxSceneRender const&      scnRender,
+            ViewProjMatrix const&       viewProj,
+            WorkerPool&                 rWorkers);
+
+    /**
+     * @brief Replay a DrawCommandBuffer into a backend
+     *
+     * BACKEND_T must have bind_shader(EntityToDraw const&), bind_mesh(MeshId),
+     * bind_texture(TexId), and draw(ArrayView<DrawEnt const>) member functions. The draw
+     * function is called with the currently bound shader.
+     */
+    template <typename BACKEND_T>
+    static void submit(DrawCommandBuffer const& buffer, BACKEND_T& rBackend);
+};
+
+template <typename BACKEND_T>
+void SysDrawCommands::submit(DrawCommandBuffer const& buffer, BACKEND_T& rBackend)
+{
+    for (DrawCommand const& cmd : buffer.commands)
+    {
+        switch (cmd.type)
+        {
+        case EDrawCmd::BindShader:
+            rBackend.bind_shader(buffer.shaders[cmd.value]);
+            break;
+        case EDrawCmd::BindMesh:
+            rBackend.bind_mesh(MeshId(cmd.value));
+            break;
+        case EDrawCmd::BindTexture:
+            rBackend.bind_texture(TexId(cmd.value));
+            break;
+        case EDrawCmd::Draw:
+            rBackend.draw(arrayView(buffer.ents).sliceSize(cmd.value, cmd.count));
+            break;
+        }
+    }
+}
+
+} // namespace osp::draw
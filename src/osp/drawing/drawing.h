@@ -30,6 +30,7 @@
 #include "../core/id_map.h"
 #include "../core/keyed_vector.h"
 #include "../core/math_types.h"
+#include "../core/paged_id_set.h"
 #include "../core/resourcetypes.h"
 
 #include "../activescene/active_ent.h"
@@ -42,13 +43,17 @@
 
 #include <longeron/id_management/refcount.hpp>
 #include <longeron/id_management/registry_stl.hpp>
-#include <longeron/id_management/id_set_stl.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
 
 namespace osp::draw
 {
 
 using DrawEntVec_t  = std::vector<DrawEnt>;
-using DrawEntSet_t  = lgrn::IdSetStl<DrawEnt>;
+using DrawEntSet_t  = PagedIdSet<DrawEnt>;
 
 struct Material
 {
@@ -77,6 +82,48 @@ using MeshIdOwner_t     = MeshRefCount_t::Owner_t;
 using TexRefCount_t     = lgrn::IdRefCount<TexId>;
 using TexIdOwner_t      = TexRefCount_t::Owner_t;
 
+/**
+ * @brief Sphere that encloses all vertices of a mesh, in the mesh's local space
+ *
+ * An infinite radius means the bounds are unknown, and the mesh is never culled.
+ */
+struct BoundingSphere
+{
+    Vector3 center  { 0.0f, 0.0f, 0.0f };
+    float   radius  { std::numeric_limits<float>::infinity() };
+};
+
+/**
+ * @brief A mesh to use for a level of detail
+ */
+struct MeshLod
+{
+    MeshId  mesh;
+
+    /// Used while the mesh's bounding sphere is at least this size on screen, as a fraction of
+    /// the screen height. Should be 0.0f for the last level.
+    float   minScreenSize;
+};
+
+/**
+ * @brief Meshes to use as a mesh gets smaller on screen, see SysMeshLod
+ *
+ * levels[0] is the full detail mesh itself, followed by decreasing detail.
+ */
+struct MeshLodGroup
+{
+    std::vector<MeshLod> levels;
+};
+
+/**
+ * @brief Level of detail currently used by a DrawEnt
+ */
+struct DrawEntLod
+{
+    MeshId          base    { lgrn::id_null<MeshId>() }; ///< Full detail mesh, null if no LODs
+    std::uint8_t    level   { 0 };
+};
+
 /**
  * @brief Mesh Ids, texture Ids, and storage for drawing-related components
  */
@@ -85,6 +132,8 @@ struct ACtxDrawing
     // Scene-space Meshes
     lgrn::IdRegistryStl<MeshId>             m_meshIds;
     MeshRefCount_t                          m_meshRefCounts;
+    KeyedVec<MeshId, BoundingSphere>        m_meshBounds;
+    KeyedVec<MeshId, MeshLodGroup>          m_meshLods; ///< Indexed by full detail mesh
 
     // Scene-space Textures
     lgrn::IdRegistryStl<TexId>              m_texIds;
@@ -114,15 +163,65 @@ struct ACtxDrawingRes
 using DrawEntColors_t = KeyedVec<DrawEnt, Magnum::Color4>;
 using DrawEntTextures_t = KeyedVec<DrawEnt, TexIdOwner_t>;
 using DrawTransforms_t = KeyedVec<DrawEnt, Matrix4>;
+using TreeTransforms_t = KeyedVec<active::TreePos_t, Matrix4>;
+
+/**
+ * @brief Data needed to calculate draw transforms, laid out by scene graph tree position
+ *
+ * Filled by SysRender::gather_tree_transforms, so SysRender::update_draw_transforms_linear only
+ * reads arrays in the same order that it walks the tree.
+ */
+struct TreeDrawTransforms
+{
+    struct Ancestor
+    {
+        active::TreePos_t pos;
+        active::TreePos_t end; ///< One past the last descendant
+    };
+
+    void resize(std::size_t const size)
+    {
+        localTf     .resize(size);
+        drawTf      .resize(size);
+        needDrawTf  .resize(size, 0);
+    }
+
+    /// Copies of ACompTransform::m_transform
+    TreeTransforms_t                            localTf;
+
+    /// Draw transforms, relative to the scene root
+    TreeTransforms_t                            drawTf;
+
+    /// Non-zero if the entity at this position needs a draw transform
+    KeyedVec<active::TreePos_t, std::uint8_t>   needDrawTf;
+
+    // Temporaries, kept to avoid allocating each update
+    std::vector<Ancestor>                       ancestors;
+    std::vector<active::TreePos_t>              dirtyPos;
+};
 
 struct ACtxSceneRender
 {
     ACtxSceneRender() = default;
     OSP_MOVE_ONLY_CTOR_ASSIGN(ACtxSceneRender);
 
+    /**
+     * @brief Grow per-DrawEnt containers to fit m_drawIds.capacity()
+     *
+     * Does nothing if they already fit. Otherwise, capacity at least doubles, so spawning many
+     * DrawEnts over several frames only reallocates a logarithmic number of times. Material sets
+     * are paged and grow on insert, so they are not touched here.
+     */
     void resize_draw()
     {
-        std::size_t const size = m_drawIds.capacity();
+        std::size_t const needed = m_drawIds.capacity();
+        if (needed <= m_drawCapacity)
+        {
+            return;
+        }
+
+        std::size_t const size = std::max(needed, m_drawCapacity * 2);
+        m_drawCapacity = size;
 
         m_opaque.resize(size);
         m_transparent.resize(size);
@@ -132,11 +231,7 @@ struct ACtxSceneRender
         m_color         .resize(size, {1.0f, 1.0f, 1.0f, 1.0f}); // Default white
         m_diffuseTex    .resize(size);
         m_mesh          .resize(size);
-
-        for (MaterialId matId : m_materialIds)
-        {
-            m_materials[matId].m_ents.resize(size);
-        }
+        m_meshLod       .resize(size);
     }
 
     void resize_active(std::size_t const size)
@@ -148,6 +243,9 @@ struct ACtxSceneRender
 
     lgrn::IdRegistryStl<DrawEnt>            m_drawIds;
 
+    /// Size of per-DrawEnt containers, may exceed m_drawIds.capacity(). See resize_draw()
+    std::size_t                             m_drawCapacity{0};
+
     DrawEntSet_t                            m_opaque;
     DrawEntSet_t                            m_transparent;
     DrawEntSet_t                            m_visible;
@@ -159,6 +257,17 @@ struct ACtxSceneRender
     KeyedVec<active::ActiveEnt, uint16_t>   drawTfObserverEnable;
     DrawTransforms_t                        m_drawTransform;
 
+    /// Draw transforms in scene graph tree order, see SysRender::update_draw_transforms_linear
+    TreeDrawTransforms                      m_treeDrawTf;
+
+    /// ACtxSceneGraph::m_version that m_treeDrawTf was last fully calculated for. Only subtrees
+    /// of dirty transforms are recalculated while this matches.
+    std::optional<std::uint32_t>            m_treeDrawTfVersion;
+
+    /// Entities given a DrawEnt or added to m_needDrawTf without their transforms changing.
+    /// Their top-level subtrees are recalculated along with ACtxSceneGraph::m_transformDirty.
+    active::ActiveEntVec_t                  m_drawTfChanged;
+
     // Meshes and textures assigned to DrawEnts
     KeyedVec<DrawEnt, TexIdOwner_t>         m_diffuseTex;
     DrawEntVec_t                            m_diffuseDirty;
@@ -166,6 +275,9 @@ struct ACtxSceneRender
     KeyedVec<DrawEnt, MeshIdOwner_t>        m_mesh;
     DrawEntVec_t                            m_meshDirty;
 
+    /// Meshes in m_mesh may be swapped for a level of detail of m_meshLod[drawEnt].base
+    KeyedVec<DrawEnt, DrawEntLod>           m_meshLod;
+
     lgrn::IdRegistryStl<MaterialId>         m_materialIds;
     KeyedVec<MaterialId, Material>          m_materials;
 };
@@ -25,8 +25,14 @@
 #include "drawing_fn.h"
 #include "own_restypes.h"
 
+#include "culling.h"
+
 #include "../core/Resources.h"
 
+#include <Magnum/Trade/MeshData.h>
+
+#include <string>
+
 using namespace osp;
 using namespace osp::active;
 using namespace osp::draw;
@@ -40,6 +46,19 @@ MeshId SysRender::own_mesh_resource(ACtxDrawing& rCtxDrawing, ACtxDrawingRes& rC
         MeshId const meshId = rCtxDrawing.m_meshIds.create();
         rCtxDrawingRes.m_meshToRes.emplace(meshId, std::move(owner));
         it->second = meshId;
+
+        rCtxDrawing.m_meshBounds.resize(rCtxDrawing.m_meshIds.capacity());
+        auto const *pMeshData = rResources.data_try_get<Magnum::Trade::MeshData const>(restypes::gc_mesh, resId);
+        if (pMeshData != nullptr && pMeshData->hasAttribute(Magnum::Trade::MeshAttribute::Position))
+        {
+            Corrade::Containers::Array<Vector3> const positions = pMeshData->positions3DAsArray();
+            rCtxDrawing.m_meshBounds[meshId] = bounding_sphere(positions);
+        }
+        else
+        {
+            rCtxDrawing.m_meshBounds[meshId] = {};
+        }
+
         return meshId;
     }
     return it->second;
@@ -93,6 +112,36 @@ void SysRender::clear_resource_owners(ACtxDrawingRes& rCtxDrawingRes, Resources
     rCtxDrawingRes.m_resToMesh.clear();
 }
 
+void SysRender::gather_tree_transforms(ArgsForUpdDrawTransform args, TreeDrawTransforms& rTree)
+{
+    using namespace osp::active;
+
+    auto const &entToTreePos = args.scnGraph.m_entToTreePos;
+    auto const tree_pos_of = [&entToTreePos] (ActiveEnt const ent) -> TreePos_t
+    {
+        return (std::size_t(ent) < entToTreePos.size()) ? entToTreePos[ent] : lgrn::id_null<TreePos_t>();
+    };
+
+    std::fill(rTree.needDrawTf.begin(), rTree.needDrawTf.end(), std::uint8_t(0));
+    for (ActiveEnt const ent : args.needDrawTf)
+    {
+        TreePos_t const pos = tree_pos_of(ent);
+        if (pos != lgrn::id_null<TreePos_t>())
+        {
+            rTree.needDrawTf[pos] = 1;
+        }
+    }
+
+    for (auto const& [ent, transform] : args.transforms.each())
+    {
+        TreePos_t const pos = tree_pos_of(ent);
+        if (pos != lgrn::id_null<TreePos_t>())
+        {
+            rTree.localTf[pos] = transform.m_transform;
+        }
+    }
+}
+
 MeshIdOwner_t SysRender::add_drawable_mesh(ACtxDrawing& rDrawing, ACtxDrawingRes& rDrawingRes, Resources& rResources, PkgId const pkg, std::string_view const name)
 {
     ResId const res = rResources.find(restypes::gc_mesh, pkg, name);
@@ -101,4 +150,48 @@ MeshIdOwner_t SysRender::add_drawable_mesh(ACtxDrawing& rDrawing, ACtxDrawingRes
     return rDrawing.m_meshRefCounts.ref_add(meshId);
 }
 
+std::size_t SysRender::add_mesh_lods(ACtxDrawing& rDrawing, ACtxDrawingRes& rDrawingRes, Resources& rResources, PkgId const pkg, std::string_view const name, ArrayView<float const> const minScreenSizes)
+{
+    ResId const baseRes = rResources.find(restypes::gc_mesh, pkg, name);
+    assert(baseRes != lgrn::id_null<ResId>());
+
+    MeshLodGroup group;
+    group.levels.push_back({
+            .mesh          = SysRender::own_mesh_resource(rDrawing, rDrawingRes, rResources, baseRes),
+            .minScreenSize = minScreenSizes.isEmpty() ? 0.1f : minScreenSizes[0] });
+
+    std::string lodName{name};
+    lodName += "_LOD";
+    std::size_t const prefixSize = lodName.size();
+
+    for (std::size_t level = 1; ; ++level)
+    {
+        lodName.resize(prefixSize);
+        lodName += std::to_string(level);
+
+        ResId const lodRes = rResources.find(restypes::gc_mesh, pkg, lodName);
+        if (lodRes == lgrn::id_null<ResId>())
+        {
+            break;
+        }
+
+        group.levels.push_back({
+                .mesh          = SysRender::own_mesh_resource(rDrawing, rDrawingRes, rResources, lodRes),
+                .minScreenSize = (level < minScreenSizes.size()) ? minScreenSizes[level]
+                                                                 : group.levels.back().minScreenSize * 0.5f });
+    }
+
+    std::size_t const lodCount = group.levels.size() - 1;
+    if (lodCount != 0)
+    {
+        group.levels.back().minScreenSize = 0.0f;
+
+        MeshId const baseMesh = group.levels.front().mesh;
+        rDrawing.m_meshLods.resize(rDrawing.m_meshIds.capacity());
+        rDrawing.m_meshLods[baseMesh] = std::move(group);
+    }
+
+    return lodCount;
+}
+
 
@@ -28,6 +28,10 @@
 
 #include "../activescene/basic.h"
 #include "../activescene/basic_fn.h"
+#include "../core/array_view.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace osp::draw
 {
@@ -95,11 +99,22 @@ struct EntityToDraw
     using ShaderDrawFnc_t = void (*)(
             DrawEnt, ViewProjMatrix const&, UserData_t) noexcept;
 
+    /**
+     * @brief An optional function pointer to draw many entities at once, such as by instancing
+     *
+     * Entities passed share the same mesh and texture, see RenderQueue::Batch.
+     */
+    using ShaderDrawBatchFnc_t = void (*)(
+            ArrayView<DrawEnt const>, ViewProjMatrix const&, UserData_t) noexcept;
+
     ShaderDrawFnc_t draw;
 
     // Non-owning user data passed to draw function, such as the shader
     UserData_t data;
 
+    // If null, draw is called for each entity in a batch
+    ShaderDrawBatchFnc_t drawBatch{nullptr};
+
 }; // struct EntityToDraw
 
 /**
@@ -185,12 +200,91 @@ public:
             ITB_T const&                last,
             FUNC_T                      func = {});
 
+    /**
+     * @brief Copy local transforms and needDrawTf of all entities in the scene graph into rTree
+     *
+     * The transform storage and needDrawTf set are read in their own order, instead of looking up
+     * each entity in tree order. rTree must be resized to ACtxSceneGraph::m_treeToEnt.size().
+     *
+     * @param args      [in] Same as update_draw_transforms, rDrawTf is not written
+     * @param rTree     [out] localTf and needDrawTf are written
+     */
+    static void gather_tree_transforms(
+            ArgsForUpdDrawTransform     args,
+            TreeDrawTransforms&         rTree);
+
+    /**
+     * @brief Calculate draw transforms by walking the scene graph's tree positions in order
+     *
+     * Non-recursive alternative to update_draw_transforms. A stack of ancestor tree positions is
+     * kept instead of recursing through children. Every array read per entity is either indexed
+     * by tree position or by ActiveEnt, and transforms are written to rTree.drawTf in tree order,
+     * so each parent transform is read from a nearby earlier element.
+     *
+     * [first, last) must only contain whole subtrees, such as [1, m_treeToEnt.size()) for the
+     * entire scene, or the subtree of a single child of the root. Calls share rTree.ancestors, so
+     * they must not run concurrently with the same rTree.
+     *
+     * @param args      [in] Same as update_draw_transforms, only scnGraph, activeToDraw and
+     *                       rDrawTf are used
+     * @param rTree     [ref] Must be filled by gather_tree_transforms. Draw transforms are
+     *                        written to drawTf, only for entities that need them.
+     * @param first     [in] First tree position
+     * @param last      [in] One past the last tree position
+     * @param func      [in] Called for each transform calculated, same as update_draw_transforms
+     */
+    template<typename FUNC_T = UpdDrawTransformNoOp>
+    static void update_draw_transforms_linear(
+            ArgsForUpdDrawTransform     args,
+            TreeDrawTransforms&         rTree,
+            active::TreePos_t           first,
+            active::TreePos_t           last,
+            FUNC_T                      func = {});
+
+    /**
+     * @brief Recalculate draw transforms of only the subtrees of entities that moved
+     *
+     * Entities not in any of the given entities' subtrees are not visited at all. Transforms of
+     * their parents are read from rTree, so rTree must be fully calculated beforehand with
+     * gather_tree_transforms and update_draw_transforms_linear, and tree positions must not have
+     * been shifted since (see ACtxSceneGraph::m_transformDirty and m_version). Local transforms
+     * and needDrawTf of the given entities' entire subtrees are copied into rTree again, as
+     * positions within a subtree may have shifted.
+     *
+     * @param args      [in] Same as update_draw_transforms
+     * @param rTree     [ref] Draw transforms by tree position
+     * @param first     [in] First dirty entity, may include duplicates and deleted entities
+     * @param last      [in] Last dirty entity
+     * @param func      [in] Called for each transform calculated, same as update_draw_transforms
+     */
+    template<typename IT_T, typename ITB_T, typename FUNC_T = UpdDrawTransformNoOp>
+    static void update_draw_transforms_dirty(
+            ArgsForUpdDrawTransform     args,
+            TreeDrawTransforms&         rTree,
+            IT_T                        first,
+            ITB_T const&                last,
+            FUNC_T                      func = {});
+
     template<typename IT_T>
     static void update_delete_drawing(
             ACtxSceneRender& rCtxScnRdr, ACtxDrawing& rCtxDrawing, IT_T const& first, IT_T const& last);
 
     static MeshIdOwner_t add_drawable_mesh(ACtxDrawing& rDrawing, ACtxDrawingRes& rDrawingRes, Resources& rResources, PkgId const pkg, std::string_view const name);
 
+    /**
+     * @brief Add levels of detail to a mesh from resources named "<name>_LOD1", "<name>_LOD2", ...
+     *
+     * glTF files loaded with load_tinygltf_file can provide levels of detail by naming their
+     * meshes this way. See SysMeshLod for how levels are selected.
+     *
+     * @param minScreenSizes    [in] MeshLod::minScreenSize for each level, starting with the full
+     *                               detail mesh. Missing sizes are halved from the previous level.
+     *                               The last level found always uses 0.0f.
+     *
+     * @return Number of levels found, not including the full detail mesh
+     */
+    static std::size_t add_mesh_lods(ACtxDrawing& rDrawing, ACtxDrawingRes& rDrawingRes, Resources& rResources, PkgId const pkg, std::string_view const name, ArrayView<float const> minScreenSizes);
+
     static constexpr decltype(auto) gen_drawable_mesh_adder(ACtxDrawing& rDrawing, ACtxDrawingRes& rDrawingRes, Resources& rResources, PkgId const pkg);
 
 private:
@@ -203,6 +297,20 @@ private:
             int                         depth,
             FUNC_T&                     func);
 
+    /**
+     * @brief update_draw_transforms_linear, with a transform and depth for the parent of the
+     *        subtrees in [first, last)
+     */
+    template<typename FUNC_T>
+    static void update_draw_transforms_linear_impl(
+            ArgsForUpdDrawTransform     args,
+            TreeDrawTransforms&         rTree,
+            active::TreePos_t           first,
+            active::TreePos_t           last,
+            Matrix4 const*              pParentTf,
+            int                         depth,
+            FUNC_T&                     func);
+
 }; // class SysRender
 
 void SysRender::needs_draw_transforms(
@@ -273,6 +381,145 @@ void SysRender::update_draw_transforms_recurse(
     }
 }
 
+template<typename FUNC_T>
+void SysRender::update_draw_transforms_linear(
+        ArgsForUpdDrawTransform     args,
+        TreeDrawTransforms&         rTree,
+        active::TreePos_t const     first,
+        active::TreePos_t const     last,
+        FUNC_T                      func)
+{
+    update_draw_transforms_linear_impl(args, rTree, first, last, nullptr, 1, func);
+}
+
+template<typename IT_T, typename ITB_T, typename FUNC_T>
+void SysRender::update_draw_transforms_dirty(
+        ArgsForUpdDrawTransform     args,
+        TreeDrawTransforms&         rTree,
+        IT_T                        first,
+        ITB_T const&                last,
+        FUNC_T                      func)
+{
+    using namespace osp::active;
+
+    ACtxSceneGraph const &scnGraph = args.scnGraph;
+
+    std::vector<TreePos_t> &rDirtyPos = rTree.dirtyPos;
+    rDirtyPos.clear();
+    while (first != last)
+    {
+        ActiveEnt const ent = *first;
+        if (   std::size_t(ent) < scnGraph.m_entToTreePos.size()
+            && scnGraph.m_entToTreePos[ent] != lgrn::id_null<TreePos_t>() )
+        {
+            rDirtyPos.push_back(scnGraph.m_entToTreePos[ent]);
+        }
+        std::advance(first, 1);
+    }
+
+    // Sorting by tree position puts ancestors before descendants, so subtrees already covered by
+    // a dirty ancestor can be skipped
+    std::sort(rDirtyPos.begin(), rDirtyPos.end());
+
+    TreePos_t coveredLast = 0;
+    for (TreePos_t const pos : rDirtyPos)
+    {
+        if (pos < coveredLast)
+        {
+            continue;
+        }
+        coveredLast = pos + 1 + scnGraph.m_treeDescendants[pos];
+
+        // Adding to or deleting from a subtree shifts tree positions within it and only marks
+        // its top-level ancestor dirty, so gather the entire subtree again, not just pos. This
+        // also clears needDrawTf of descendants of entities that no longer need draw transforms.
+        for (TreePos_t subPos = pos; subPos != coveredLast; ++subPos)
+        {
+            ActiveEnt const subEnt  = scnGraph.m_treeToEnt[subPos];
+            bool const      need    = args.needDrawTf.contains(subEnt);
+            rTree.needDrawTf[subPos] = need ? 1 : 0;
+            if (need && args.transforms.contains(subEnt))
+            {
+                rTree.localTf[subPos] = args.transforms.get(subEnt).m_transform;
+            }
+        }
+
+        ActiveEnt const parent = scnGraph.m_entParent[scnGraph.m_treeToEnt[pos]];
+
+        int depth = 1;
+        for (ActiveEnt ancestor = parent; ancestor != lgrn::id_null<ActiveEnt>(); ancestor = scnGraph.m_entParent[ancestor])
+        {
+            ++depth;
+        }
+
+        Matrix4 const *pParentTf = (parent == lgrn::id_null<ActiveEnt>())
+                                 ? nullptr
+                                 : &rTree.drawTf[scnGraph.m_entToTreePos[parent]];
+
+        update_draw_transforms_linear_impl(args, rTree, pos, coveredLast, pParentTf, depth, func);
+    }
+}
+
+template<typename FUNC_T>
+void SysRender::update_draw_transforms_linear_impl(
+        ArgsForUpdDrawTransform     args,
+        TreeDrawTransforms&         rTree,
+        active::TreePos_t const     first,
+        active::TreePos_t const     last,
+        Matrix4 const*              pParentTf,
+        int const                   depth,
+        FUNC_T&                     func)
+{
+    using namespace osp::active;
+
+    std::vector<TreeDrawTransforms::Ancestor> &rAncestors = rTree.ancestors;
+    rAncestors.clear();
+
+    TreePos_t pos = first;
+    while (pos < last)
+    {
+        while ( ! rAncestors.empty() && rAncestors.back().end <= pos )
+        {
+            rAncestors.pop_back();
+        }
+
+        uint32_t const descendants = args.scnGraph.m_treeDescendants[pos];
+
+        // Also zero for runs of unused tree positions
+        if (rTree.needDrawTf[pos] == 0)
+        {
+            pos += 1 + descendants; // Skip entire subtree
+            continue;
+        }
+
+        ActiveEnt const ent         = args.scnGraph.m_treeToEnt[pos];
+        Matrix4 const&  entTf       = rTree.localTf[pos];
+        Matrix4 &       rEntDrawTf  = rTree.drawTf[pos];
+        if ( ! rAncestors.empty() )
+        {
+            rEntDrawTf = rTree.drawTf[rAncestors.back().pos] * entTf;
+        }
+        else
+        {
+            rEntDrawTf = (pParentTf != nullptr) ? (*pParentTf * entTf) : entTf;
+        }
+
+        func(rEntDrawTf, ent, depth + int(rAncestors.size()));
+
+        DrawEnt const drawEnt = args.activeToDraw[ent];
+        if (drawEnt != lgrn::id_null<DrawEnt>())
+        {
+            args.rDrawTf[drawEnt] = rEntDrawTf;
+        }
+
+        if (descendants != 0)
+        {
+            rAncestors.push_back({.pos = pos, .end = pos + 1 + descendants});
+        }
+
+        ++pos;
+    }
+}
 
 template<typename STORAGE_T, typename REFCOUNT_T>
 void remove_refcounted(
@@ -295,6 +542,7 @@ void SysRender::update_delete_drawing(
 
         remove_refcounted(drawEnt, rCtxScnRdr.m_diffuseTex, rCtxDrawing.m_texRefCounts);
         remove_refcounted(drawEnt, rCtxScnRdr.m_mesh,       rCtxDrawing.m_meshRefCounts);
+        rCtxScnRdr.m_meshLod[drawEnt] = {};
     }
 }
 
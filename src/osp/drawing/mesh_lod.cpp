@@ -0,0 +1,126 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "mesh_lod.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace osp;
+using namespace osp::draw;
+
+std::uint8_t SysMeshLod::select_level(
+        MeshLodGroup const& group, std::uint8_t const current, float const screenSize, float const hysteresis) noexcept
+{
+    auto const count = std::uint8_t(group.levels.size());
+    std::uint8_t level = std::min<std::uint8_t>(current, count - 1);
+
+    // Move to higher detail only once comfortably above the next level's threshold
+    while (level > 0 && screenSize >= group.levels[level - 1].minScreenSize * (1.0f + hysteresis))
+    {
+        --level;
+    }
+
+    // Move to lower detail only once comfortably below the current level's threshold
+    while (level + 1 < count && screenSize < group.levels[level].minScreenSize * (1.0f - hysteresis))
+    {
+        ++level;
+    }
+
+    return level;
+}
+
+float SysMeshLod::screen_size(Vector3 const center, float const radius, ViewProjMatrix const& viewProj) noexcept
+{
+    // Camera looks towards -Z
+    float const depth = -viewProj.m_view.transformPoint(center).z();
+    if (depth <= radius)
+    {
+        return std::numeric_limits<float>::infinity(); // Camera is inside or very near
+    }
+
+    // m_proj[1][1] is cot(fovY/2), which converts view-space height over depth to [-1, 1]
+    return radius * viewProj.m_proj[1][1] / depth;
+}
+
+void SysMeshLod::update(
+        ACtxSceneRender&        rScnRender,
+        ACtxDrawing&            rDrawing,
+        DrawEntSet_t const&     ents,
+        ViewProjMatrix const&   viewProj,
+        float                   const hysteresis)
+{
+    for (DrawEnt const drawEnt : ents)
+    {
+        MeshIdOwner_t &rMeshOwner = rScnRender.m_mesh[drawEnt];
+        if ( ! rMeshOwner.has_value() )
+        {
+            continue;
+        }
+
+        MeshId     const current = rMeshOwner.value();
+        DrawEntLod       &rLod   = rScnRender.m_meshLod[drawEnt];
+
+        bool const tracked =    rLod.base != lgrn::id_null<MeshId>()
+                             && rDrawing.m_meshLods[rLod.base].levels[rLod.level].mesh == current;
+        if ( ! tracked )
+        {
+            // New DrawEnt, or a different mesh was assigned
+            bool const hasLods =    std::size_t(current) < rDrawing.m_meshLods.size()
+                                 && rDrawing.m_meshLods[current].levels.size() > 1;
+            rLod = hasLods ? DrawEntLod{.base = current, .level = 0} : DrawEntLod{};
+            if ( ! hasLods )
+            {
+                continue;
+            }
+        }
+
+        // All levels use the bounds of the full detail mesh, so that switching levels doesn't
+        // change the size used to pick them
+        if (   std::size_t(rLod.base) >= rDrawing.m_meshBounds.size()
+            || std::isinf(rDrawing.m_meshBounds[rLod.base].radius) )
+        {
+            continue;
+        }
+
+        BoundingSphere const &bounds = rDrawing.m_meshBounds[rLod.base];
+        Matrix4        const &tf     = rScnRender.m_drawTransform[drawEnt];
+
+        float const scale = std::sqrt(std::max({tf[0].xyz().dot(), tf[1].xyz().dot(), tf[2].xyz().dot()}));
+        float const size  = screen_size(tf.transformPoint(bounds.center), bounds.radius * scale, viewProj);
+
+        MeshLodGroup const &group    = rDrawing.m_meshLods[rLod.base];
+        std::uint8_t const newLevel = select_level(group, rLod.level, size, hysteresis);
+        if (newLevel == rLod.level)
+        {
+            continue;
+        }
+
+        rDrawing.m_meshRefCounts.ref_release(std::move(rMeshOwner));
+        rMeshOwner = rDrawing.m_meshRefCounts.ref_add(group.levels[newLevel].mesh);
+        rLod.level = newLevel;
+        rScnRender.m_meshDirty.push_back(drawEnt);
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/**
+ * @file
+ * @brief Per-frame level of detail selection for DrawEnt meshes
+ */
+#pragma once
+
+#include "drawing_fn.h"
+
+namespace osp::draw
+{
+
+class SysMeshLod
+{
+public:
+
+    /**
+     * @brief Pick a level of detail for a mesh of a certain size on screen
+     *
+     * A level only changes once the size is past the threshold by a fraction of hysteresis, so
+     * meshes near a threshold don't flicker between levels.
+     *
+     * @param group         [in] Levels of detail
+     * @param current       [in] Currently used level
+     * @param screenSize    [in] Size of the bounding sphere on screen, as a fraction of the screen
+     *                           height
+     * @param hysteresis    [in] Fraction of a threshold, such as 0.1f
+     */
+    [[nodiscard]] static std::uint8_t select_level(
+            MeshLodGroup const& group, std::uint8_t current, float screenSize, float hysteresis) noexcept;
+
+    /**
+     * @return Size of a world-space sphere on screen, as a fraction of the screen height
+     */
+    [[nodiscard]] static float screen_size(Vector3 center, float radius, ViewProjMatrix const& viewProj) noexcept;
+
+    /**
+     * @brief Swap meshes of DrawEnts to the level of detail that fits their size on screen
+     *
+     * DrawEnts with a mesh that has an MeshLodGroup in ACtxDrawing::m_meshLods are picked up
+     * automatically. Assigning a different mesh to m_mesh resets the DrawEnt's level of detail.
+     * DrawEnts are only added to ACtxSceneRender::m_meshDirty when their level changes.
+     *
+     * @param rScnRender    [ref] Meshes of DrawEnts to update
+     * @param rDrawing      [ref] Mesh LOD groups, bounds, and reference counts
+     * @param ents          [in] DrawEnts to update, such as those in view
+     * @param viewProj      [in] View and projection matrix
+     * @param hysteresis    [in] See select_level
+     */
+    static void update(
+            ACtxSceneRender&        rScnRender,
+            ACtxDrawing&            rDrawing,
+            DrawEntSet_t const&     ents,
+            ViewProjMatrix const&   viewProj,
+            float                   hysteresis = 0.1f);
+};
+
+} // namespace osp::draw
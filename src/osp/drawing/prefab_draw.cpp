@@ -64,6 +64,7 @@ void SysPrefabDraw::init_drawents(
 
             ActiveEnt const ent = ents[i];
             rScnRender.m_activeToDraw[ent] = rScnRender.m_drawIds.create();
+            rScnRender.m_drawTfChanged.push_back(ent);
         }
 
         ++itPfEnts;
@@ -100,6 +101,7 @@ void SysPrefabDraw::resync_drawents(
 
             LGRN_ASSERT(rScnRender.m_activeToDraw[ent] == lgrn::id_null<DrawEnt>());
             rScnRender.m_activeToDraw[ent] = rScnRender.m_drawIds.create();
+            rScnRender.m_drawTfChanged.push_back(ent);
         }
     }
 }
@@ -220,6 +222,7 @@ void SysPrefabDraw::resync_mesh_texture_material(
             }
 
             SysRender::needs_draw_transforms(rBasic.m_scnGraph, rScnRender.m_needDrawTf, ent);
+            rScnRender.m_drawTfChanged.push_back(ent);
 
             DrawEnt const drawEnt = rScnRender.m_activeToDraw[ent];
 
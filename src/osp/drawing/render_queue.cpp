@@ -0,0 +1,225 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "render_queue.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+using namespace osp;
+using namespace osp::draw;
+
+namespace
+{
+
+bool same_shader(EntityToDraw const& lhs, EntityToDraw const& rhs) noexcept
+{
+    return lhs.draw == rhs.draw && lhs.drawBatch == rhs.drawBatch && lhs.data == rhs.data;
+}
+
+/**
+ * @return Top 22 bits of a non-negative float. These sort in the same order as the float.
+ */
+std::uint64_t depth_bits(float const depth) noexcept
+{
+    return std::bit_cast<std::uint32_t>(std::max(depth, 0.0f)) >> 9u;
+}
+
+template <typename ID_T>
+std::uint64_t id_bits(ID_T const id) noexcept
+{
+    return std::uint64_t(id) & 0xFFFFu;
+}
+
+} // namespace
+
+std::uint64_t SysRenderQueue::make_key(
+        ERenderPass     const pass,
+        std::uint32_t   const shader,
+        TexId           const texture,
+        MeshId          const mesh,
+        float           const depth) noexcept
+{
+    std::uint64_t const passBits   = std::uint64_t(pass) << 62u;
+    std::uint64_t const shaderBits = std::uint64_t(shader) & 0xFFu;
+
+    switch (pass)
+    {
+    case ERenderPass::Transparent:
+        return passBits
+             | ((~depth_bits(depth) & 0x3FFFFFu) << 40u)
+             | (shaderBits          << 32u)
+             | (id_bits(texture)    << 16u)
+             |  id_bits(mesh);
+    case ERenderPass::Opaque:
+    default:
+        return passBits
+             | (shaderBits          << 54u)
+             | (id_bits(texture)    << 38u)
+             | (id_bits(mesh)       << 22u)
+             |  depth_bits(depth);
+    }
+}
+
+void SysRenderQueue::build(
+        RenderQueue&            rQueue,
+        RenderGroup const&      group,
+        DrawEntSet_t const&     visible,
+        ACtxSceneRender const&  scnRender,
+        ViewProjMatrix const&   viewProj,
+        ERenderPass             const pass)
+{
+    rQueue.shaders  .clear();
+    rQueue.ents     .clear();
+    rQueue.batches  .clear();
+    rQueue.entries  .clear();
+
+    // Only the 3rd row of the view matrix is needed to calculate view-space Z
+    Vector4 const viewRowZ = viewProj.m_view.row(2);
+
+    for (auto const& [ent, toDraw] : entt::basic_view{group.entities}.each())
+    {
+        if ( ! visible.contains(ent) )
+        {
+            continue;
+        }
+
+        // Few shaders are expected, linear search is fine
+        auto const itShader = std::find_if(rQueue.shaders.begin(), rQueue.shaders.end(),
+                                           [&toDraw = toDraw] (EntityToDraw const& shader) noexcept
+        {
+            return same_shader(shader, toDraw);
+        });
+
+        auto const shader = std::uint32_t(std::distance(rQueue.shaders.begin(), itShader));
+        if (itShader == rQueue.shaders.end())
+        {
+            LGRN_ASSERTM(rQueue.shaders.size() < smc_maxShaders, "Too many distinct shaders in one RenderGroup");
+            rQueue.shaders.push_back(toDraw);
+        }
+
+        MeshIdOwner_t const &meshOwner = scnRender.m_mesh[ent];
+        TexIdOwner_t  const &texOwner  = scnRender.m_diffuseTex[ent];
+        MeshId const mesh    = meshOwner.has_value() ? meshOwner.value() : lgrn::id_null<MeshId>();
+        TexId  const texture = texOwner .has_value() ? texOwner .value() : lgrn::id_null<TexId>();
+
+        // Camera looks towards -Z, so depth is negative view-space Z
+        Vector3 const pos   = scnRender.m_drawTransform[ent].translation();
+        float   const depth = -(Magnum::Math::dot(viewRowZ.xyz(), pos) + viewRowZ.w());
+
+        rQueue.entries.push_back({
+                .key     = make_key(pass, shader, texture, mesh, depth),
+                .ent     = ent,
+                .shader  = shader,
+                .mesh    = mesh,
+                .texture = texture });
+    }
+
+    radix_sort(rQueue.entries, rQueue.sortTemp);
+
+    // Coalesce runs of the same shader, mesh, and texture into batches
+
+    rQueue.ents.reserve(rQueue.entries.size());
+    for (RenderQueue::Entry const& entry : rQueue.entries)
+    {
+        auto const index = std::uint32_t(rQueue.ents.size());
+        rQueue.ents.push_back(entry.ent);
+
+        if ( ! rQueue.batches.empty() )
+        {
+            RenderQueue::Batch      &rLast     = rQueue.batches.back();
+            RenderQueue::Entry const &lastEntry = rQueue.entries[rLast.first];
+            if (   lastEntry.shader  == entry.shader
+                && lastEntry.mesh    == entry.mesh
+                && lastEntry.texture == entry.texture)
+            {
+                ++rLast.count;
+                continue;
+            }
+        }
+
+        rQueue.batches.push_back({.first = index, .count = 1, .shader = entry.shader});
+    }
+}
+
+void SysRenderQueue::radix_sort(std::vector<RenderQueue::Entry>& rEntries, std::vector<RenderQueue::Entry>& rTemp)
+{
+    std::size_t const count = rEntries.size();
+    if (count < 2)
+    {
+        return;
+    }
+
+    rTemp.resize(count);
+
+    std::array<std::array<std::uint32_t, 256>, 8> histograms{};
+
+    // Count all 8 digits in one read over the keys
+    for (RenderQueue::Entry const& entry : rEntries)
+    {
+        for (unsigned int digit = 0; digit < 8; ++digit)
+        {
+            ++histograms[digit][(entry.key >> (digit * 8u)) & 0xFFu];
+        }
+    }
+
+    RenderQueue::Entry *pSrc = rEntries.data();
+    RenderQueue::Entry *pDst = rTemp.data();
+
+    for (unsigned int digit = 0; digit < 8; ++digit)
+    {
+        std::array<std::uint32_t, 256> &rHistogram = histograms[digit];
+
+        unsigned int const shift = digit * 8u;
+
+        // Skip if every key has the same digit
+        if (rHistogram[(pSrc->key >> shift) & 0xFFu] == count)
+        {
+            continue;
+        }
+
+        // Convert counts to offsets
+        std::uint32_t sum = 0;
+        for (std::uint32_t &rBucket : rHistogram)
+        {
+            std::uint32_t const bucketCount = rBucket;
+            rBucket = sum;
+            sum += bucketCount;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            pDst[rHistogram[(pSrc[i].key >> shift) & 0xFFu]++] = pSrc[i];
+        }
+
+        std::swap(pSrc, pDst);
+    }
+
+    if (pSrc != rEntries.data())
+    {
+        std::copy_n(pSrc, count, rEntries.data());
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/**
+ * @file
+ * @brief Backend-agnostic render queue that sorts and batches the entities of a RenderGroup
+ */
+#pragma once
+
+#include "drawing_fn.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace osp::draw
+{
+
+enum class ERenderPass : std::uint8_t
+{
+    Opaque      = 0,    ///< Sorted by shader, texture, mesh, then front-to-back
+    Transparent = 1     ///< Sorted back-to-front, then by shader, texture, mesh
+};
+
+/**
+ * @brief Entities of a RenderGroup sorted by 64-bit keys to minimize state changes when drawing
+ *
+ * Opaque key layout, most significant bits first:
+ *
+ * | pass (2) | shader (8) | texture (16) | mesh (16) | depth (22) |
+ *
+ * Transparent key layout:
+ *
+ * | pass (2) | inverted depth (22) | shader (8) | texture (16) | mesh (16) |
+ *
+ * Texture and mesh Ids are truncated to 16 bits, which only affects how well entities are
+ * grouped, not correctness. Batches compare the full Ids.
+ */
+struct RenderQueue
+{
+    struct Entry
+    {
+        std::uint64_t   key;
+        DrawEnt         ent;
+        std::uint32_t   shader;     ///< Index to RenderQueue::shaders
+        MeshId          mesh;
+        TexId           texture;
+    };
+
+    /**
+     * @brief Run of sorted entities that share the same shader, mesh, and texture
+     */
+    struct Batch
+    {
+        std::uint32_t   first;      ///< Index to RenderQueue::ents
+        std::uint32_t   count;
+        std::uint32_t   shader;     ///< Index to RenderQueue::shaders
+    };
+
+    /// Distinct draw functions and user data found in the RenderGroup
+    std::vector<EntityToDraw>   shaders;
+
+    /// Entities in draw order
+    std::vector<DrawEnt>        ents;
+
+    std::vector<Batch>          batches;
+
+    // Temporaries
+    std::vector<Entry>          entries;
+    std::vector<Entry>          sortTemp;
+};
+
+class SysRenderQueue
+{
+public:
+
+    static constexpr std::size_t smc_maxShaders = 256;
+
+    /**
+     * @brief Sort visible entities of a RenderGroup into a RenderQueue
+     *
+     * @param rQueue    [out] Queue to write, previous contents are discarded
+     * @param group     [in] RenderGroup containing entities and their draw functions
+     * @param visible   [in] Only these entities are added
+     * @param scnRender [in] Meshes, textures, and draw transforms of entities
+     * @param viewProj  [in] View matrix used for depth
+     * @param pass      [in] Determines sort order
+     */
+    static void build(
+            RenderQueue&            rQueue,
+            RenderGroup const&      group,
+            DrawEntSet_t const&     visible,
+            ACtxSceneRender const&  scnRender,
+            ViewProjMatrix const&   viewProj,
+            ERenderPass             pass);
+
+    [[nodiscard]] static std::uint64_t make_key(
+            ERenderPass     pass,
+            std::uint32_t   shader,
+            TexId           texture,
+            MeshId          mesh,
+            float           depth) noexcept;
+
+    /**
+     * @brief Stable LSD radix sort by RenderQueue::Entry::key, 8 bits at a time
+     *
+     * Passes where all keys share the same digit are skipped.
+     *
+     * @param rEntries  [ref] Entries to sort
+     * @param rTemp     [ref] Temporary buffer, resized to fit
+     */
+    static void radix_sort(std::vector<RenderQueue::Entry>& rEntries, std::vector<RenderQueue::Entry>& rTemp);
+};
+
+} // namespace osp::draw
@@ -26,6 +26,12 @@
 
 #include "../core/math_types.h"
 
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
 namespace osp
 {
 
@@ -92,6 +98,36 @@ Matrix3 transform_inertia_tensor(Matrix3 I, float mass,
  */
 Vector3 collider_inertia_tensor(EShape shape, Vector3 scale, float mass);
 
+/**
+ * @brief Identifies a primitive shape of an exact scale
+ *
+ * Scales are compared by their exact bits, so two different scales never share a key, including
+ * negative and very large ones.
+ */
+struct ShapeCacheKey
+{
+    constexpr bool operator==(ShapeCacheKey const&) const noexcept = default;
+
+    EShape                          shape;
+    std::array<std::uint32_t, 3>    scaleBits;
+};
+
+/**
+ * Compute a key identifying a primitive shape of a given scale
+ *
+ * Intended for caching collision shapes, so that spawning many shapes of the
+ * same size can share a single physics engine shape.
+ *
+ * @param shape [in] The primitive shape
+ * @param scale [in] The (x, y, z) scale of the shape
+ */
+constexpr ShapeCacheKey shape_cache_key(EShape shape, Vector3 scale) noexcept
+{
+    return { shape, { std::bit_cast<std::uint32_t>(scale.x()),
+                      std::bit_cast<std::uint32_t>(scale.y()),
+                      std::bit_cast<std::uint32_t>(scale.z()) } };
+}
+
 /**
  * Compute the inertia tensor for a cylinder
  *
@@ -166,3 +202,25 @@ constexpr Vector3 ellipsoid_inertia_tensor(const Vector3 semiaxes, float mass) n
 }
 
 } // namespace osp
+
+// Allows osp::ShapeCacheKey as a hashmap key
+template<>
+struct std::hash<osp::ShapeCacheKey>
+{
+    std::size_t operator()(osp::ShapeCacheKey const& key) const noexcept
+    {
+        // FNV-1a, same as SysPhysics::hash_compound
+        std::uint64_t hash = 14695981039346656037ull;
+        auto const add = [&hash] (std::uint32_t const value) noexcept
+        {
+            hash = (hash ^ value) * 1099511628211ull;
+        };
+
+        add(std::uint32_t(key.shape));
+        for (std::uint32_t const bits : key.scaleBits)
+        {
+            add(bits);
+        }
+        return std::size_t(hash);
+    }
+};
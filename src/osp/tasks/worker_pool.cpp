@@ -0,0 +1,102 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "worker_pool.h"
+
+#include <algorithm>
+
+namespace osp
+{
+
+WorkerPool::WorkerPool(std::size_t const threadCount)
+{
+    if (threadCount == 0)
+    {
+        return;
+    }
+
+    m_pState = std::make_shared<State>();
+    m_pState->threads.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i)
+    {
+        m_pState->threads.emplace_back([pState = m_pState.get()] { pState->run_worker(); });
+    }
+}
+
+void WorkerPool::submit(Job_t job)
+{
+    if (m_pState == nullptr)
+    {
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> const lock(m_pState->mutex);
+        m_pState->jobs.push_back(std::move(job));
+    }
+    m_pState->jobReady.notify_one();
+}
+
+std::size_t WorkerPool::default_thread_count() noexcept
+{
+    return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+WorkerPool::State::~State()
+{
+    {
+        std::lock_guard<std::mutex> const lock(mutex);
+        stop = true;
+    }
+    jobReady.notify_all();
+
+    for (std::thread &rThread : threads)
+    {
+        rThread.join();
+    }
+}
+
+void WorkerPool::State::run_worker()
+{
+    while (true)
+    {
+        Job_t job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [this] { return stop || ! jobs.empty(); });
+
+            // Jobs still queued when stopping are finished first
+            if (jobs.empty())
+            {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+} // namespace osp
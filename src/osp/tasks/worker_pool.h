@@ -0,0 +1,92 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace osp
+{
+
+/**
+ * @brief Fixed set of worker threads that run submitted jobs in FIFO order
+ *
+ * Intended to be created once for the whole process (see FIMainApp::DataIds::workerPool), so that
+ * anything that wants to run in parallel shares the same threads instead of each spawning its
+ * own and oversubscribing cores.
+ *
+ * WorkerPool is a handle; copies share the same threads, which are joined once the last copy is
+ * destroyed. A pool with no threads runs jobs immediately on the submitting thread.
+ */
+class WorkerPool
+{
+public:
+
+    using Job_t = std::function<void()>;
+
+    WorkerPool() = default;
+    explicit WorkerPool(std::size_t threadCount);
+
+    /**
+     * @brief Queue a job to run on any worker thread
+     */
+    void submit(Job_t job);
+
+    [[nodiscard]] std::size_t thread_count() const noexcept
+    {
+        return (m_pState != nullptr) ? m_pState->threads.size() : 0;
+    }
+
+    /**
+     * @return One less than the number of hardware threads, leaving one for the main thread
+     */
+    [[nodiscard]] static std::size_t default_thread_count() noexcept;
+
+private:
+
+    struct State
+    {
+        ~State();
+
+        void run_worker();
+
+        std::mutex                  mutex;
+        std::condition_variable     jobReady;
+        std::deque<Job_t>           jobs;
+        std::vector<std::thread>    threads;
+        bool                        stop{false};
+    };
+
+    // Kept on the heap so worker threads have a stable address to refer to
+    std::shared_ptr<State> m_pState;
+};
+
+} // namespace osp
@@ -61,6 +61,12 @@ using osp::draw::RenderGL;
 
 using osp::draw::TexGlId;
 using osp::draw::MeshGlId;
+using osp::draw::DrawEnt;
+using osp::draw::EntityToDraw;
+using osp::draw::MeshId;
+using osp::draw::TexId;
+using osp::draw::ViewProjMatrix;
+using osp::ArrayView;
 
 void SysRenderGL::setup_context(RenderGL& rCtxGl)
 {
@@ -343,8 +349,7 @@ void SysRenderGL::clear_resource_owners(RenderGL& rRenderGl, Resources& rResourc
 }
 
 void SysRenderGL::render_opaque(
-        RenderGroup const& group,
-        DrawEntSet_t const& visible,
+        DrawCommandBuffer const& buffer,
         ViewProjMatrix const& viewProj)
 {
     using Magnum::GL::Renderer;
@@ -354,12 +359,11 @@ void SysRenderGL::render_opaque(
     Renderer::disable(Renderer::Feature::Blending);
     Renderer::setDepthMask(GL_TRUE);
 
-    draw_group(group, visible, viewProj);
+    submit(buffer, viewProj);
 }
 
 void SysRenderGL::render_transparent(
-        RenderGroup const& group,
-        DrawEntSet_t const& visible,
+        DrawCommandBuffer const& buffer,
         ViewProjMatrix const& viewProj)
 {
     using Magnum::GL::Renderer;
@@ -375,19 +379,51 @@ void SysRenderGL::render_transparent(
     //            can mess up other transparent objects once added
     //Renderer::setDepthMask(GL_FALSE);
 
-    draw_group(group, visible, viewProj);
+    submit(buffer, viewProj);
 }
 
-void SysRenderGL::draw_group(
-        RenderGroup const& group,
-        DrawEntSet_t const& visible,
-        ViewProjMatrix const& viewProj)
+namespace
+{
+
+/**
+ * @brief DrawCommandBuffer backend that calls shader draw functions
+ *
+ * Shader draw functions bind their own meshes and textures, so bind commands are only used to
+ * pick the draw function. Magnum's GL state tracker skips binds that don't change anything.
+ */
+struct GLDrawBackend
 {
-    for (auto const& [ent, toDraw] : entt::basic_view{group.entities}.each())
+    void bind_shader(EntityToDraw const& shader) noexcept   { pShader = &shader; }
+    void bind_mesh(MeshId) noexcept                         { }
+    void bind_texture(TexId) noexcept                       { }
+
+    void draw(ArrayView<DrawEnt const> const ents) noexcept
     {
-        if (visible.contains(ent))
+        LGRN_ASSERTM(pShader != nullptr, "Draw command recorded before any shader was bound");
+
+        if (pShader->drawBatch != nullptr)
         {
-            toDraw.draw(ent, viewProj, toDraw.data);
+            pShader->drawBatch(ents, viewProj, pShader->data);
+        }
+        else
+        {
+            for (DrawEnt const ent : ents)
+            {
+                pShader->draw(ent, viewProj, pShader->data);
+            }
         }
     }
+
+    ViewProjMatrix const    &viewProj;
+    EntityToDraw const      *pShader{nullptr};
+};
+
+} // namespace
+
+void SysRenderGL::submit(
+        DrawCommandBuffer const& buffer,
+        ViewProjMatrix const& viewProj)
+{
+    GLDrawBackend backend{.viewProj = viewProj};
+    SysDrawCommands::submit(buffer, backend);
 }
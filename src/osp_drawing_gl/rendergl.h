@@ -28,6 +28,7 @@
 
 #include <osp/core/strong_id.h>
 #include <osp/drawing/drawing_fn.h>
+#include <osp/drawing/draw_commands.h>
 
 #include <Magnum/GL/Mesh.h>
 #include <Magnum/GL/Texture.h>
@@ -222,34 +223,31 @@ public:
     }
 
     /**
-     * @brief Call draw functions of a RenderGroup of opaque objects
+     * @brief Submit a DrawCommandBuffer of opaque objects
      *
-     * @param group     [in] RenderGroup to draw
-     * @param visible   [in] Storage for visible components
+     * @param buffer    [in] Commands recorded from a RenderQueue built with ERenderPass::Opaque
      * @param viewProj  [in] View and projection matrix
      */
     static void render_opaque(
-            RenderGroup const& group,
-            DrawEntSet_t const& visible,
+            DrawCommandBuffer const& buffer,
             ViewProjMatrix const& viewProj);
 
     /**
-     * @brief Call draw functions of a RenderGroup of transparent objects
+     * @brief Submit a DrawCommandBuffer of transparent objects
      *
-     * Consider sorting the render group for correct transparency
-     *
-     * @param group     [in] RenderGroup to draw
-     * @param visible   [in] Storage for visible components
+     * @param buffer    [in] Commands recorded from a RenderQueue built with
+     *                       ERenderPass::Transparent, sorted back-to-front
      * @param viewProj  [in] View and projection matrix
      */
     static void render_transparent(
-            RenderGroup const& group,
-            DrawEntSet_t const& visible,
+            DrawCommandBuffer const& buffer,
             ViewProjMatrix const& viewProj);
 
-    static void draw_group(
-            RenderGroup const& group,
-            DrawEntSet_t const& visible,
+    /**
+     * @brief Call shader draw functions for each draw command, must be called on the GL thread
+     */
+    static void submit(
+            DrawCommandBuffer const& buffer,
             ViewProjMatrix const& viewProj);
 
 };
@@ -25,8 +25,11 @@
 #pragma once
 
 #include "forcefactors.h"
+#include "joltjobsystem.h"
 
 #include <osp/activescene/basic.h>
+#include <osp/activescene/physics.h>
+#include <osp/core/array_view.h>
 #include <osp/core/id_map.h>
 
 
@@ -37,7 +40,6 @@ JPH_SUPPRESS_WARNINGS
 
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
@@ -48,6 +50,8 @@ JPH_SUPPRESS_WARNINGS
 #include <Jolt/Physics/Collision/Shape/CompoundShape.h>
 #include <Jolt/Physics/Collision/Shape/ScaledShape.h>
 #include <Jolt/Physics/Collision/Shape/MutableCompoundShape.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
 #include <Jolt/Physics/PhysicsStepListener.h>
 
 JPH_SUPPRESS_WARNING_POP
@@ -59,6 +63,8 @@ JPH_SUPPRESS_WARNING_POP
 
 #include <spdlog/spdlog.h>
 
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <cstdarg>
 #include <osp/util/logging.h>
@@ -127,42 +133,117 @@ static void TraceImpl(const char *inFMT, ...)
 
 
 /**
- * @brief The different physics layers for the simulation
+ * @brief Default object layers, see JoltLayerConfig::make_default
  */
 namespace Layers
 {
-    static constexpr ObjectLayer NON_MOVING = 0;
-    static constexpr ObjectLayer MOVING = 1;
-    static constexpr ObjectLayer NUM_LAYERS = 2;
+    static constexpr ObjectLayer NON_MOVING = 0; ///< Static bodies, such as terrain
+    static constexpr ObjectLayer MOVING     = 1; ///< Dynamic bodies, such as vehicles
+    static constexpr ObjectLayer DEBRIS     = 2; ///< Small dynamic bodies that don't collide with each other
+    static constexpr ObjectLayer NUM_LAYERS = 3;
 };
+
 /**
- * @brief Class that determines if two object layers can collide
+ * @brief Default broadphase layers, each is a separate broadphase tree
  */
-class ObjectLayerPairFilterImpl : public ObjectLayerPairFilter
+namespace BroadPhaseLayers
 {
-public:
-    bool ShouldCollide(ObjectLayer inObject1, ObjectLayer inObject2) const override
+    static constexpr BroadPhaseLayer NON_MOVING(0);
+    static constexpr BroadPhaseLayer MOVING(1);
+    static constexpr BroadPhaseLayer DEBRIS(2);
+    static constexpr uint NUM_LAYERS(3);
+};
+
+/**
+ * @brief Which object layers collide with each other, and which broadphase tree each belongs to
+ *
+ * Every broadphase layer is a separate tree. Keeping static bodies apart from dynamic ones means
+ * the static tree rarely needs rebuilding, and layers that never collide are never queried
+ * against each other.
+ */
+struct JoltLayerConfig
+{
+    static constexpr ObjectLayer    smc_maxObjectLayers     = 16;
+    static constexpr uint           smc_maxBroadPhaseLayers = 8;
+
+    /**
+     * @brief Enable or disable collisions between two object layers, in both directions
+     */
+    constexpr void set_collides(ObjectLayer const a, ObjectLayer const b, bool const collide) noexcept
     {
-        switch (inObject1)
+        if (collide)
+        {
+            collisionMatrix[a] |=  std::uint16_t(1u << b);
+            collisionMatrix[b] |=  std::uint16_t(1u << a);
+        }
+        else
         {
-        case Layers::NON_MOVING:
-            return inObject2 == Layers::MOVING; // Non moving only collides with moving
-        case Layers::MOVING:
-            return true; // Moving collides with everything
-        default:
-            JPH_ASSERT(false);
-            return false;
+            collisionMatrix[a] &= ~std::uint16_t(1u << b);
+            collisionMatrix[b] &= ~std::uint16_t(1u << a);
         }
     }
+
+    [[nodiscard]] constexpr bool collides(ObjectLayer const a, ObjectLayer const b) const noexcept
+    {
+        return (collisionMatrix[a] & (1u << b)) != 0;
+    }
+
+    /**
+     * @brief Static terrain, vehicles and debris on separate broadphase trees. Static bodies
+     *        don't collide with each other, and neither does debris.
+     */
+    [[nodiscard]] static JoltLayerConfig make_default() noexcept
+    {
+        JoltLayerConfig out;
+        out.objectLayerCount        = Layers::NUM_LAYERS;
+        out.broadPhaseLayerCount    = BroadPhaseLayers::NUM_LAYERS;
+
+        out.objectToBroadPhase[Layers::NON_MOVING]  = BroadPhaseLayers::NON_MOVING;
+        out.objectToBroadPhase[Layers::MOVING]      = BroadPhaseLayers::MOVING;
+        out.objectToBroadPhase[Layers::DEBRIS]      = BroadPhaseLayers::DEBRIS;
+
+        out.broadPhaseNames[BroadPhaseLayers::NON_MOVING.GetValue()]    = "NON_MOVING";
+        out.broadPhaseNames[BroadPhaseLayers::MOVING.GetValue()]        = "MOVING";
+        out.broadPhaseNames[BroadPhaseLayers::DEBRIS.GetValue()]        = "DEBRIS";
+
+        out.set_collides(Layers::NON_MOVING,    Layers::MOVING, true);
+        out.set_collides(Layers::NON_MOVING,    Layers::DEBRIS, true);
+        out.set_collides(Layers::MOVING,        Layers::MOVING, true);
+        out.set_collides(Layers::MOVING,        Layers::DEBRIS, true);
+        return out;
+    }
+
+    ObjectLayer                                             objectLayerCount        {0};
+    uint                                                    broadPhaseLayerCount    {0};
+
+    std::array<BroadPhaseLayer, smc_maxObjectLayers>        objectToBroadPhase      {};
+
+    /// Bit B of row A is set if object layers A and B collide. Kept symmetric by set_collides.
+    std::array<std::uint16_t, smc_maxObjectLayers>          collisionMatrix         {};
+
+    std::array<char const*, smc_maxBroadPhaseLayers>        broadPhaseNames         {};
 };
+
 /**
- * @brief The different broad phase layers (currently identical to physics Layers, but might change in the future)
+ * @brief Class that determines if two object layers can collide
  */
-namespace BroadPhaseLayers
+class ObjectLayerPairFilterImpl : public ObjectLayerPairFilter
 {
-    static constexpr BroadPhaseLayer NON_MOVING(0);
-    static constexpr BroadPhaseLayer MOVING(1);
-    static constexpr uint NUM_LAYERS(2);
+public:
+    ObjectLayerPairFilterImpl(JoltLayerConfig const& config)
+     : m_collisionMatrix{config.collisionMatrix}
+     , m_layerCount{config.objectLayerCount}
+    { }
+
+    bool ShouldCollide(ObjectLayer inObject1, ObjectLayer inObject2) const override
+    {
+        JPH_ASSERT(inObject1 < m_layerCount && inObject2 < m_layerCount);
+        return (m_collisionMatrix[inObject1] & (1u << inObject2)) != 0;
+    }
+
+private:
+    std::array<std::uint16_t, JoltLayerConfig::smc_maxObjectLayers> m_collisionMatrix;
+    ObjectLayer m_layerCount;
 };
 
 /**
@@ -171,59 +252,74 @@ namespace BroadPhaseLayers
 class BPLayerInterfaceImpl final : public BroadPhaseLayerInterface
 {
 public:
-    BPLayerInterfaceImpl()
+    BPLayerInterfaceImpl(JoltLayerConfig const& config)
+     : m_objectToBroadPhase{config.objectToBroadPhase}
+     , m_broadPhaseNames{config.broadPhaseNames}
+     , m_objectLayerCount{config.objectLayerCount}
+     , m_broadPhaseLayerCount{config.broadPhaseLayerCount}
     {
-        // Create a mapping table from object to broad phase layer
-        mObjectToBroadPhase[Layers::NON_MOVING] = BroadPhaseLayers::NON_MOVING;
-        mObjectToBroadPhase[Layers::MOVING] = BroadPhaseLayers::MOVING;
+        JPH_ASSERT(m_objectLayerCount <= JoltLayerConfig::smc_maxObjectLayers);
+        JPH_ASSERT(m_broadPhaseLayerCount <= JoltLayerConfig::smc_maxBroadPhaseLayers);
     }
 
     uint GetNumBroadPhaseLayers() const override
     {
-        return BroadPhaseLayers::NUM_LAYERS;
+        return m_broadPhaseLayerCount;
     }
 
     BroadPhaseLayer GetBroadPhaseLayer(ObjectLayer inLayer) const override
     {
-        JPH_ASSERT(inLayer < Layers::NUM_LAYERS);
-        return mObjectToBroadPhase[inLayer];
+        JPH_ASSERT(inLayer < m_objectLayerCount);
+        return m_objectToBroadPhase[inLayer];
     }
 
 #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
     /// Get the user readable name of a broadphase layer (debugging purposes)
     const char * GetBroadPhaseLayerName(BroadPhaseLayer inLayer) const override
     {
-        if (inLayer == BroadPhaseLayers::NON_MOVING) {
-            return "NON_MOVING";
-        }
-        else {
-            return "MOVING";
-        }
+        char const* name = m_broadPhaseNames[inLayer.GetValue()];
+        return (name != nullptr) ? name : "UNNAMED";
     }
 #endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
 
 private:
-    BroadPhaseLayer					mObjectToBroadPhase[Layers::NUM_LAYERS];
+    std::array<BroadPhaseLayer, JoltLayerConfig::smc_maxObjectLayers>   m_objectToBroadPhase;
+    std::array<char const*, JoltLayerConfig::smc_maxBroadPhaseLayers>   m_broadPhaseNames;
+    ObjectLayer                                                         m_objectLayerCount;
+    uint                                                                m_broadPhaseLayerCount;
 };
+
 /**
  * @brief Class that determines if an object layer can collide with a broadphase layer
+ *
+ * An object layer collides with a broadphase layer if it collides with any object layer in it.
  */
 class ObjectVsBroadPhaseLayerFilterImpl : public ObjectVsBroadPhaseLayerFilter
 {
 public:
-    bool ShouldCollide(ObjectLayer inLayer1, BroadPhaseLayer inLayer2) const override
+    ObjectVsBroadPhaseLayerFilterImpl(JoltLayerConfig const& config)
     {
-        switch (inLayer1)
+        for (ObjectLayer a = 0; a < config.objectLayerCount; ++a)
         {
-        case Layers::NON_MOVING:
-            return inLayer2 == BroadPhaseLayers::MOVING;
-        case Layers::MOVING:
-            return true;
-        default:
-            JPH_ASSERT(false);
-            return false;
+            for (ObjectLayer b = 0; b < config.objectLayerCount; ++b)
+            {
+                if (config.collides(a, b))
+                {
+                    m_collidesWithBroadPhase[a] |= std::uint8_t(1u << config.objectToBroadPhase[b].GetValue());
+                }
+            }
         }
     }
+
+    bool ShouldCollide(ObjectLayer inLayer1, BroadPhaseLayer inLayer2) const override
+    {
+        JPH_ASSERT(inLayer1 < JoltLayerConfig::smc_maxObjectLayers);
+        return (m_collidesWithBroadPhase[inLayer1] & (1u << inLayer2.GetValue())) != 0;
+    }
+
+private:
+    /// Bit B of row A is set if object layer A collides with anything in broadphase layer B
+    std::array<std::uint8_t, JoltLayerConfig::smc_maxObjectLayers> m_collidesWithBroadPhase{};
 };
 
 struct ACtxJoltWorld;
@@ -241,6 +337,37 @@ private:
 
 using ShapeStorage_t = osp::Storage_t<osp::active::ActiveEnt, Ref<Shape>>;
 
+/**
+ * @brief Active dynamic bodies that a force factor applies to, as parallel arrays
+ *
+ * Force factors add to forces and torques. These are summed over all factors then applied to the
+ * bodies once per step.
+ */
+struct ForceFactorBatch
+{
+    osp::ArrayView<BodyId const>    bodies;
+    osp::ArrayView<float const>     invMass;
+    osp::ArrayView<osp::Vector3>    forces;
+    osp::ArrayView<osp::Vector3>    torques;
+};
+
+/**
+ * @brief Saved bodies and simulation state of an ACtxJoltWorld
+ *
+ * See SysJolt::save_snapshot and SysJolt::restore_snapshot
+ */
+struct JoltSnapshot
+{
+    /// Per-body records (IDs, entity, force factors, creation settings), followed by Jolt's own
+    /// simulation state (positions, velocities, sleep timers, contact cache). Written through
+    /// Jolt's binary streams.
+    std::string                     data;
+
+    /// Shapes are shared with the live bodies instead of serialized. Records refer to these by
+    /// index.
+    std::vector<RefConst<Shape>>    shapes;
+};
+
 /**
  * @brief Represents an instance of a Jolt physics world in the scene
  */
@@ -249,21 +376,49 @@ struct ACtxJoltWorld
 public:
     struct ForceFactorFunc
     {
-        using Func_t = void (*)(BodyId bodyId, ACtxJoltWorld const&, entt::any, osp::Vector3&, osp::Vector3&) noexcept;
+        /// Called once per step with all active bodies that have this factor
+        using Func_t = void (*)(ForceFactorBatch const& batch, ACtxJoltWorld const&, entt::any const&) noexcept;
 
         Func_t      m_func{nullptr};
         entt::any   m_userData;
     };
+
+    /**
+     * @brief Temporary per-step data for PhysicsStepListenerImpl, kept to reuse allocations
+     */
+    struct StepBatch
+    {
+        BodyIDVector                    active;
+
+        // Active dynamic bodies, parallel
+        std::vector<BodyId>             bodies;
+        std::vector<float>              invMass;
+        std::vector<ForceFactors_t>     factors;
+        std::vector<osp::Vector3>       forces;
+        std::vector<osp::Vector3>       torques;
+
+        // Subset of the above with a single factor, gathered contiguously into a ForceFactorBatch
+        std::vector<std::uint32_t>      factorIndices;
+        std::vector<BodyId>             factorBodies;
+        std::vector<float>              factorInvMass;
+        std::vector<osp::Vector3>       factorForces;
+        std::vector<osp::Vector3>       factorTorques;
+    };
     // The default values are the one suggested in the Jolt hello world exemple for a "real" project.
     // It might be overkill here.
-    ACtxJoltWorld(  int threadCount = 2,
+    // Jolt jobs run on the given (usually process-wide) worker pool instead of threads of its own.
+    ACtxJoltWorld(  osp::WorkerPool workers = {},
+                    JoltLayerConfig const& layers = JoltLayerConfig::make_default(),
                     uint maxBodies = 65536, 
                     uint numBodyMutexes = 0, 
                     uint maxBodyPairs = 65536, 
                     uint maxContactConstraints = 10240
                 ) : m_pPhysicsSystem(std::make_unique<PhysicsSystem>()), 
                     m_temp_allocator(10 * 1024 * 1024),
-                    m_joltJobSystem(std::make_unique<JobSystemThreadPool>(cMaxPhysicsJobs, cMaxPhysicsBarriers, threadCount))
+                    m_objectLayerFilter(layers),
+                    m_bPLInterface(layers),
+                    m_objectVsBPLFilter(layers),
+                    m_joltJobSystem(std::make_unique<JobSystemOsp>(std::move(workers), cMaxPhysicsJobs, cMaxPhysicsBarriers))
     {
         m_pPhysicsSystem->Init(maxBodies, 
                     numBodyMutexes, 
@@ -307,7 +462,25 @@ public:
     std::vector<ForceFactorFunc>                        m_factors;
     ShapeStorage_t                                      m_shapes;
 
+    /// Primitive shapes shared between bodies, keyed by osp::shape_cache_key
+    osp::IdMap_t<osp::ShapeCacheKey, Ref<Shape>>        m_primitiveCache;
+
+    struct CachedCompound
+    {
+        std::vector<osp::active::CompoundLeaf>  leaves;
+        Ref<Shape>                              shape;
+    };
+
+    /// Compound shapes shared between bodies with identical leaves (eg. copies of the same
+    /// vehicle), keyed by SysPhysics::hash_compound
+    osp::IdMap_t<std::uint64_t, CachedCompound>         m_compoundCache;
+    std::vector<JPH::BodyID>                            m_addBodiesTemp;
+
+    StepBatch                                           m_stepBatch;
+
     osp::active::ACompTransformStorage_t                *m_pTransform{nullptr};
+    osp::active::ActiveEntSet_t                         *m_pTransformDirty{nullptr};
+    osp::active::ACtxPhysInterp                         *m_pInterp{nullptr};
 
 private:
 
@@ -25,7 +25,13 @@
 
 #include "joltinteg_fn.h"          // IWYU pragma: associated
 #include <osp/activescene/basic_fn.h>
+#include <osp/activescene/physics_fn.h>
 
+#include <Jolt/Physics/StateRecorderImpl.h>
+
+#include <longeron/utility/asserts.hpp>
+
+#include <algorithm>                 // for std::sort
 #include <utility>                   // for std::exchange
 #include <cassert>                   // for assert
 
@@ -41,6 +47,7 @@ using osp::EShape;
 
 using osp::active::ActiveEnt;
 using osp::active::ACtxPhysics;
+using osp::active::ACtxPhysInterp;
 using osp::active::SysSceneGraph;
 
 using osp::Matrix3;
@@ -50,31 +57,102 @@ using osp::Vector3;
 void SysJolt::resize_body_data(ACtxJoltWorld& rCtxWorld)
 {
     std::size_t const capacity = rCtxWorld.m_bodyIds.capacity();
+    rCtxWorld.m_bodyFactors .reserve(capacity);
+    rCtxWorld.m_bodyToEnt   .reserve(capacity);
+    rCtxWorld.m_entToBody   .reserve(capacity);
 }
 
 
-void SysJolt::update_translate(ACtxPhysics& rCtxPhys, ACtxJoltWorld& rCtxWorld) noexcept
+void SysJolt::update_translate(
+        ACtxPhysics&                rCtxPhys,
+        ACtxJoltWorld&              rCtxWorld,
+        ACompTransformStorage_t&    rTf,
+        ActiveEntSet_t&             rTfDirty) noexcept
 {
+    Vector3 const translate = std::exchange(rCtxPhys.m_originTranslate, {});
+    if (translate.isZero())
+    {
+        return;
+    }
+
+    // Moving bodies one at a time through BodyInterface takes a lock and updates the broadphase
+    // for each. Instead, take every body out of the broadphase at once, move them without
+    // locking, then add them back, which builds a new broadphase tree per layer. This runs
+    // between world updates on the thread that owns the world, so no locks are needed.
 
-    // Origin translation
-    if (Vector3 const translate = std::exchange(rCtxPhys.m_originTranslate, {});
-        ! translate.isZero())
+    struct ActiveBody
+    {
+        JPH::BodyID id;
+        Vec3        linearVelocity;
+        Vec3        angularVelocity;
+    };
+
+    PhysicsSystem                   &rPhysicsSystem = *rCtxWorld.m_pPhysicsSystem;
+    BodyLockInterfaceNoLock const   &lockInterface  = rPhysicsSystem.GetBodyLockInterfaceNoLock();
+    BodyInterface                   &rBodyInterface = rPhysicsSystem.GetBodyInterfaceNoLock();
+
+    std::vector<BodyId>         activeBodies;
+    std::vector<BodyId>         sleepingBodies;
+    std::vector<ActiveBody>     activeVelocities;
+    std::vector<JPH::BodyID>    toRemove;
+    toRemove.reserve(rCtxWorld.m_bodyToEnt.size());
+
+    for ([[maybe_unused]] auto const& [bodyId, ent] : rCtxWorld.m_bodyToEnt)
     {
-        PhysicsSystem* pJoltWorld = rCtxWorld.m_pPhysicsSystem.get();
-        BodyIDVector allBodiesIds;
-        pJoltWorld->GetBodies(allBodiesIds);
+        BodyLockRead lock(lockInterface, BToJolt(bodyId));
+        if ( ! lock.Succeeded() || ! lock.GetBody().IsInBroadPhase() )
+        {
+            continue;
+        }
 
-        BodyInterface &bodyInterface = pJoltWorld->GetBodyInterface();
+        Body const &body = lock.GetBody();
+        toRemove.push_back(body.GetID());
 
-        // Translate every jolt body
-        for (BodyID bodyId : allBodiesIds)
+        // Removing from the broadphase deactivates bodies and clears their velocity. Keep both,
+        // so the shift doesn't wake sleeping bodies or stop moving ones.
+        if (body.IsActive())
+        {
+            activeBodies.push_back(bodyId);
+            activeVelocities.push_back({body.GetID(), body.GetLinearVelocity(), body.GetAngularVelocity()});
+        }
+        else
+        {
+            sleepingBodies.push_back(bodyId);
+        }
+    }
+
+    if ( ! toRemove.empty() )
+    {
+        rBodyInterface.RemoveBodies(toRemove.data(), static_cast<int>(toRemove.size()));
+    }
+
+    Vec3 const translateJolt = Vec3MagnumToJolt(translate);
+    for (auto const& [bodyId, ent] : rCtxWorld.m_bodyToEnt)
+    {
+        BodyLockWrite lock(lockInterface, BToJolt(bodyId));
+        if (lock.Succeeded())
         {
-            RVec3 position = bodyInterface.GetPosition(bodyId);
-            Matrix4 matrix;
-            position += Vec3MagnumToJolt(translate);
-            //As we are translating the whole world, we don't need to wake up asleep bodies. 
-            bodyInterface.SetPosition(bodyId, position, EActivation::DontActivate);
+            Body &rBody = lock.GetBody();
+            rBody.SetPositionAndRotationInternal(rBody.GetPosition() + translateJolt, rBody.GetRotation());
         }
+
+        // update_world only writes transforms of bodies that moved during a step. Sleeping
+        // bodies, and all bodies on frames without a step, must be shifted here.
+        rTf.get(ent).m_transform.translation() += translate;
+        rTfDirty.insert(ent);
+    }
+
+    add_bodies(rCtxWorld, osp::arrayView(std::as_const(activeBodies)),   EActivation::Activate);
+    add_bodies(rCtxWorld, osp::arrayView(std::as_const(sleepingBodies)), EActivation::DontActivate);
+
+    for (ActiveBody const& body : activeVelocities)
+    {
+        rBodyInterface.SetLinearAndAngularVelocity(body.id, body.linearVelocity, body.angularVelocity);
+    }
+
+    if (rCtxWorld.m_pInterp != nullptr)
+    {
+        osp::active::SysPhysics::interp_translate(*rCtxWorld.m_pInterp, translate);
     }
 }
 
@@ -84,8 +162,16 @@ void SysJolt::update_world(
         ACtxPhysics&                rCtxPhys,
         ACtxJoltWorld&              rCtxWorld,
         float                       timestep,
-        ACompTransformStorage_t&    rTf) noexcept
+        int                         substeps,
+        ACompTransformStorage_t&    rTf,
+        ActiveEntSet_t&             rTfDirty,
+        ACtxPhysInterp*             pInterp) noexcept
 {
+    if (substeps <= 0)
+    {
+        return;
+    }
+
     PhysicsSystem *pJoltWorld = rCtxWorld.m_pPhysicsSystem.get();
     BodyInterface &bodyInterface = pJoltWorld->GetBodyInterface();
 
@@ -97,28 +183,219 @@ void SysJolt::update_world(
         bodyInterface.SetLinearVelocity(bodyId, Vec3MagnumToJolt(vel));
     }
 
-    rCtxWorld.m_pTransform = std::addressof(rTf);
+    rCtxWorld.m_pTransform      = std::addressof(rTf);
+    rCtxWorld.m_pTransformDirty = std::addressof(rTfDirty);
+    rCtxWorld.m_pInterp         = pInterp;
 
-    int collisionSteps = 1;
-    pJoltWorld->Update(timestep, collisionSteps, &rCtxWorld.m_temp_allocator, rCtxWorld.m_joltJobSystem.get());
+    // Jolt divides the time evenly between collision steps, and calls the step listener for each
+    pJoltWorld->Update(timestep * float(substeps), substeps, &rCtxWorld.m_temp_allocator, rCtxWorld.m_joltJobSystem.get());
 }
 
 void SysJolt::remove_components(ACtxJoltWorld& rCtxWorld, ActiveEnt ent) noexcept
 {
-    auto itBodyId = rCtxWorld.m_entToBody.find(ent);
-    BodyInterface &bodyInterface = rCtxWorld.m_pPhysicsSystem->GetBodyInterface();
+    JPH::BodyID const joltBodyId = release_body(rCtxWorld, ent);
 
-    if (itBodyId != rCtxWorld.m_entToBody.end())
+    if ( ! joltBodyId.IsInvalid() )
     {
-        BodyId const bodyId = itBodyId->second;
-        JPH::BodyID joltBodyId = BToJolt(bodyId);
+        BodyInterface &bodyInterface = rCtxWorld.m_pPhysicsSystem->GetBodyInterface();
         bodyInterface.RemoveBody(joltBodyId);
         bodyInterface.DestroyBody(joltBodyId);
-        rCtxWorld.m_bodyIds.remove(bodyId);
-        rCtxWorld.m_bodyToEnt[bodyId] = lgrn::id_null<ActiveEnt>();
-        rCtxWorld.m_entToBody.erase(itBodyId);
     }
+}
+
+JPH::BodyID SysJolt::release_body(ACtxJoltWorld& rCtxWorld, ActiveEnt ent) noexcept
+{
+    auto itBodyId = rCtxWorld.m_entToBody.find(ent);
+
+    if (itBodyId == rCtxWorld.m_entToBody.end())
+    {
+        return {};
+    }
+
+    BodyId const bodyId = itBodyId->second;
+    rCtxWorld.m_bodyIds.remove(bodyId);
+    rCtxWorld.m_bodyToEnt[bodyId] = lgrn::id_null<ActiveEnt>();
+    rCtxWorld.m_entToBody.erase(itBodyId);
+    return BToJolt(bodyId);
+}
+
+void SysJolt::destroy_bodies(ACtxJoltWorld& rCtxWorld, std::vector<JPH::BodyID>& rBodies) noexcept
+{
+    if (rBodies.empty())
+    {
+        return;
+    }
+
+    BodyInterface &bodyInterface = rCtxWorld.m_pPhysicsSystem->GetBodyInterface();
+    bodyInterface.RemoveBodies(rBodies.data(), int(rBodies.size()));
+    bodyInterface.DestroyBodies(rBodies.data(), int(rBodies.size()));
+}
+
+void SysJolt::save_snapshot(ACtxJoltWorld const& rCtxWorld, JoltSnapshot& rOut)
+{
+    PhysicsSystem const &rPhysicsSystem = *rCtxWorld.m_pPhysicsSystem;
+
+    // Sorted so the registry can recreate the same IDs in order
+    std::vector<BodyId> bodies;
+    bodies.reserve(rCtxWorld.m_bodyToEnt.size());
+    for (auto const& [bodyId, ent] : rCtxWorld.m_bodyToEnt)
+    {
+        bodies.push_back(bodyId);
+    }
+    std::sort(bodies.begin(), bodies.end());
+
+    rOut.shapes.clear();
+    osp::IdMap_t<Shape const*, std::uint32_t> shapeToIndex;
+
+    StateRecorderImpl recorder;
+    recorder.Write(std::uint32_t(bodies.size()));
+
+    for (BodyId const bodyId : bodies)
+    {
+        BodyLockRead lock(rPhysicsSystem.GetBodyLockInterface(), BToJolt(bodyId));
+        LGRN_ASSERTM(lock.Succeeded(), "Body in m_bodyToEnt does not exist in Jolt");
+        Body const &body = lock.GetBody();
+
+        BodyCreationSettings const settings = body.GetBodyCreationSettings();
+
+        auto const [itShape, isNew] = shapeToIndex.emplace(settings.GetShape(), std::uint32_t(rOut.shapes.size()));
+        if (isNew)
+        {
+            rOut.shapes.emplace_back(settings.GetShape());
+        }
+
+        recorder.Write(bodyId.value);
+        recorder.Write(rCtxWorld.m_bodyToEnt.at(bodyId).value);
+        recorder.Write(std::uint64_t(rCtxWorld.m_bodyFactors.at(bodyId).to_ullong()));
+        recorder.Write(itShape->second);
+        recorder.Write(body.IsActive());
+        settings.SaveBinaryState(recorder);
+    }
+
+    rPhysicsSystem.SaveState(recorder);
 
+    rOut.data = recorder.GetData();
+}
+
+bool SysJolt::restore_snapshot(
+        ACtxJoltWorld&              rCtxWorld,
+        JoltSnapshot const&         snapshot,
+        ACompTransformStorage_t&    rTf,
+        ActiveEntSet_t&             rTfDirty)
+{
+    PhysicsSystem &rPhysicsSystem = *rCtxWorld.m_pPhysicsSystem;
+    BodyInterface &rBodyInterface = rPhysicsSystem.GetBodyInterface();
+
+    // Snapshots only hold bodies with an ActiveEnt. Bodies managed elsewhere, such as terrain
+    // colliders, can't be destroyed here without their owner knowing, and would keep their IDs.
+    if (rCtxWorld.m_bodyIds.size() != rCtxWorld.m_bodyToEnt.size())
+    {
+        return false;
+    }
+
+    // Destroy all existing bodies
+    std::vector<JPH::BodyID> oldBodies;
+    oldBodies.reserve(rCtxWorld.m_bodyToEnt.size());
+    for (auto const& [bodyId, ent] : rCtxWorld.m_bodyToEnt)
+    {
+        oldBodies.push_back(BToJolt(bodyId));
+    }
+    destroy_bodies(rCtxWorld, oldBodies);
+
+    rCtxWorld.m_bodyIds     = lgrn::IdRegistryStl<BodyId>{};
+    rCtxWorld.m_bodyToEnt   .clear();
+    rCtxWorld.m_entToBody   .clear();
+    rCtxWorld.m_bodyFactors .clear();
+    rCtxWorld.m_bodyDirty   .clear();
+
+    StateRecorderImpl recorder;
+    recorder.WriteBytes(snapshot.data.data(), snapshot.data.size());
+    recorder.Rewind();
+
+    std::uint32_t bodyCount = 0;
+    recorder.Read(bodyCount);
+
+    std::vector<BodyId> activeBodies;
+    std::vector<BodyId> sleepingBodies;
+    std::vector<BodyId> unusedIds;
+
+    // On failure, bodies restored so far are kept and stay consistent with m_bodyIds
+    bool failed = false;
+
+    for (std::uint32_t i = 0; i < bodyCount; ++i)
+    {
+        std::uint32_t   bodyInt     = 0;
+        std::uint32_t   entInt      = 0;
+        std::uint64_t   factors     = 0;
+        std::uint32_t   shapeIndex  = 0;
+        bool            active      = false;
+        BodyCreationSettings settings;
+
+        recorder.Read(bodyInt);
+        recorder.Read(entInt);
+        recorder.Read(factors);
+        recorder.Read(shapeIndex);
+        recorder.Read(active);
+        settings.RestoreBinaryState(recorder);
+
+        if (recorder.IsFailed() || shapeIndex >= snapshot.shapes.size())
+        {
+            failed = true;
+            break;
+        }
+
+        settings.SetShape(snapshot.shapes[shapeIndex]);
+
+        // The registry hands out the lowest free ID, and records are sorted by ID. Create IDs up
+        // to the saved one, then free the ones in between.
+        BodyId const bodyId{bodyInt};
+        for (BodyId created = rCtxWorld.m_bodyIds.create(); created != bodyId; created = rCtxWorld.m_bodyIds.create())
+        {
+            LGRN_ASSERTM(created.value < bodyId.value, "Snapshot bodies must be sorted by ID");
+            unusedIds.push_back(created);
+        }
+
+        // Fails if Jolt runs out of bodies
+        if (rBodyInterface.CreateBodyWithID(BToJolt(bodyId), settings) == nullptr)
+        {
+            unusedIds.push_back(bodyId);
+            failed = true;
+            break;
+        }
+
+        ActiveEnt const ent{entInt};
+        rCtxWorld.m_bodyToEnt[bodyId]   = ent;
+        rCtxWorld.m_bodyFactors[bodyId] = ForceFactors_t{factors};
+        rCtxWorld.m_entToBody.emplace(ent, bodyId);
+
+        (active ? activeBodies : sleepingBodies).push_back(bodyId);
+    }
+
+    for (BodyId const unused : unusedIds)
+    {
+        rCtxWorld.m_bodyIds.remove(unused);
+    }
+    resize_body_data(rCtxWorld);
+
+    add_bodies(rCtxWorld, osp::arrayView(std::as_const(activeBodies)),   EActivation::Activate);
+    add_bodies(rCtxWorld, osp::arrayView(std::as_const(sleepingBodies)), EActivation::DontActivate);
+
+    if ( failed || ! rPhysicsSystem.RestoreState(recorder) )
+    {
+        return false;
+    }
+
+    for (auto const& [bodyId, ent] : rCtxWorld.m_bodyToEnt)
+    {
+        if (rTf.contains(ent))
+        {
+            Mat44 const worldTransform = rBodyInterface.GetWorldTransform(BToJolt(bodyId));
+            worldTransform.StoreFloat4x4((Float4*)rTf.get(ent).m_transform.data());
+            rTfDirty.insert(ent);
+        }
+    }
+
+    return true;
 }
 
 Ref<Shape> SysJolt::create_primitive(ACtxJoltWorld &rCtxWorld, osp::EShape shape, Vec3Arg scale)
@@ -143,6 +420,94 @@ Ref<Shape> SysJolt::create_primitive(ACtxJoltWorld &rCtxWorld, osp::EShape shape
     }
 }
 
+Ref<Shape> SysJolt::get_primitive(ACtxJoltWorld &rCtxWorld, osp::EShape shape, Vector3 scale)
+{
+    osp::ShapeCacheKey const key = osp::shape_cache_key(shape, scale);
+
+    auto const found = rCtxWorld.m_primitiveCache.find(key);
+    if (found != rCtxWorld.m_primitiveCache.end())
+    {
+        return found->second;
+    }
+
+    Ref<Shape> pShape = create_primitive(rCtxWorld, shape, Vec3MagnumToJolt(scale));
+    rCtxWorld.m_primitiveCache.emplace(key, pShape);
+    return pShape;
+}
+
+Ref<Shape> SysJolt::get_compound(ACtxJoltWorld &rCtxWorld, osp::ArrayView<osp::active::CompoundLeaf const> leaves)
+{
+    using osp::active::CompoundLeaf;
+
+    std::uint64_t const hash = osp::active::SysPhysics::hash_compound(leaves);
+
+    auto const found = rCtxWorld.m_compoundCache.find(hash);
+    bool const hashTaken = found != rCtxWorld.m_compoundCache.end();
+    if (hashTaken && std::equal(leaves.begin(), leaves.end(), found->second.leaves.begin(), found->second.leaves.end()))
+    {
+        return found->second.shape;
+    }
+
+    auto const add_leaves = [&rCtxWorld, leaves] (CompoundShapeSettings &rCompound)
+    {
+        for (CompoundLeaf const& leaf : leaves)
+        {
+            rCompound.AddShape(Vec3MagnumToJolt(leaf.transform.translation()),
+                               QuatMagnumToJolt(osp::Quaternion::fromMatrix(leaf.transform.rotation())),
+                               get_primitive(rCtxWorld, leaf.shape, leaf.transform.scaling()));
+        }
+    };
+
+    // Static compounds are immutable once created and are faster to collide with, but need at
+    // least 2 sub shapes
+    Ref<Shape> pShape;
+    if (leaves.size() >= 2)
+    {
+        StaticCompoundShapeSettings compound;
+        add_leaves(compound);
+        pShape = compound.Create().Get();
+    }
+    else
+    {
+        MutableCompoundShapeSettings compound;
+        add_leaves(compound);
+        pShape = compound.Create().Get();
+    }
+
+    // On the rare hash collision, the compound is used without being cached
+    if ( ! hashTaken )
+    {
+        rCtxWorld.m_compoundCache.emplace(hash, ACtxJoltWorld::CachedCompound{
+                .leaves = {leaves.begin(), leaves.end()},
+                .shape  = pShape });
+    }
+
+    return pShape;
+}
+
+void SysJolt::add_bodies(
+        ACtxJoltWorld& rCtxWorld, osp::ArrayView<BodyId const> bodies, EActivation activation) noexcept
+{
+    if (bodies.isEmpty())
+    {
+        return;
+    }
+
+    std::vector<JPH::BodyID> &rJoltIds = rCtxWorld.m_addBodiesTemp;
+    rJoltIds.clear();
+    rJoltIds.reserve(bodies.size());
+    for (BodyId const bodyId : bodies)
+    {
+        rJoltIds.push_back(BToJolt(bodyId));
+    }
+
+    // Prepare builds a single broadphase tree for all bodies instead of one insertion each
+    BodyInterface &rBodyInterface = rCtxWorld.m_pPhysicsSystem->GetBodyInterface();
+    auto const count = static_cast<int>(rJoltIds.size());
+    BodyInterface::AddState const addState = rBodyInterface.AddBodiesPrepare(rJoltIds.data(), count);
+    rBodyInterface.AddBodiesFinalize(rJoltIds.data(), count, addState, activation);
+}
+
 void SysJolt::scale_shape(Ref<Shape> rShape, Vec3Arg scale) {
     if (rShape->GetSubType() == EShapeSubType::Scaled) {
         ScaledShape* rScaledShape = dynamic_cast<ScaledShape*>(rShape.GetPtr());
@@ -222,38 +587,101 @@ void SysJolt::find_shapes_recurse(
 //It might not be worth it considering this function should be quite fast.
 void PhysicsStepListenerImpl::OnStep(float inDeltaTime, PhysicsSystem &rPhysicsSystem)
 {
+    ACtxJoltWorld::StepBatch &rBatch = m_context->m_stepBatch;
+
     //no lock as all bodies are already locked
     BodyInterface &bodyInterface = rPhysicsSystem.GetBodyInterfaceNoLock();
-    for (BodyId bodyId : m_context->m_bodyIds)
+
+    // Only bodies in Jolt's active list are visited. Static and sleeping bodies are never active;
+    // sleeping bodies don't move, so their transforms stay clean and their draw transforms aren't
+    // recalculated.
+    rPhysicsSystem.GetActiveBodies(EBodyType::RigidBody, rBatch.active);
+
+    osp::active::ACtxPhysInterp *pInterp = m_context->m_pInterp;
+    if (pInterp != nullptr)
     {
-        JPH::BodyID joltBodyId = BToJolt(bodyId);
-        if (bodyInterface.GetMotionType(joltBodyId) != EMotionType::Dynamic) 
+        osp::active::SysPhysics::interp_begin_step(*pInterp);
+    }
+
+    rBatch.bodies   .clear();
+    rBatch.invMass  .clear();
+    rBatch.factors  .clear();
+
+    for (JPH::BodyID const joltBodyId : rBatch.active)
+    {
+        BodyId const bodyId{joltBodyId.GetIndex()};
+        if (   ! m_context->m_bodyIds.exists(bodyId)
+            || bodyInterface.GetMotionType(joltBodyId) != EMotionType::Dynamic)
         {
             continue;
         }
 
         //Transform jolt -> osp
+        ActiveEnt const ent = m_context->m_bodyToEnt[bodyId];
+        Mat44 const worldTranform = bodyInterface.GetWorldTransform(joltBodyId);
 
+        Matrix4 &rTransform = m_context->m_pTransform->get(ent).m_transform;
+        worldTranform.StoreFloat4x4((Float4*)rTransform.data());
+        m_context->m_pTransformDirty->insert(ent);
 
-        ActiveEnt const ent = m_context->m_bodyToEnt[bodyId];
-        Mat44 worldTranform = bodyInterface.GetWorldTransform(joltBodyId);
+        if (pInterp != nullptr)
+        {
+            osp::active::SysPhysics::interp_record(*pInterp, ent, rTransform);
+        }
 
-        worldTranform.StoreFloat4x4((Float4*)m_context->m_pTransform->get(ent).m_transform.data());
+        rBatch.bodies   .push_back(bodyId);
+        rBatch.invMass  .push_back(SysJolt::get_inverse_mass_no_lock(rPhysicsSystem, bodyId));
+        rBatch.factors  .push_back(m_context->m_bodyFactors[bodyId]);
+    }
 
-        //Force and torque osp -> jolt
-        Vector3 force{0.0f};
-        Vector3 torque{0.0f};
+    std::size_t const bodyCount = rBatch.bodies.size();
+    rBatch.forces   .assign(bodyCount, Vector3{0.0f});
+    rBatch.torques  .assign(bodyCount, Vector3{0.0f});
 
-        LGRN_ASSERT(ForceFactors_t{}.size() == 64u);
-        auto const factorsInts = std::initializer_list<std::uint64_t>{m_context->m_bodyFactors[bodyId].to_ullong()};
-        auto const factorsBits = lgrn::bit_view(factorsInts);
+    //Force and torque osp -> jolt, one call per factor
+    for (std::size_t factorIdx = 0; factorIdx < m_context->m_factors.size(); ++factorIdx)
+    {
+        rBatch.factorIndices.clear();
+        rBatch.factorBodies .clear();
+        rBatch.factorInvMass.clear();
 
-        for (std::size_t const factorIdx : factorsBits.ones())
-        {   
-            ACtxJoltWorld::ForceFactorFunc const& factor = m_context->m_factors[factorIdx];
-            factor.m_func(bodyId, *m_context, factor.m_userData, force, torque);
+        for (std::uint32_t i = 0; i < bodyCount; ++i)
+        {
+            if (rBatch.factors[i].test(factorIdx))
+            {
+                rBatch.factorIndices.push_back(i);
+                rBatch.factorBodies .push_back(rBatch.bodies[i]);
+                rBatch.factorInvMass.push_back(rBatch.invMass[i]);
+            }
         }
 
-        bodyInterface.AddForceAndTorque(joltBodyId, Vec3MagnumToJolt(force), Vec3MagnumToJolt(torque));
+        if (rBatch.factorIndices.empty())
+        {
+            continue;
+        }
+
+        rBatch.factorForces .assign(rBatch.factorIndices.size(), Vector3{0.0f});
+        rBatch.factorTorques.assign(rBatch.factorIndices.size(), Vector3{0.0f});
+
+        ACtxJoltWorld::ForceFactorFunc const& factor = m_context->m_factors[factorIdx];
+        factor.m_func({ .bodies  = rBatch.factorBodies,
+                        .invMass = rBatch.factorInvMass,
+                        .forces  = rBatch.factorForces,
+                        .torques = rBatch.factorTorques },
+                      *m_context, factor.m_userData);
+
+        for (std::size_t i = 0; i < rBatch.factorIndices.size(); ++i)
+        {
+            rBatch.forces [rBatch.factorIndices[i]] += rBatch.factorForces[i];
+            rBatch.torques[rBatch.factorIndices[i]] += rBatch.factorTorques[i];
+        }
+    }
+
+    for (std::size_t i = 0; i < bodyCount; ++i)
+    {
+        if ( ! rBatch.forces[i].isZero() || ! rBatch.torques[i].isZero() )
+        {
+            bodyInterface.AddForceAndTorque(BToJolt(rBatch.bodies[i]), Vec3MagnumToJolt(rBatch.forces[i]), Vec3MagnumToJolt(rBatch.torques[i]));
+        }
     }
 }
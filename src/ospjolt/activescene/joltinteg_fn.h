@@ -47,47 +47,150 @@ class SysJolt
     using ACompTransformStorage_t   = osp::active::ACompTransformStorage_t;
 public:
 
-
+    /**
+     * @brief Reserve per-body containers for all IDs in m_bodyIds
+     *
+     * Call once after creating a batch of bodies, not per body.
+     */
     static void resize_body_data(ACtxJoltWorld& rCtxWorld);
 
     /**
      * @brief Respond to scene origin shifts by translating all rigid bodies
      *
+     * Bodies are moved without locking and re-added to the broadphase in bulk. Sleeping bodies
+     * stay asleep, and active bodies keep their velocities. Must not be called during a world
+     * update.
+     *
+     * Only bodies with an ActiveEnt (in m_bodyToEnt) are moved. Bodies managed elsewhere, such as
+     * terrain colliders, are positioned by whatever owns them.
+     *
+     * Transforms of the moved bodies' entities are shifted too and marked dirty, since
+     * update_world won't write them for sleeping bodies or on frames without a step.
+     *
      * @param rCtxPhys      [ref] Generic physics context with m_originTranslate
      * @param rCtxWorld     [ref] Jolt World
+     * @param rTf           [ref] Transform components of the bodies' entities
+     * @param rTfDirty      [ref] Entities with changed transforms
      */
     static void update_translate(
-            ACtxPhysics& rCtxPhys,
-            ACtxJoltWorld& rCtxWorld) noexcept;
+            ACtxPhysics&                            rCtxPhys,
+            ACtxJoltWorld&                          rCtxWorld,
+            osp::active::ACompTransformStorage_t&   rTf,
+            osp::active::ActiveEntSet_t&            rTfDirty) noexcept;
 
     /**
      * @brief Step the entire Jolt World forward in time
      *
      * @param rCtxPhys      [ref] Generic Physics context. Updates linear and angular velocity.
      * @param rCtxWorld     [ref] Jolt world to update
-     * @param timestep      [in] Time to step world, passed to Jolt update
+     * @param timestep      [in] Time of a single step
+     * @param substeps      [in] Number of steps to run, all through one Jolt update. Does
+     *                           nothing if zero.
      * @param rTf           [ref] Relative transforms used by rigid bodies
+     * @param rTfDirty      [ref] Marked for rigid bodies that moved
+     * @param pInterp       [ref] Optional, records poses of moving bodies every step
      */
     static void update_world(
             ACtxPhysics&                            rCtxPhys,
             ACtxJoltWorld&                          rCtxWorld,
             float                                   timestep,
-            osp::active::ACompTransformStorage_t&   rTf) noexcept;
+            int                                     substeps,
+            osp::active::ACompTransformStorage_t&   rTf,
+            osp::active::ActiveEntSet_t&            rTfDirty,
+            osp::active::ACtxPhysInterp*            pInterp = nullptr) noexcept;
 
     static void remove_components(
             ACtxJoltWorld& rCtxWorld, ActiveEnt ent) noexcept;
 
+    /**
+     * @brief Remove an entity's body from ACtxJoltWorld, without removing it from Jolt
+     *
+     * @return Jolt ID of the body to pass to destroy_bodies, or an invalid ID if ent has no body
+     */
+    static JPH::BodyID release_body(
+            ACtxJoltWorld& rCtxWorld, ActiveEnt ent) noexcept;
+
+    /**
+     * @brief Remove and destroy multiple bodies through one call to Jolt, locking the broadphase
+     *        only once
+     *
+     * @param rBodies       [ref] Bodies from release_body. Jolt may reorder these.
+     */
+    static void destroy_bodies(
+            ACtxJoltWorld& rCtxWorld, std::vector<JPH::BodyID>& rBodies) noexcept;
+
+    /**
+     * @brief Save all bodies and the simulation state of a Jolt world
+     *
+     * @param rOut          [out] Overwritten with the snapshot, reusing its allocations
+     */
+    static void save_snapshot(ACtxJoltWorld const& rCtxWorld, JoltSnapshot& rOut);
+
+    /**
+     * @brief Replace all bodies in a Jolt world with the ones in a snapshot
+     *
+     * Bodies are recreated with the same BodyIds and added to the broadphase in bulk, then Jolt's
+     * simulation state is restored, so stepping afterwards gives the same results as stepping
+     * right after the snapshot was taken.
+     *
+     * @param rTf           [ref] Transforms of bodies' entities are written, if they exist
+     * @param rTfDirty      [ref] Marked for transforms written
+     *
+     * Snapshots only hold bodies with an ActiveEnt, so worlds that also have bodies managed
+     * elsewhere (such as terrain colliders) can't be restored.
+     *
+     * @return false and leave the world untouched if it has bodies without an ActiveEnt. false
+     *         if the snapshot could not be read or bodies could not be created, leaving the world
+     *         partially restored.
+     */
+    static bool restore_snapshot(
+            ACtxJoltWorld&                          rCtxWorld,
+            JoltSnapshot const&                     snapshot,
+            osp::active::ACompTransformStorage_t&   rTf,
+            osp::active::ActiveEntSet_t&            rTfDirty);
+
     static Ref<Shape> create_primitive(ACtxJoltWorld &rCtxWorld, osp::EShape shape, Vec3Arg scale);
 
+    /**
+     * @brief Get a shared primitive shape from m_primitiveCache, creating it if it doesn't exist
+     *
+     * Jolt shapes are immutable and refcounted, so any number of bodies can share one.
+     *
+     * @param scale         [in] Scale of the shape, only exactly equal scales share a shape
+     */
+    static Ref<Shape> get_primitive(ACtxJoltWorld &rCtxWorld, osp::EShape shape, osp::Vector3 scale);
+
+    /**
+     * @brief Get a shared compound shape from m_compoundCache, creating it if it doesn't exist
+     *
+     * @param leaves        [in] Primitives to add, see SysPhysics::collect_compound_leaves
+     */
+    static Ref<Shape> get_compound(ACtxJoltWorld &rCtxWorld, osp::ArrayView<osp::active::CompoundLeaf const> leaves);
+
+    /**
+     * @brief Add bodies created through CreateBodyWithID to the world, inserting them into the
+     *        broadphase all at once
+     *
+     * @param bodies        [in] Bodies to add, must not already be in the world
+     */
+    static void add_bodies(
+            ACtxJoltWorld& rCtxWorld, osp::ArrayView<BodyId const> bodies, EActivation activation) noexcept;
+
     template<typename IT_T>
     static void update_delete(
             ACtxJoltWorld &rCtxWorld, IT_T first, IT_T const& last) noexcept
     {
+        std::vector<JPH::BodyID> bodies;
         while (first != last)
         {
-            remove_components(rCtxWorld, *first);
+            if (JPH::BodyID const body = release_body(rCtxWorld, *first);
+                ! body.IsInvalid())
+            {
+                bodies.push_back(body);
+            }
             std::advance(first, 1);
         }
+        destroy_bodies(rCtxWorld, bodies);
     }
     //Apply a scale to a shape.
     static void scale_shape(Ref<Shape> rShape, Vec3Arg scale);
@@ -0,0 +1,82 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "joltjobsystem.h"          // IWYU pragma: associated
+
+#include <utility>                   // for std::move
+
+using namespace ospjolt;
+
+JobSystemOsp::JobSystemOsp(osp::WorkerPool pool, JPH::uint const maxJobs, JPH::uint const maxBarriers)
+ : JobSystemWithBarrier(maxBarriers)
+ , m_pool{std::move(pool)}
+{
+    m_jobs.Init(maxJobs, maxJobs);
+}
+
+int JobSystemOsp::GetMaxConcurrency() const
+{
+    return int(m_pool.thread_count()) + 1; // +1 for the thread waiting on the barrier
+}
+
+JobSystemOsp::JobHandle JobSystemOsp::CreateJob(const char *inName, JPH::ColorArg inColor, const JobFunction &inJobFunction, JPH::uint32 inNumDependencies)
+{
+    JPH::uint32 const index = m_jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+    JPH_ASSERT(index != AvailableJobs::cInvalidObjectIndex);
+    Job *pJob = &m_jobs.Get(index);
+
+    // Handle keeps a reference, so the job isn't freed if it completes right away
+    JobHandle handle(pJob);
+
+    if (inNumDependencies == 0)
+    {
+        QueueJob(pJob);
+    }
+
+    return handle;
+}
+
+void JobSystemOsp::QueueJob(Job *inJob)
+{
+    // Reference released once the job has run
+    inJob->AddRef();
+    m_pool.submit([inJob]
+    {
+        inJob->Execute();
+        inJob->Release();
+    });
+}
+
+void JobSystemOsp::QueueJobs(Job **inJobs, JPH::uint inNumJobs)
+{
+    for (JPH::uint i = 0; i < inNumJobs; ++i)
+    {
+        QueueJob(inJobs[i]);
+    }
+}
+
+void JobSystemOsp::FreeJob(Job *inJob)
+{
+    m_jobs.DestructObject(inJob);
+}
@@ -0,0 +1,77 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <osp/tasks/worker_pool.h>
+
+#include <Jolt/Jolt.h>
+JPH_SUPPRESS_WARNING_PUSH
+JPH_SUPPRESS_WARNINGS
+
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+
+JPH_SUPPRESS_WARNING_POP
+
+namespace ospjolt
+{
+
+/**
+ * @brief Jolt JobSystem that runs jobs on an osp::WorkerPool shared with the rest of the process
+ *
+ * Thread count is decided by the pool, instead of each Jolt world owning its own threads. The
+ * thread waiting on a barrier (the one calling PhysicsSystem::Update) also runs jobs, so physics
+ * still progresses if the pool is busy or has no threads.
+ */
+class JobSystemOsp final : public JPH::JobSystemWithBarrier
+{
+public:
+
+    /**
+     * @param pool          [in] Pool to run jobs on
+     * @param maxJobs       [in] Max number of jobs that can be allocated at once
+     * @param maxBarriers   [in] Max number of barriers that can be allocated at once
+     */
+    JobSystemOsp(osp::WorkerPool pool, JPH::uint maxJobs, JPH::uint maxBarriers);
+
+    int GetMaxConcurrency() const override;
+
+    JobHandle CreateJob(const char *inName, JPH::ColorArg inColor, const JobFunction &inJobFunction, JPH::uint32 inNumDependencies = 0) override;
+
+protected:
+
+    void QueueJob(Job *inJob) override;
+    void QueueJobs(Job **inJobs, JPH::uint inNumJobs) override;
+    void FreeJob(Job *inJob) override;
+
+private:
+
+    using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+
+    osp::WorkerPool     m_pool;
+    AvailableJobs       m_jobs;
+};
+
+} // namespace ospjolt
@@ -27,6 +27,7 @@
 #include "forcefactors.h"
 
 #include <osp/activescene/basic.h>
+#include <osp/activescene/physics.h>
 #include <osp/core/id_map.h>
 
 #include <Newton.h>
@@ -36,6 +37,8 @@
 
 #include <entt/core/any.hpp>
 
+#include <algorithm>
+
 
 namespace ospnewton
 {
@@ -60,12 +63,46 @@ using BodyId = uint32_t;
 
 using ColliderStorage_t = osp::Storage_t<osp::active::ActiveEnt, NwtColliderPtr_t>;
 
+/**
+ * @brief Saved bodies of an ACtxNwtWorld
+ *
+ * See SysNewton::save_snapshot and SysNewton::restore_snapshot
+ */
+struct NwtSnapshot
+{
+    struct Body
+    {
+        osp::Matrix4            transform;
+        osp::Vector3            velocity;
+        osp::Vector3            omega;
+        osp::Vector3            inertia;
+        float                   mass;
+        float                   linearDamping;
+        BodyId                  id;
+        osp::active::ActiveEnt  ent;
+        ForceFactors_t          factors;
+        bool                    asleep;
+    };
+
+    /// Sorted by BodyId
+    std::vector<Body>               bodies;
+
+    /// Instances sharing collision geometry with the saved bodies, parallel with bodies
+    std::vector<NwtColliderPtr_t>   collisions;
+};
+
 /**
  * @brief Represents an instance of a Newton physics world in the scane
  */
 struct ACtxNwtWorld
 {
 
+    /**
+     * @brief Adds to the force and torque of a body
+     *
+     * Called from Newton worker threads, possibly for several bodies at once. Must only read
+     * shared data, and only write to the force and torque given.
+     */
     struct ForceFactorFunc
     {
         using UserData_t = std::array<void*, 6u>;
@@ -84,6 +121,7 @@ struct ACtxNwtWorld
      : m_world(NewtonCreate())
     {
         NewtonWorldSetUserData(m_world.get(), this);
+        NewtonSetThreadsCount(m_world.get(), std::max(threadCount, 1));
     }
 
     // note: important that m_nwtBodies and m_nwtColliders are destructed
@@ -95,6 +133,12 @@ struct ACtxNwtWorld
     std::vector<ForceFactors_t>                     m_bodyFactors;
     lgrn::IdSetStl<BodyId>                          m_bodyDirty;
 
+    /// Written by SysNewton::cb_set_transform, which runs on Newton worker threads. Each body
+    /// only writes its own slots, so no locking is needed. Copied to m_pTransform after each
+    /// update on the calling thread.
+    std::vector<osp::Matrix4>                       m_bodyTransform;
+    std::vector<std::uint8_t>                       m_bodyMoved;
+
     std::vector<osp::active::ActiveEnt>             m_bodyToEnt;
     osp::IdMap_t<osp::active::ActiveEnt, BodyId>    m_entToBody;
 
@@ -102,7 +146,21 @@ struct ACtxNwtWorld
 
     ColliderStorage_t                               m_colliders;
 
+    /// Scaled primitives shared between bodies, keyed by osp::shape_cache_key
+    osp::IdMap_t<osp::ShapeCacheKey, NwtColliderPtr_t> m_primitiveCache;
+
+    struct CachedCompound
+    {
+        std::vector<osp::active::CompoundLeaf>  leaves;
+        NwtColliderPtr_t                        collision;
+    };
+
+    /// Compound collisions shared between identical welds, keyed by SysPhysics::hash_compound
+    osp::IdMap_t<std::uint64_t, CachedCompound>     m_compoundCache;
+
     osp::active::ACompTransformStorage_t            *m_pTransform;
+    osp::active::ActiveEntSet_t                     *m_pTransformDirty;
+    osp::active::ACtxPhysInterp                     *m_pInterp{nullptr};
 };
 
 
@@ -26,9 +26,13 @@
 #include "newtoninteg_fn.h"          // IWYU pragma: associated
 
 #include <osp/activescene/basic_fn.h>
+#include <osp/activescene/physics_fn.h>
 
 #include <Newton.h>                  // for NewtonBodySetCollision
 
+#include <longeron/utility/asserts.hpp>
+
+#include <algorithm>                 // for std::sort
 #include <utility>                   // for std::exchange
 #include <cassert>                   // for assert
 
@@ -44,6 +48,8 @@ using osp::EShape;
 
 using osp::active::ActiveEnt;
 using osp::active::ACtxPhysics;
+using osp::active::ACtxPhysInterp;
+using osp::active::SysPhysics;
 using osp::active::SysSceneGraph;
 
 using osp::Matrix3;
@@ -51,7 +57,8 @@ using osp::Matrix4;
 using osp::Vector3;
 
 
-// Callback called for dynamic rigid bodies for applying force and torque
+// Callback called for dynamic rigid bodies for applying force and torque. Runs on Newton worker
+// threads; only reads shared data and writes to this body.
 void SysNewton::cb_force_torque(
         NewtonBody const* pBody, dFloat const timestep, NwtThreadIndex_t const thread)
 {
@@ -79,11 +86,33 @@ void SysNewton::cb_set_transform(
     ACtxNwtWorld &rWorldCtx = SysNewton::context_from_nwtbody(pBody);
     BodyId const bodyId     = SysNewton::get_userdata_bodyid(pBody);
 
-    ActiveEnt const ent = rWorldCtx.m_bodyToEnt[bodyId];
-
-    NewtonBodyGetMatrix(pBody, rWorldCtx.m_pTransform->get(ent).m_transform.data());
+    // Runs on worker threads, only write to this body's own slots. See sync_moved_bodies
+    NewtonBodyGetMatrix(pBody, rWorldCtx.m_bodyTransform[bodyId].data());
+    rWorldCtx.m_bodyMoved[bodyId] = 1;
 } // cb_set_transform()
 
+void SysNewton::sync_moved_bodies(ACtxNwtWorld& rCtxWorld)
+{
+    for (std::size_t bodyIdx = 0; bodyIdx < rCtxWorld.m_bodyMoved.size(); ++bodyIdx)
+    {
+        if (std::exchange(rCtxWorld.m_bodyMoved[bodyIdx], 0) == 0)
+        {
+            continue;
+        }
+
+        ActiveEnt const ent = rCtxWorld.m_bodyToEnt[bodyIdx];
+
+        Matrix4 &rTransform = rCtxWorld.m_pTransform->get(ent).m_transform;
+        rTransform = rCtxWorld.m_bodyTransform[bodyIdx];
+        rCtxWorld.m_pTransformDirty->insert(ent);
+
+        if (rCtxWorld.m_pInterp != nullptr)
+        {
+            SysPhysics::interp_record(*rCtxWorld.m_pInterp, ent, rTransform);
+        }
+    }
+}
+
 
 void SysNewton::resize_body_data(ACtxNwtWorld& rCtxWorld)
 {
@@ -91,6 +120,123 @@ void SysNewton::resize_body_data(ACtxNwtWorld& rCtxWorld)
     rCtxWorld.m_bodyPtrs    .resize(capacity);
     rCtxWorld.m_bodyToEnt   .resize(capacity);
     rCtxWorld.m_bodyFactors .resize(capacity);
+    rCtxWorld.m_bodyTransform.resize(capacity);
+    rCtxWorld.m_bodyMoved   .resize(capacity, 0);
+}
+
+void SysNewton::save_snapshot(ACtxNwtWorld const& rCtxWorld, NwtSnapshot& rOut)
+{
+    rOut.bodies     .clear();
+    rOut.collisions .clear();
+    rOut.bodies     .reserve(rCtxWorld.m_entToBody.size());
+    rOut.collisions .reserve(rCtxWorld.m_entToBody.size());
+
+    for (auto const& [ent, bodyId] : rCtxWorld.m_entToBody)
+    {
+        NewtonBody const *pBody = rCtxWorld.m_bodyPtrs[bodyId].get();
+
+        NwtSnapshot::Body &rOutBody = rOut.bodies.emplace_back(NwtSnapshot::Body{
+            .id         = bodyId,
+            .ent        = ent,
+            .factors    = rCtxWorld.m_bodyFactors[bodyId],
+            .asleep     = NewtonBodyGetSleepState(pBody) != 0 });
+
+        NewtonBodyGetMatrix     (pBody, rOutBody.transform.data());
+        NewtonBodyGetVelocity   (pBody, rOutBody.velocity.data());
+        NewtonBodyGetOmega      (pBody, rOutBody.omega.data());
+        NewtonBodyGetMass       (pBody, &rOutBody.mass, &rOutBody.inertia.x(), &rOutBody.inertia.y(), &rOutBody.inertia.z());
+        rOutBody.linearDamping = NewtonBodyGetLinearDamping(pBody);
+    }
+
+    // Sorted so the registry can recreate the same IDs in order
+    std::sort(rOut.bodies.begin(), rOut.bodies.end(), [] (NwtSnapshot::Body const& lhs, NwtSnapshot::Body const& rhs)
+    {
+        return lhs.id < rhs.id;
+    });
+
+    for (NwtSnapshot::Body const& body : rOut.bodies)
+    {
+        NewtonBody const *pBody = rCtxWorld.m_bodyPtrs[body.id].get();
+        rOut.collisions.emplace_back(NewtonCollisionCreateInstance(NewtonBodyGetCollision(pBody)));
+    }
+}
+
+bool SysNewton::restore_snapshot(
+        ACtxNwtWorld&               rCtxWorld,
+        NwtSnapshot const&          snapshot,
+        ACompTransformStorage_t&    rTf,
+        ActiveEntSet_t&             rTfDirty)
+{
+    LGRN_ASSERT(snapshot.bodies.size() == snapshot.collisions.size());
+
+    // Snapshots only hold bodies with an ActiveEnt. Bodies managed elsewhere can't be destroyed
+    // here without their owner knowing, and would keep their IDs.
+    if (rCtxWorld.m_bodyIds.size() != rCtxWorld.m_entToBody.size())
+    {
+        return false;
+    }
+
+    rCtxWorld.m_bodyPtrs    .clear();
+    rCtxWorld.m_bodyIds     = lgrn::IdRegistryStl<BodyId>{};
+    rCtxWorld.m_bodyToEnt   .clear();
+    rCtxWorld.m_entToBody   .clear();
+    rCtxWorld.m_bodyMoved   .clear();
+    rCtxWorld.m_bodyDirty   .clear();
+
+    // The registry hands out the lowest free ID, and bodies are sorted by ID. Create IDs up to
+    // the last one, then free the ones not used.
+    if ( ! snapshot.bodies.empty() )
+    {
+        std::vector<BodyId> ids(std::size_t(snapshot.bodies.back().id) + 1);
+        rCtxWorld.m_bodyIds.create(ids.begin(), ids.end());
+
+        auto itBody = snapshot.bodies.begin();
+        for (BodyId const id : ids)
+        {
+            if (itBody != snapshot.bodies.end() && itBody->id == id)
+            {
+                ++itBody;
+            }
+            else
+            {
+                rCtxWorld.m_bodyIds.remove(id);
+            }
+        }
+    }
+
+    resize_body_data(rCtxWorld);
+
+    NewtonWorld *pNwtWorld = rCtxWorld.m_world.get();
+
+    for (std::size_t i = 0; i < snapshot.bodies.size(); ++i)
+    {
+        NwtSnapshot::Body const &body = snapshot.bodies[i];
+
+        // The body gets its own instance of the collision, the snapshot's stays reusable
+        NewtonBody *pBody = NewtonCreateDynamicBody(pNwtWorld, snapshot.collisions[i].get(), body.transform.data());
+
+        rCtxWorld.m_bodyPtrs[body.id].reset(pBody);
+        rCtxWorld.m_bodyToEnt[body.id]    = body.ent;
+        rCtxWorld.m_bodyFactors[body.id]  = body.factors;
+        rCtxWorld.m_entToBody.emplace(body.ent, body.id);
+
+        NewtonBodySetMassMatrix(pBody, body.mass, body.inertia.x(), body.inertia.y(), body.inertia.z());
+        NewtonBodySetVelocity(pBody, body.velocity.data());
+        NewtonBodySetOmega(pBody, body.omega.data());
+        NewtonBodySetLinearDamping(pBody, body.linearDamping);
+        NewtonBodySetForceAndTorqueCallback(pBody, &SysNewton::cb_force_torque);
+        NewtonBodySetTransformCallback(pBody, &SysNewton::cb_set_transform);
+        NewtonBodySetSleepState(pBody, body.asleep ? 1 : 0);
+        SysNewton::set_userdata_bodyid(pBody, body.id);
+
+        if (rTf.contains(body.ent))
+        {
+            rTf.get(body.ent).m_transform = body.transform;
+            rTfDirty.insert(body.ent);
+        }
+    }
+
+    return true;
 }
 
 NwtColliderPtr_t SysNewton::create_primative(
@@ -119,6 +265,67 @@ NwtColliderPtr_t SysNewton::create_primative(
     return NwtColliderPtr_t{pCollision};
 }
 
+NewtonCollision const* SysNewton::get_primitive(
+        ACtxNwtWorld&   rCtxWorld,
+        EShape          shape,
+        Vector3         scale)
+{
+    osp::ShapeCacheKey const key = osp::shape_cache_key(shape, scale);
+
+    auto const found = rCtxWorld.m_primitiveCache.find(key);
+    if (found != rCtxWorld.m_primitiveCache.end())
+    {
+        return found->second.get();
+    }
+
+    NwtColliderPtr_t pCollision = create_primative(rCtxWorld, shape);
+    orient_collision(pCollision.get(), shape, {0.0f, 0.0f, 0.0f}, Matrix3{}, scale);
+    return rCtxWorld.m_primitiveCache.emplace(key, std::move(pCollision)).first->second.get();
+}
+
+NewtonCollision const* SysNewton::get_compound(
+        ACtxNwtWorld&                                       rCtxWorld,
+        Corrade::Containers::ArrayView<osp::active::CompoundLeaf const> leaves)
+{
+    using osp::active::CompoundLeaf;
+
+    std::uint64_t const hash = SysPhysics::hash_compound(leaves);
+
+    auto const found = rCtxWorld.m_compoundCache.find(hash);
+    bool const hashTaken = found != rCtxWorld.m_compoundCache.end();
+    if (hashTaken && std::equal(leaves.begin(), leaves.end(), found->second.leaves.begin(), found->second.leaves.end()))
+    {
+        return found->second.collision.get();
+    }
+
+    NwtColliderPtr_t pCompound{NewtonCreateCompoundCollision(rCtxWorld.m_world.get(), 0)};
+
+    NewtonCompoundCollisionBeginAddRemove(pCompound.get());
+    for (CompoundLeaf const& leaf : leaves)
+    {
+        // Sub collisions are copied into the compound, so the temporary can be destroyed after
+        NwtColliderPtr_t const pLeaf = create_primative(rCtxWorld, leaf.shape);
+        orient_collision(pLeaf.get(), leaf.shape, leaf.transform.translation(),
+                         leaf.transform.rotation(), leaf.transform.scaling());
+        NewtonCompoundCollisionAddSubCollision(pCompound.get(), pLeaf.get());
+    }
+    NewtonCompoundCollisionEndAddRemove(pCompound.get());
+
+    // On the rare hash collision, replace the entry. Bodies already made from the old compound
+    // hold their own instances of it.
+    if (hashTaken)
+    {
+        found->second = ACtxNwtWorld::CachedCompound{
+                .leaves    = {leaves.begin(), leaves.end()},
+                .collision = std::move(pCompound) };
+        return found->second.collision.get();
+    }
+
+    return rCtxWorld.m_compoundCache.emplace(hash, ACtxNwtWorld::CachedCompound{
+            .leaves    = {leaves.begin(), leaves.end()},
+            .collision = std::move(pCompound) }).first->second.collision.get();
+}
+
 void SysNewton::orient_collision(
         NewtonCollision const*  pCollision,
         osp::EShape             shape,
@@ -146,7 +353,11 @@ void SysNewton::orient_collision(
     }
 }
 
-void SysNewton::update_translate(ACtxPhysics& rCtxPhys, ACtxNwtWorld& rCtxWorld) noexcept
+void SysNewton::update_translate(
+        ACtxPhysics&                rCtxPhys,
+        ACtxNwtWorld&               rCtxWorld,
+        ACompTransformStorage_t&    rTf,
+        ActiveEntSet_t&             rTfDirty) noexcept
 {
     NewtonWorld const* pNwtWorld = rCtxWorld.m_world.get();
 
@@ -154,14 +365,31 @@ void SysNewton::update_translate(ACtxPhysics& rCtxPhys, ACtxNwtWorld& rCtxWorld)
     if (Vector3 const translate = std::exchange(rCtxPhys.m_originTranslate, {});
         ! translate.isZero())
     {
-        // Translate every newton body
+        // Translate every newton body. NewtonBodySetMatrix wakes bodies up, so a single origin
+        // shift would cause every sleeping body to be simulated again. The whole world moves
+        // together, so nothing needs to wake.
         for (NewtonBody const* pBody = NewtonWorldGetFirstBody(pNwtWorld);
              pBody != nullptr; pBody = NewtonWorldGetNextBody(pNwtWorld, pBody))
         {
             Matrix4 matrix;
             NewtonBodyGetMatrix(pBody, matrix.data());
             matrix.translation() += translate;
-            NewtonBodySetMatrix(pBody, matrix.data());
+            NewtonBodySetMatrixNoSleep(pBody, matrix.data());
+
+            // update_world only writes transforms of bodies that moved during a step. Sleeping
+            // bodies, and all bodies on frames without a step, must be shifted here.
+            BodyId const    bodyId  = get_userdata_bodyid(pBody);
+            ActiveEnt const ent     = rCtxWorld.m_bodyToEnt[bodyId];
+            if (ent != lgrn::id_null<ActiveEnt>())
+            {
+                rTf.get(ent).m_transform.translation() += translate;
+                rTfDirty.insert(ent);
+            }
+        }
+
+        if (rCtxWorld.m_pInterp != nullptr)
+        {
+            SysPhysics::interp_translate(*rCtxWorld.m_pInterp, translate);
         }
     }
 }
@@ -172,9 +400,17 @@ void SysNewton::update_world(
         ACtxPhysics&                rCtxPhys,
         ACtxNwtWorld&               rCtxWorld,
         float                       timestep,
+        int                         substeps,
         ACtxSceneGraph const&       rScnGraph,
-        ACompTransformStorage_t&    rTf) noexcept
+        ACompTransformStorage_t&    rTf,
+        ActiveEntSet_t&             rTfDirty,
+        ACtxPhysInterp*             pInterp) noexcept
 {
+    if (substeps <= 0)
+    {
+        return;
+    }
+
     NewtonWorld const* pNwtWorld = rCtxWorld.m_world.get();
 
     // Apply changed velocities
@@ -186,10 +422,21 @@ void SysNewton::update_world(
         NewtonBodySetVelocity(pBody, vel.data());
     }
 
-    rCtxWorld.m_pTransform = std::addressof(rTf);
+    rCtxWorld.m_pTransform      = std::addressof(rTf);
+    rCtxWorld.m_pTransformDirty = std::addressof(rTfDirty);
+    rCtxWorld.m_pInterp         = pInterp;
 
-    // Update the world
-    NewtonUpdate(pNwtWorld, timestep);
+    // Update the world. NewtonUpdate returns once all worker threads are done, so moved bodies
+    // can be synced right after
+    for (int i = 0; i < substeps; ++i)
+    {
+        if (pInterp != nullptr)
+        {
+            SysPhysics::interp_begin_step(*pInterp);
+        }
+        NewtonUpdate(pNwtWorld, timestep);
+        sync_moved_bodies(rCtxWorld);
+    }
 }
 
 void SysNewton::remove_components(ACtxNwtWorld& rCtxWorld, ActiveEnt ent) noexcept
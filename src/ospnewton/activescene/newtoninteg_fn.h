@@ -53,14 +53,79 @@ public:
 
     static void cb_force_torque(const NewtonBody* pBody, dFloat timestep, NwtThreadIndex_t thread);
 
+    /**
+     * @brief Records a moved body's transform into ACtxNwtWorld::m_bodyTransform
+     *
+     * Called from Newton worker threads.
+     */
     static void cb_set_transform(NewtonBody const* pBody, dFloat const* pMatrix, NwtThreadIndex_t thread);
 
+    /**
+     * @brief Copy transforms of bodies moved in the last update to m_pTransform, mark them
+     *        dirty, and record them for interpolation
+     *
+     * Must be called on a single thread after NewtonUpdate.
+     */
+    static void sync_moved_bodies(ACtxNwtWorld& rCtxWorld);
+
+    /**
+     * @brief Resize per-body containers to fit all IDs in m_bodyIds
+     *
+     * Call once after creating a batch of bodies, not per body.
+     */
     static void resize_body_data(ACtxNwtWorld& rCtxWorld);
 
+    /**
+     * @brief Save the state of all bodies in a Newton world
+     *
+     * Collision shapes are referenced, not copied.
+     *
+     * @param rOut          [out] Overwritten with the snapshot, reusing its allocations
+     */
+    static void save_snapshot(ACtxNwtWorld const& rCtxWorld, NwtSnapshot& rOut);
+
+    /**
+     * @brief Replace all bodies in a Newton world with the ones in a snapshot
+     *
+     * Bodies are recreated with the same BodyIds, transforms, velocities, and sleep states.
+     *
+     * @param rTf           [ref] Transforms of bodies' entities are written, if they exist
+     * @param rTfDirty      [ref] Marked for transforms written
+     *
+     * @return false and leave the world untouched if it has bodies without an ActiveEnt, which
+     *         snapshots don't hold
+     */
+    static bool restore_snapshot(
+            ACtxNwtWorld&                           rCtxWorld,
+            NwtSnapshot const&                      snapshot,
+            osp::active::ACompTransformStorage_t&   rTf,
+            osp::active::ActiveEntSet_t&            rTfDirty);
+
     [[nodiscard]] static NwtColliderPtr_t create_primative(
             ACtxNwtWorld&           rCtxWorld,
             osp::EShape       shape);
 
+    /**
+     * @brief Get a shared scaled primitive from m_primitiveCache, creating it if it doesn't exist
+     *
+     * Newton bodies copy the collision they're created with into an instance of their own, so
+     * one collision can be used to create any number of bodies.
+     *
+     * @param scale         [in] Scale of the shape, only exactly equal scales share a shape
+     */
+    static NewtonCollision const* get_primitive(
+            ACtxNwtWorld&           rCtxWorld,
+            osp::EShape             shape,
+            osp::Vector3            scale);
+
+    /**
+     * @brief Get a shared compound collision from m_compoundCache, creating it if it doesn't exist
+     *
+     * @param leaves        [in] Primitives to add, see SysPhysics::collect_compound_leaves
+     */
+    static NewtonCollision const* get_compound(
+            ACtxNwtWorld&                                       rCtxWorld,
+            Corrade::Containers::ArrayView<osp::active::CompoundLeaf const> leaves);
 
     static void orient_collision(
             NewtonCollision const*  pCollision,
@@ -72,12 +137,21 @@ public:
     /**
      * @brief Respond to scene origin shifts by translating all rigid bodies
      *
+     * Sleeping bodies are not woken up. Must not be called during a world update.
+     *
+     * Transforms of the bodies' entities are shifted too and marked dirty, since update_world
+     * won't write them for sleeping bodies or on frames without a step.
+     *
      * @param rCtxPhys      [ref] Generic physics context with m_originTranslate
      * @param rCtxWorld     [ref] Newton World
+     * @param rTf           [ref] Transform components of the bodies' entities
+     * @param rTfDirty      [ref] Entities with changed transforms
      */
     static void update_translate(
-            ACtxPhysics& rCtxPhys,
-            ACtxNwtWorld& rCtxWorld) noexcept;
+            ACtxPhysics&                            rCtxPhys,
+            ACtxNwtWorld&                           rCtxWorld,
+            osp::active::ACompTransformStorage_t&   rTf,
+            osp::active::ActiveEntSet_t&            rTfDirty) noexcept;
 
     /**
      * @brief Synchronize generic physics colliders with Newton colliders
@@ -96,19 +170,25 @@ public:
      *
      * @param rCtxPhys      [ref] Generic Physics context. Updates linear and angular velocity.
      * @param rCtxWorld     [ref] Newton world to update
-     * @param timestep      [in] Time to step world, passed to Newton update
+     * @param timestep      [in] Time of a single step, passed to Newton update
+     * @param substeps      [in] Number of steps to run. Does nothing if zero.
      * @param inputs        [ref] Physics inputs (from different threads)
      * @param rHier         [in] Storage for Hierarchy components
      * @param rTf           [ref] Relative transforms used by rigid bodies
      * @param rTfControlled [ref] Flags for controlled transforms
      * @param rTfMutable    [ref] Flags for mutable transforms
+     * @param rTfDirty      [ref] Marked for rigid bodies that moved
+     * @param pInterp       [ref] Optional, records poses of moving bodies every step
      */
     static void update_world(
             ACtxPhysics&                            rCtxPhys,
             ACtxNwtWorld&                           rCtxWorld,
             float                                   timestep,
+            int                                     substeps,
             ACtxSceneGraph const&                   rScnGraph,
-            osp::active::ACompTransformStorage_t&   rTf) noexcept;
+            osp::active::ACompTransformStorage_t&   rTf,
+            osp::active::ActiveEntSet_t&            rTfDirty,
+            osp::active::ACtxPhysInterp*            pInterp = nullptr) noexcept;
 
     static void remove_components(
             ACtxNwtWorld& rCtxWorld, ActiveEnt ent) noexcept;
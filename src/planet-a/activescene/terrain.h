@@ -24,6 +24,7 @@
  */
 #pragma once
 
+#include "../chunk_cache.h"
 #include "../chunk_generate.h"
 #include "../geometry.h"
 #include "../skeleton_subdiv.h"
@@ -63,6 +64,9 @@ struct ACtxTerrain
     planeta::ChunkScratchpad            chunkSP;
     planeta::SkeletonSubdivScratchpad   scratchpad;
 
+    /// Previously generated chunk fill vertices, reused instead of recalculated if found
+    planeta::ChunkGeometryCache         chunkCache;
+
     osp::draw::MeshIdOwner_t            terrainMesh;
 };
 
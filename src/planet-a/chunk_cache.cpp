@@ -0,0 +1,417 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "chunk_cache.h"
+
+#include <longeron/utility/asserts.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using Corrade::Containers::Array;
+using osp::ArrayView;
+using osp::Vector3;
+
+namespace planeta
+{
+
+SkTriPath_t tri_path(SkTriId const sktriId, SubdivTriangleSkeleton const& skel)
+{
+    SkTriPath_t  siblings = 0;
+    unsigned int depth    = 0;
+    SkTriId      current  = sktriId;
+
+    while (true)
+    {
+        SkTriId const parent = skel.tri_group_at(tri_group_id(current)).parent;
+        if ( ! parent.has_value() )
+        {
+            break;
+        }
+        siblings |= SkTriPath_t(tri_sibling_index(current)) << (2 * depth);
+        ++depth;
+        current = parent;
+    }
+
+    LGRN_ASSERTMV(current.value < 32 && depth <= 23, "Triangle path does not fit", current.value, depth);
+
+    SkTriPath_t const root = (SkTriPath_t(1) << 5) | SkTriPath_t(current.value);
+    return (root << (2 * depth)) | siblings;
+}
+
+namespace
+{
+
+/**
+ * @brief Map a whole file read-only. Returns empty array on failure.
+ */
+Array<std::byte> map_read(std::string const& path)
+{
+#if defined(_WIN32)
+    HANDLE const file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return {};
+    }
+
+    LARGE_INTEGER size;
+    if ( ! GetFileSizeEx(file, &size) || size.QuadPart == 0 )
+    {
+        CloseHandle(file);
+        return {};
+    }
+
+    HANDLE const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return {};
+    }
+
+    void *const data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // View keeps the mapping alive
+    if (data == nullptr)
+    {
+        return {};
+    }
+
+    return Array<std::byte>{static_cast<std::byte*>(data), std::size_t(size.QuadPart),
+                            [] (std::byte *pData, std::size_t) { UnmapViewOfFile(pData); }};
+#else
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return {};
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return {};
+    }
+
+    void *const data = ::mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // Mapping stays valid after closing the descriptor
+    if (data == MAP_FAILED)
+    {
+        return {};
+    }
+
+    return Array<std::byte>{static_cast<std::byte*>(data), std::size_t(st.st_size),
+                            [] (std::byte *pData, std::size_t size) { ::munmap(pData, size); }};
+#endif
+}
+
+} // namespace
+
+ChunkCacheFile ChunkCacheFile::open(
+        std::string     const&  path,
+        std::uint64_t   const   planetId,
+        std::uint32_t   const   fillVrtxCount)
+{
+    ChunkCacheFile out;
+    out.m_mapped = map_read(path);
+
+    if ( ! out.is_open() )
+    {
+        return {};
+    }
+
+    if (out.m_mapped.size() < sizeof(ChunkCacheHeader))
+    {
+        return {};
+    }
+
+    ChunkCacheHeader const& header = out.header();
+
+    std::size_t const expectSize = sizeof(ChunkCacheHeader)
+                                 + std::size_t(header.recordCount) * sizeof(SkTriPath_t)
+                                 + std::size_t(header.recordCount) * header.fillVrtxCount * sizeof(Vector3);
+
+    if (   header.magic         != ChunkCacheHeader::smc_magic
+        || header.version       != ChunkCacheHeader::smc_version
+        || header.planetId      != planetId
+        || header.fillVrtxCount != fillVrtxCount
+        || out.m_mapped.size()  != expectSize )
+    {
+        return {};
+    }
+
+    return out;
+}
+
+ArrayView<SkTriPath_t const> ChunkCacheFile::paths() const noexcept
+{
+    if ( ! is_open() )
+    {
+        return {};
+    }
+
+    auto const *pFirst = reinterpret_cast<SkTriPath_t const*>(m_mapped.data() + sizeof(ChunkCacheHeader));
+    return {pFirst, header().recordCount};
+}
+
+ArrayView<Vector3 const> ChunkCacheFile::record_at(std::size_t const index) const noexcept
+{
+    ChunkCacheHeader const& head      = header();
+    std::size_t      const  dataStart = sizeof(ChunkCacheHeader) + std::size_t(head.recordCount) * sizeof(SkTriPath_t);
+
+    auto const *pFirst = reinterpret_cast<Vector3 const*>(m_mapped.data() + dataStart);
+    return {pFirst + index * head.fillVrtxCount, head.fillVrtxCount};
+}
+
+ArrayView<Vector3 const> ChunkCacheFile::find(SkTriPath_t const path) const noexcept
+{
+    ArrayView<SkTriPath_t const> const allPaths = paths();
+
+    auto const found = std::lower_bound(allPaths.begin(), allPaths.end(), path);
+    if (found == allPaths.end() || *found != path)
+    {
+        return {};
+    }
+
+    return record_at(std::size_t(std::distance(allPaths.begin(), found)));
+}
+
+namespace
+{
+
+struct Record
+{
+    SkTriPath_t         path;
+    Vector3 const       *pData;
+};
+
+/**
+ * @brief Write sorted records to \c path + ".tmp"
+ *
+ * @return false if the file could not be written, the temporary file is removed
+ */
+bool write_temp_file(
+        std::string             const&  path,
+        ChunkGeometryCache      const&  cache,
+        std::vector<Record>     const&  records)
+{
+    ChunkCacheHeader const header
+    {
+        .planetId       = cache.planetId,
+        .fillVrtxCount  = cache.fillVrtxCount,
+        .recordCount    = std::uint32_t(records.size())
+    };
+
+    std::string const tempPath = path + ".tmp";
+
+    std::ofstream out{tempPath, std::ios::binary | std::ios::trunc};
+
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+    for (Record const& record : records)
+    {
+        out.write(reinterpret_cast<char const*>(&record.path), sizeof(SkTriPath_t));
+    }
+    for (Record const& record : records)
+    {
+        out.write(reinterpret_cast<char const*>(record.pData), std::streamsize(sizeof(Vector3) * cache.fillVrtxCount));
+    }
+
+    // Buffered data is only written out on close, which can fail too
+    out.close();
+    if ( ! out )
+    {
+        std::error_code ignored;
+        std::filesystem::remove(tempPath, ignored);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Replace \c path with the temporary file written by write_temp_file
+ */
+bool replace_with_temp_file(std::string const& path)
+{
+    std::string const tempPath = path + ".tmp";
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+void sort_records(std::vector<Record> &rRecords)
+{
+    std::sort(rRecords.begin(), rRecords.end(), [] (Record const& lhs, Record const& rhs) noexcept
+    {
+        return lhs.path < rhs.path;
+    });
+}
+
+} // namespace
+
+std::string chunk_cache_segment_path(std::string const& path, std::size_t const index)
+{
+    return path + ".seg" + std::to_string(index);
+}
+
+void open_chunk_cache(ChunkGeometryCache &rCache)
+{
+    rCache.file = ChunkCacheFile::open(rCache.path, rCache.planetId, rCache.fillVrtxCount);
+    rCache.segments.clear();
+
+    // Segments are only left over if the previous run didn't shut down cleanly
+    for (std::size_t i = 0; std::filesystem::exists(chunk_cache_segment_path(rCache.path, i)); ++i)
+    {
+        // Keep the index even if invalid, so later segments keep their file names
+        rCache.segments.push_back(ChunkCacheFile::open(chunk_cache_segment_path(rCache.path, i),
+                                                       rCache.planetId, rCache.fillVrtxCount));
+    }
+
+    if ( ! rCache.segments.empty() )
+    {
+        save_chunk_cache(rCache);
+    }
+}
+
+bool flush_chunk_cache(ChunkGeometryCache &rCache)
+{
+    if ( ! rCache.enabled() || rCache.added.empty() )
+    {
+        return true;
+    }
+
+    std::vector<Record> records;
+    records.reserve(rCache.added.size());
+    for (auto const& [path, positions] : rCache.added)
+    {
+        LGRN_ASSERT(positions.size() == rCache.fillVrtxCount);
+        records.push_back({path, positions.data()});
+    }
+    sort_records(records);
+
+    std::string const segPath = chunk_cache_segment_path(rCache.path, rCache.segments.size());
+    if ( ! write_temp_file(segPath, rCache, records) || ! replace_with_temp_file(segPath) )
+    {
+        return false;
+    }
+
+    ChunkCacheFile segment = ChunkCacheFile::open(segPath, rCache.planetId, rCache.fillVrtxCount);
+    if ( ! segment.is_open() )
+    {
+        return false;
+    }
+
+    rCache.segments.push_back(std::move(segment));
+    rCache.added.clear();
+
+    return true;
+}
+
+bool save_chunk_cache(ChunkGeometryCache &rCache)
+{
+    if ( ! rCache.enabled() || (rCache.added.empty() && rCache.segments.empty()) )
+    {
+        return true;
+    }
+
+    // Merge all records, newest first. Records already added from a newer source are skipped.
+    std::vector<Record>             records;
+    std::unordered_set<SkTriPath_t> merged;
+
+    auto const merge_file = [&records, &merged] (ChunkCacheFile const& file)
+    {
+        ArrayView<SkTriPath_t const> const paths = file.paths();
+        for (std::size_t i = 0; i < paths.size(); ++i)
+        {
+            if (merged.insert(paths[i]).second)
+            {
+                records.push_back({paths[i], file.record_at(i).data()});
+            }
+        }
+    };
+
+    for (auto const& [path, positions] : rCache.added)
+    {
+        LGRN_ASSERT(positions.size() == rCache.fillVrtxCount);
+        merged.insert(path);
+        records.push_back({path, positions.data()});
+    }
+    for (auto segIt = rCache.segments.rbegin(); segIt != rCache.segments.rend(); ++segIt)
+    {
+        merge_file(*segIt);
+    }
+    merge_file(rCache.file);
+
+    sort_records(records);
+
+    // Write to a temporary file first; the existing files are still mapped and being read from
+    if ( ! write_temp_file(rCache.path, rCache, records) )
+    {
+        return false;
+    }
+
+    // Unmap before replacing, some platforms can't replace a mapped file
+    rCache.file = {};
+
+    if ( ! replace_with_temp_file(rCache.path) )
+    {
+        rCache.file = ChunkCacheFile::open(rCache.path, rCache.planetId, rCache.fillVrtxCount);
+        return false;
+    }
+
+    // Segments are now in the new file. If removing one fails, it gets merged again on next open.
+    std::size_t const segmentCount = rCache.segments.size();
+    rCache.segments.clear();
+    for (std::size_t i = 0; i < segmentCount; ++i)
+    {
+        std::error_code ignored;
+        std::filesystem::remove(chunk_cache_segment_path(rCache.path, i), ignored);
+    }
+
+    rCache.added.clear();
+    rCache.file = ChunkCacheFile::open(rCache.path, rCache.planetId, rCache.fillVrtxCount);
+
+    return true;
+}
+
+} // namespace planeta
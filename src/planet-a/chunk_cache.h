@@ -0,0 +1,225 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief On-disk cache of generated chunk geometry, keyed by planet and skeleton triangle path
+ */
+#pragma once
+
+#include "skeleton.h"
+
+#include <osp/core/array_view.h>
+#include <osp/core/math_types.h>
+
+#include <Corrade/Containers/Array.h>
+#include <Corrade/Containers/ArrayViewStl.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace planeta
+{
+
+/**
+ * @brief Identifies a skeleton triangle independently of how its IDs were assigned
+ *
+ * Made of a leading 1 bit, the 5-bit index of the root triangle, then 2 bits per level for the
+ * sibling index (0..3) taken on the way down. A triangle at the same place on the same planet
+ * always has the same path, even after the skeleton is destroyed and rebuilt.
+ *
+ * Fits triangles up to 23 levels deep, which is \c gc_maxSubdivLevels.
+ */
+using SkTriPath_t = std::uint64_t;
+
+/**
+ * @brief Get the path of a triangle by walking up its parents
+ *
+ * Root triangles are assumed to be created first, so their SkTriId is used as the root index.
+ */
+SkTriPath_t tri_path(SkTriId sktriId, SubdivTriangleSkeleton const& skel);
+
+/**
+ * @brief Header at the start of a chunk cache file
+ *
+ * File layout (native endian):
+ * * ChunkCacheHeader
+ * * SkTriPath_t[recordCount], sorted ascending
+ * * osp::Vector3[recordCount * fillVrtxCount], fill vertices of each record in the same order
+ */
+struct ChunkCacheHeader
+{
+    static constexpr std::array<char, 4> smc_magic      {'O', 'S', 'P', 'C'};
+    static constexpr std::uint32_t       smc_version    = 1;
+
+    std::array<char, 4> magic           {smc_magic};
+    std::uint32_t       version         {smc_version};
+
+    /// Chosen by the caller. Must change if anything that affects generated terrain changes.
+    std::uint64_t       planetId        {};
+
+    std::uint32_t       fillVrtxCount   {};
+    std::uint32_t       recordCount     {};
+};
+static_assert(sizeof(ChunkCacheHeader) == 24);
+
+/**
+ * @brief Read-only memory-mapped chunk cache file
+ *
+ * Only the pages of records that are actually looked up get read from disk.
+ */
+class ChunkCacheFile
+{
+public:
+
+    /**
+     * @brief Map a cache file
+     *
+     * @return Empty ChunkCacheFile if the file doesn't exist, is malformed, or doesn't match
+     *         planetId or fillVrtxCount.
+     */
+    static ChunkCacheFile open(std::string const& path, std::uint64_t planetId, std::uint32_t fillVrtxCount);
+
+    [[nodiscard]] bool is_open() const noexcept { return ! m_mapped.isEmpty(); }
+
+    [[nodiscard]] std::uint32_t record_count() const noexcept
+    {
+        return is_open() ? header().recordCount : 0;
+    }
+
+    [[nodiscard]] osp::ArrayView<SkTriPath_t const> paths() const noexcept;
+
+    /**
+     * @return Fill vertex positions of a chunk, relative to its first corner. Empty if not found.
+     */
+    [[nodiscard]] osp::ArrayView<osp::Vector3 const> find(SkTriPath_t path) const noexcept;
+
+    /**
+     * @return Fill vertex positions of record at index in paths()
+     */
+    [[nodiscard]] osp::ArrayView<osp::Vector3 const> record_at(std::size_t index) const noexcept;
+
+private:
+
+    ChunkCacheHeader const& header() const noexcept
+    {
+        return *reinterpret_cast<ChunkCacheHeader const*>(m_mapped.data());
+    }
+
+    Corrade::Containers::Array<std::byte> m_mapped;
+};
+
+/**
+ * @brief Chunk fill vertex positions saved to and loaded from disk
+ *
+ * Fill vertices (the vertices in the middle of the chunk, see ChunkMeshBufferInfo) are stored
+ * relative to the chunk's first corner, so they don't depend on where the mesh origin was.
+ *
+ * Chunks that are not found in \c file or \c segments are generated normally and added to
+ * \c added. Once \c added reaches \c flushThreshold, call flush_chunk_cache to write only those
+ * records to a new segment file next to \c path. This keeps memory use bounded and limits what's
+ * lost if the program crashes, without rewriting the whole cache every time. save_chunk_cache
+ * merges everything back into a single file at \c path, and is done on shutdown and by
+ * open_chunk_cache for segments left over by a previous run.
+ */
+struct ChunkGeometryCache
+{
+    ChunkCacheFile                                          file;
+
+    /// Segments written by flush_chunk_cache since \c file was last written, oldest first
+    std::vector<ChunkCacheFile>                             segments;
+
+    /// Newly generated records not yet in \c file or \c segments
+    std::unordered_map<SkTriPath_t, std::vector<osp::Vector3>> added;
+
+    /// Path of the cache file. Caching is disabled if empty.
+    std::string                                             path;
+
+    std::uint64_t                                           planetId        {};
+    std::uint32_t                                           fillVrtxCount   {};
+
+    /// Number of records in \c added to write them to disk at
+    std::size_t                                             flushThreshold  {1024};
+
+    [[nodiscard]] bool enabled() const noexcept { return ! path.empty(); }
+
+    [[nodiscard]] bool should_flush() const noexcept { return added.size() >= flushThreshold; }
+
+    /**
+     * @return Fill vertex positions relative to the chunk's first corner. Empty if not found.
+     */
+    [[nodiscard]] osp::ArrayView<osp::Vector3 const> find(SkTriPath_t const triPath) const noexcept
+    {
+        if (auto const foundIt = added.find(triPath); foundIt != added.end())
+        {
+            return foundIt->second;
+        }
+        for (auto segIt = segments.rbegin(); segIt != segments.rend(); ++segIt)
+        {
+            if (osp::ArrayView<osp::Vector3 const> const found = segIt->find(triPath); ! found.isEmpty())
+            {
+                return found;
+            }
+        }
+        return file.find(triPath);
+    }
+};
+
+/**
+ * @return Path of the segment file at index in ChunkGeometryCache::segments
+ */
+std::string chunk_cache_segment_path(std::string const& path, std::size_t index);
+
+/**
+ * @brief Map the cache file at \c rCache.path, merging in any segments left over by a previous run
+ *
+ * \c path, \c planetId, and \c fillVrtxCount must be set.
+ */
+void open_chunk_cache(ChunkGeometryCache &rCache);
+
+/**
+ * @brief Write only the records of \c added to a new segment file, then map it into \c segments
+ *
+ * Costs only as much as the number of records in \c added, regardless of the size of the cache.
+ * \c added is cleared on success.
+ *
+ * @return false if the file could not be written
+ */
+bool flush_chunk_cache(ChunkGeometryCache &rCache);
+
+/**
+ * @brief Merge records of \c file, \c segments, and \c added into \c path, then remap the new file
+ *
+ * \c added and \c segments are cleared and segment files are removed on success. On failure, the
+ * temporary file is removed and the existing files are left as they were.
+ *
+ * @return false if the file could not be written
+ */
+bool save_chunk_cache(ChunkGeometryCache &rCache);
+
+} // namespace planeta
@@ -26,6 +26,7 @@
 
 #include <Corrade/Containers/ArrayViewStl.h>
 
+#include <cmath>
 #include <ostream>
 
 using osp::ArrayView;
@@ -219,59 +220,13 @@ void update_faces(
     // Create triangle fill for newly added triangles
     if (newlyAdded)
     {
-        // Reset fill normals to zero, as values are left over from a previously deleted chunk
-        auto const chunkVbufFillNormals2D = as_2d(vbufNormalsView.exceptPrefix(rChInfo.vbufFillOffset), rChInfo.fillVrtxCount);
-        auto const vbufFillNormals        = chunkVbufFillNormals2D.row(chunkId.value);
-
-        // These aren't cleaned up by the previous chunk that used them
-        std::fill(vbufFillNormals  .begin(), vbufFillNormals  .end(), Vector3{ZeroInit});
-        std::fill(fillNormalContrib.begin(), fillNormalContrib.end(), Vector3{ZeroInit});
-        std::fill(fanNormalContrib .begin(), fanNormalContrib .end(), FanNormalContrib{});
-
-        auto const add_fill_tri = [&rSkCh, &rChInfo, &writer, chunkId]
-                (std::uint16_t const aX, std::uint16_t const aY,
-                 std::uint16_t const bX, std::uint16_t const bY,
-                 std::uint16_t const cX, std::uint16_t const cY)
-        {
-            auto const [shLocalA, vrtxA] = chunk_coord_to_vrtx(rSkCh, rChInfo, chunkId, aX, aY);
-            auto const [shLocalB, vrtxB] = chunk_coord_to_vrtx(rSkCh, rChInfo, chunkId, bX, bY);
-            auto const [shLocalC, vrtxC] = chunk_coord_to_vrtx(rSkCh, rChInfo, chunkId, cX, cY);
-
-            writer.fill_add_face(vrtxA, vrtxB, vrtxC);
-
-            shLocalA.has_value() ? writer.fill_add_normal_shared(vrtxA, shLocalA)
-                                 : writer.fill_add_normal_filled(vrtxA);
-            shLocalB.has_value() ? writer.fill_add_normal_shared(vrtxB, shLocalB)
-                                 : writer.fill_add_normal_filled(vrtxB);
-            shLocalC.has_value() ? writer.fill_add_normal_shared(vrtxC, shLocalC)
-                                 : writer.fill_add_normal_filled(vrtxC);
-        };
-
-        for (unsigned int y = 0; y < rSkCh.m_chunkEdgeVrtxCount; ++y)
-        {
-            for (unsigned int x = 0; x < y; ++x)
-            {
-                // down-pointing
-                //                ( aX   aY )    ( aX   aY )    ( aX   aY )
-                add_fill_tri(      x+1, y+1,      x+1,  y,         x,  y      );
+        // Not cleaned up by the previous chunk that used them
+        std::fill(fanNormalContrib.begin(), fanNormalContrib.end(), FanNormalContrib{});
 
-                // up pointing
-                bool const onEdge = (x == y-1) || y == rSkCh.m_chunkEdgeVrtxCount - 1;
-                if ( ! onEdge )
-                {
-                    //                ( aX   aY )    ( aX   aY )    ( aX   aY )
-                    add_fill_tri(      x+1,  y,       x+1,  y+1,     x+2,  y+1   );
-                }
-            }
-        }
+        write_fill_faces_gather(chunkId, rGeom, rChInfo, rChSP, rSkCh);
 
-        LGRN_ASSERTM(writer.currentFace == std::next(ibufSlice.begin(), rChInfo.fillFaceCount),
-                     "Code above must always add a known number of faces");
-
-        for (Vector3 &rNormal : vbufFillNormals)
-        {
-            rNormal = rNormal.normalized();
-        }
+        DirtyRanges::Range const fillRange = chunk_fill_vrtx_range(rChInfo, chunkId);
+        rGeom.dirtyVrtx.add(fillRange.first, fillRange.size());
     }
 
     writer.currentFace = std::next(ibufSlice.begin(), rChInfo.fillFaceCount);
@@ -315,6 +270,214 @@ void update_faces(
     // Fill remaining with zeros to indicate an early end if the full range isn't used
     std::fill(writer.currentFace, ibufSlice.end(), Vector3u{ZeroInit});
 
+    // New chunks rewrite their whole row of faces, restitched chunks only rewrite the fans
+    DirtyRanges::Range const faceRange  = chunk_face_range(rChInfo, chunkId);
+    std::uint32_t      const firstDirty = newlyAdded ? faceRange.first : faceRange.first + rChInfo.fillFaceCount;
+    rGeom.dirtyFaces.add(firstDirty, faceRange.last - firstDirty);
+
+}
+
+void write_fill_faces_scatter(
+        ChunkId                       const chunkId,
+        BasicChunkMeshGeometry              &rGeom,
+        ChunkMeshBufferInfo           const &rChInfo,
+        ChunkScratchpad                     &rChSP,
+        ChunkSkeleton                 const &rSkCh)
+{
+    auto const vbufNormalsView   = rGeom.vbufNormals.view(rGeom.vrtxBuffer, rChInfo.vrtxTotal);
+    auto const ibufSlice         = as_2d(rGeom.indxBuffer,             rChInfo.chunkMaxFaceCount).row(chunkId.value);
+    auto const fanNormalContrib  = as_2d(rGeom.chunkFanNormalContrib,  rChInfo.fanMaxSharedCount).row(chunkId.value);
+    auto const fillNormalContrib = as_2d(rGeom.chunkFillSharedNormals, rSkCh.m_chunkSharedCount) .row(chunkId.value);
+    auto const vbufFillNormals   = vbufNormalsView.sliceSize(rChInfo.vbufFillOffset + chunkId.value * rChInfo.fillVrtxCount, rChInfo.fillVrtxCount);
+
+    TerrainFaceWriter writer{
+        .vbufPos             = rGeom.vbufPositions.view_const(rGeom.vrtxBuffer, rChInfo.vrtxTotal),
+        .vbufNrm             = vbufNormalsView,
+        .sharedNormalSum     = rGeom.sharedNormalSum.base(),
+        .fillNormalContrib   = fillNormalContrib,
+        .fanNormalContrib    = fanNormalContrib,
+        .sharedUsed          = rSkCh.shared_vertices_used(chunkId),
+        .currentFace         = ibufSlice.begin(),
+        .contribLast         = fanNormalContrib.begin(),
+        .rSharedNormalsDirty = rChSP.sharedNormalsDirty
+    };
+
+    // These aren't cleaned up by the previous chunk that used them
+    std::fill(vbufFillNormals  .begin(), vbufFillNormals  .end(), Vector3{ZeroInit});
+    std::fill(fillNormalContrib.begin(), fillNormalContrib.end(), Vector3{ZeroInit});
+
+    auto const add_fill_tri = [&rSkCh, &rChInfo, &writer, chunkId]
+            (std::uint16_t const aX, std::uint16_t const aY,
+             std::uint16_t const bX, std::uint16_t const bY,
+             std::uint16_t const cX, std::uint16_t const cY)
+    {
+        auto const [shLocalA, vrtxA] = chunk_coord_to_vrtx(rSkCh, rChInfo, chunkId, aX, aY);
+        auto const [shLocalB, vrtxB] = chunk_coord_to_vrtx(rSkCh, rChInfo, chunkId, bX, bY);
+        auto const [shLocalC, vrtxC] = chunk_coord_to_vrtx(rSkCh, rChInfo, chunkId, cX, cY);
+
+        writer.fill_add_face(vrtxA, vrtxB, vrtxC);
+
+        shLocalA.has_value() ? writer.fill_add_normal_shared(vrtxA, shLocalA)
+                             : writer.fill_add_normal_filled(vrtxA);
+        shLocalB.has_value() ? writer.fill_add_normal_shared(vrtxB, shLocalB)
+                             : writer.fill_add_normal_filled(vrtxB);
+        shLocalC.has_value() ? writer.fill_add_normal_shared(vrtxC, shLocalC)
+                             : writer.fill_add_normal_filled(vrtxC);
+    };
+
+    for (unsigned int y = 0; y < rSkCh.m_chunkEdgeVrtxCount; ++y)
+    {
+        for (unsigned int x = 0; x < y; ++x)
+        {
+            // down-pointing
+            //                ( aX   aY )    ( aX   aY )    ( aX   aY )
+            add_fill_tri(      x+1, y+1,      x+1,  y,         x,  y      );
+
+            // up pointing
+            bool const onEdge = (x == y-1) || y == rSkCh.m_chunkEdgeVrtxCount - 1;
+            if ( ! onEdge )
+            {
+                //                ( aX   aY )    ( aX   aY )    ( aX   aY )
+                add_fill_tri(      x+1,  y,       x+1,  y+1,     x+2,  y+1   );
+            }
+        }
+    }
+
+    LGRN_ASSERTM(writer.currentFace == std::next(ibufSlice.begin(), rChInfo.fillFaceCount),
+                 "Code above must always add a known number of faces");
+
+    for (Vector3 &rNormal : vbufFillNormals)
+    {
+        rNormal = rNormal.normalized();
+    }
+}
+
+void write_fill_faces_gather(
+        ChunkId                       const chunkId,
+        BasicChunkMeshGeometry              &rGeom,
+        ChunkMeshBufferInfo           const &rChInfo,
+        ChunkScratchpad                     &rChSP,
+        ChunkSkeleton                 const &rSkCh)
+{
+    using VrtxFaces_t = ChunkFillFaceLUT::VrtxFaces_t;
+
+    ChunkFillFaceLUT const &lut = rChSP.fillFaceLut;
+
+    auto const faceCount  = std::uint32_t(lut.faces.size());
+    auto const fillOffset = rChInfo.vbufFillOffset + chunkId.value * rChInfo.fillVrtxCount;
+
+    LGRN_ASSERTM(faceCount == rChInfo.fillFaceCount, "fillFaceLut doesn't match chunk size");
+
+    auto const vbufPos           = rGeom.vbufPositions.view_const(rGeom.vrtxBuffer, rChInfo.vrtxTotal);
+    auto const vbufNrm           = rGeom.vbufNormals  .view      (rGeom.vrtxBuffer, rChInfo.vrtxTotal);
+    auto const ibufSlice         = as_2d(rGeom.indxBuffer,             rChInfo.chunkMaxFaceCount).row(chunkId.value);
+    auto const fillNormalContrib = as_2d(rGeom.chunkFillSharedNormals, rSkCh.m_chunkSharedCount) .row(chunkId.value);
+    auto const sharedUsed        = rSkCh.shared_vertices_used(chunkId);
+
+    ChunkScratchpad::GatherNormals &rTmp = rChSP.gatherNormals;
+    rTmp.gridPosX.resize(lut.gridVrtxCount);
+    rTmp.gridPosY.resize(lut.gridVrtxCount);
+    rTmp.gridPosZ.resize(lut.gridVrtxCount);
+    rTmp.gridVrtx.resize(lut.gridVrtxCount);
+
+    // +1 for the zero normal used to pad VrtxFaces_t
+    rTmp.faceNrmX.resize(faceCount + 1);
+    rTmp.faceNrmY.resize(faceCount + 1);
+    rTmp.faceNrmZ.resize(faceCount + 1);
+    rTmp.faceNrmX[faceCount] = 0.0f;
+    rTmp.faceNrmY[faceCount] = 0.0f;
+    rTmp.faceNrmZ[faceCount] = 0.0f;
+
+    // Gather positions of all of the chunk's vertices into the grid layout
+
+    for (std::uint32_t fill = 0; fill < rChInfo.fillVrtxCount; ++fill)
+    {
+        std::uint32_t const grid   = lut.fillToGrid[fill];
+        VertexIdx     const vertex = fillOffset + fill;
+        Vector3       const pos    = vbufPos[vertex];
+        rTmp.gridPosX[grid] = pos.x();
+        rTmp.gridPosY[grid] = pos.y();
+        rTmp.gridPosZ[grid] = pos.z();
+        rTmp.gridVrtx[grid] = vertex;
+    }
+
+    for (std::uint32_t local = 0; local < sharedUsed.size(); ++local)
+    {
+        std::uint32_t const grid   = lut.sharedToGrid[local];
+        VertexIdx     const vertex = rChInfo.vbufSharedOffset + sharedUsed[local].value().value;
+        Vector3       const pos    = vbufPos[vertex];
+        rTmp.gridPosX[grid] = pos.x();
+        rTmp.gridPosY[grid] = pos.y();
+        rTmp.gridPosZ[grid] = pos.z();
+        rTmp.gridVrtx[grid] = vertex;
+    }
+
+    // Write faces and calculate face normals. No branches; written so the compiler can vectorize
+
+    for (std::uint32_t face = 0; face < faceCount; ++face)
+    {
+        auto const [a, b, c] = lut.faces[face];
+
+        ibufSlice[face] = {rTmp.gridVrtx[a], rTmp.gridVrtx[b], rTmp.gridVrtx[c]};
+
+        float const ux = rTmp.gridPosX[b] - rTmp.gridPosX[a];
+        float const uy = rTmp.gridPosY[b] - rTmp.gridPosY[a];
+        float const uz = rTmp.gridPosZ[b] - rTmp.gridPosZ[a];
+        float const vx = rTmp.gridPosX[c] - rTmp.gridPosX[a];
+        float const vy = rTmp.gridPosY[c] - rTmp.gridPosY[a];
+        float const vz = rTmp.gridPosZ[c] - rTmp.gridPosZ[a];
+
+        float const nx = uy*vz - uz*vy;
+        float const ny = uz*vx - ux*vz;
+        float const nz = ux*vy - uy*vx;
+
+        float const invLength = 1.0f / std::sqrt(nx*nx + ny*ny + nz*nz);
+
+        rTmp.faceNrmX[face] = nx * invLength;
+        rTmp.faceNrmY[face] = ny * invLength;
+        rTmp.faceNrmZ[face] = nz * invLength;
+    }
+
+    auto const sum_faces = [&rTmp] (VrtxFaces_t const& vrtxFaces) noexcept -> Vector3
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        for (std::uint32_t const face : vrtxFaces)
+        {
+            x += rTmp.faceNrmX[face];
+            y += rTmp.faceNrmY[face];
+            z += rTmp.faceNrmZ[face];
+        }
+        return {x, y, z};
+    };
+
+    // Fill vertices only touch faces of this chunk, their normals are complete
+
+    for (std::uint32_t fill = 0; fill < rChInfo.fillVrtxCount; ++fill)
+    {
+        vbufNrm[fillOffset + fill] = sum_faces(lut.fillVrtxFaces[fill]).normalized();
+    }
+
+    // Shared vertices also touch faces of other chunks. Only these are reduced into
+    // sharedNormalSum, and recorded so they can be subtracted when this chunk is removed.
+
+    for (std::uint32_t local = 0; local < sharedUsed.size(); ++local)
+    {
+        VrtxFaces_t const& vrtxFaces = lut.sharedVrtxFaces[local];
+        if (vrtxFaces[0] == faceCount)
+        {
+            fillNormalContrib[local] = Vector3{ZeroInit};
+            continue; // Not touching any fill faces, such as the corners
+        }
+
+        SharedVrtxId const shared = sharedUsed[local].value();
+        Vector3      const sum    = sum_faces(vrtxFaces);
+
+        fillNormalContrib[local]        = sum;
+        rGeom.sharedNormalSum[shared]  += sum;
+        rChSP.sharedNormalsDirty.insert(shared);
+    }
 }
 
 void subtract_normal_contrib(
@@ -41,6 +41,23 @@ struct ChunkScratchpad
     /// Lookup table to help calculate 'Fill' vertices for chunks
     ChunkFillSubdivLUT lut;
 
+    /// Lookup table to calculate fill vertex normals, see write_fill_faces_gather
+    ChunkFillFaceLUT fillFaceLut;
+
+    /// Temporary per-chunk arrays used by write_fill_faces_gather. Structure-of-arrays, so face
+    /// and vertex normal loops can be vectorized.
+    struct GatherNormals
+    {
+        std::vector<float>      gridPosX;
+        std::vector<float>      gridPosY;
+        std::vector<float>      gridPosZ;
+        std::vector<VertexIdx>  gridVrtx;   ///< Vertex buffer index of each grid vertex
+
+        std::vector<float>      faceNrmX;
+        std::vector<float>      faceNrmY;
+        std::vector<float>      faceNrmZ;
+    } gatherNormals;
+
     /// Temporary vector for storing sections of shared vertices
     std::vector< osp::MaybeNewId<SkVrtxId> > edgeVertices;
 
@@ -74,7 +91,8 @@ void restitch_check(
  * @brief Write chunk fan and fill triangles to the index buffer.
  *
  * Fan triangles will be generated for newly added chunks. Fan triangles will be added or replaced
- * if a chunk command is enabled.
+ * if a chunk command is enabled. Modified faces and fill vertices are recorded to
+ * BasicChunkMeshGeometry::dirtyFaces and dirtyVrtx.
  */
 void update_faces(
         ChunkId                         chunkId,
@@ -87,6 +105,34 @@ void update_faces(
         ChunkScratchpad                 &rChSP,
         ChunkSkeleton                   &rSkCh);
 
+/**
+ * @brief Write a newly added chunk's fill faces and calculate their normals
+ *
+ * Fill vertex normals are written to the vertex buffer. Normal contributions to shared vertices
+ * are added to BasicChunkMeshGeometry::sharedNormalSum and chunkFillSharedNormals.
+ *
+ * Face normals are calculated first, then each vertex sums the faces it touches according to
+ * ChunkScratchpad::fillFaceLut. Shared vertices are the only ones written to outside the chunk.
+ */
+void write_fill_faces_gather(
+        ChunkId                         chunkId,
+        BasicChunkMeshGeometry          &rGeom,
+        ChunkMeshBufferInfo       const &rChInfo,
+        ChunkScratchpad                 &rChSP,
+        ChunkSkeleton             const &rSkCh);
+
+/**
+ * @brief Same outputs as write_fill_faces_gather, but each face adds its normal to its 3 vertices
+ *
+ * Kept as a reference for tests and benchmarks.
+ */
+void write_fill_faces_scatter(
+        ChunkId                         chunkId,
+        BasicChunkMeshGeometry          &rGeom,
+        ChunkMeshBufferInfo       const &rChInfo,
+        ChunkScratchpad                 &rChSP,
+        ChunkSkeleton             const &rSkCh);
+
 /**
  * @brief Subtract normals from connected shared vertices when removing a chunk, or fan triangles
  *        only if fans are being redone.
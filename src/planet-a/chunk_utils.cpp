@@ -25,10 +25,50 @@
 
 #include "chunk_utils.h"
 
+#include <algorithm>
 
 namespace planeta
 {
 
+void DirtyRanges::coalesce(std::uint32_t const maxGap)
+{
+    if (m_ranges.size() < 2)
+    {
+        return;
+    }
+
+    std::sort(m_ranges.begin(), m_ranges.end(), [] (Range const& lhs, Range const& rhs) noexcept
+    {
+        return lhs.first < rhs.first;
+    });
+
+    auto out = m_ranges.begin();
+    for (auto it = std::next(m_ranges.begin()); it != m_ranges.end(); ++it)
+    {
+        if (it->first <= out->last + maxGap)
+        {
+            out->last = std::max(out->last, it->last);
+        }
+        else
+        {
+            ++out;
+            *out = *it;
+        }
+    }
+
+    m_ranges.erase(std::next(out), m_ranges.end());
+}
+
+std::uint32_t DirtyRanges::element_count() const noexcept
+{
+    std::uint32_t total = 0;
+    for (Range const& range : m_ranges)
+    {
+        total += range.size();
+    }
+    return total;
+}
+
 ChunkFillSubdivLUT make_chunk_vrtx_subdiv_lut(std::uint8_t const subdivLevel)
 {
     ChunkFillSubdivLUT out;
@@ -51,6 +91,92 @@ ChunkFillSubdivLUT make_chunk_vrtx_subdiv_lut(std::uint8_t const subdivLevel)
     // by accessing to fill vertices in a more sequential order.
 }
 
+ChunkFillFaceLUT make_chunk_fill_face_lut(std::uint8_t const subdivLevel)
+{
+    using VrtxFaces_t = ChunkFillFaceLUT::VrtxFaces_t;
+
+    ChunkFillFaceLUT out;
+
+    std::uint32_t const width     = 1u << subdivLevel;
+    std::uint32_t const fillCount = (width-2) * (width-1) / 2;
+
+    out.gridVrtxCount = xy_to_triangular(0, width + 1);
+    out.fillToGrid  .resize(fillCount);
+    out.sharedToGrid.resize(std::size_t(width) * 3);
+
+    for (std::uint32_t y = 0; y <= width; ++y)
+    {
+        for (std::uint32_t x = 0; x <= y; ++x)
+        {
+            std::uint32_t      const grid   = xy_to_triangular(x, y);
+            ChunkLocalSharedId const shared = coord_to_shared(x, y, width);
+            if (shared.has_value())
+            {
+                out.sharedToGrid[shared.value] = grid;
+            }
+            else
+            {
+                out.fillToGrid[xy_to_triangular(x - 1, y - 2)] = grid;
+            }
+        }
+    }
+
+    // Same order as update_faces
+    auto const add_face = [&out] (std::uint32_t aX, std::uint32_t aY,
+                                  std::uint32_t bX, std::uint32_t bY,
+                                  std::uint32_t cX, std::uint32_t cY)
+    {
+        out.faces.push_back({xy_to_triangular(aX, aY), xy_to_triangular(bX, bY), xy_to_triangular(cX, cY)});
+    };
+
+    for (std::uint32_t y = 0; y < width; ++y)
+    {
+        for (std::uint32_t x = 0; x < y; ++x)
+        {
+            add_face(x+1, y+1,  x+1, y,    x,   y  ); // down-pointing
+
+            bool const onEdge = (x == y-1) || y == width - 1;
+            if ( ! onEdge )
+            {
+                add_face(x+1, y,    x+1, y+1,  x+2, y+1); // up pointing
+            }
+        }
+    }
+
+    auto const faceCount = std::uint32_t(out.faces.size());
+
+    VrtxFaces_t unused;
+    unused.fill(faceCount);
+
+    std::vector<VrtxFaces_t>  gridFaces     (out.gridVrtxCount, unused);
+    std::vector<std::uint8_t> gridFaceCount (out.gridVrtxCount, 0);
+
+    for (std::uint32_t face = 0; face < faceCount; ++face)
+    {
+        for (std::uint32_t const grid : out.faces[face])
+        {
+            std::uint8_t &rCount = gridFaceCount[grid];
+            LGRN_ASSERTM(rCount < ChunkFillFaceLUT::smc_maxVrtxFaces, "Too many faces touching a vertex");
+            gridFaces[grid][rCount] = face;
+            ++rCount;
+        }
+    }
+
+    out.fillVrtxFaces  .reserve(out.fillToGrid.size());
+    out.sharedVrtxFaces.reserve(out.sharedToGrid.size());
+
+    for (std::uint32_t const grid : out.fillToGrid)
+    {
+        out.fillVrtxFaces.push_back(gridFaces[grid]);
+    }
+    for (std::uint32_t const grid : out.sharedToGrid)
+    {
+        out.sharedVrtxFaces.push_back(gridFaces[grid]);
+    }
+
+    return out;
+}
+
 void ChunkFillSubdivLUT::subdiv_line_recurse(
         Vector2us const a, Vector2us const b, std::uint8_t const level)
 {
@@ -121,6 +121,92 @@ constexpr ChunkMeshBufferInfo make_chunk_mesh_buffer_info(ChunkSkeleton const &s
 
 //-----------------------------------------------------------------------------
 
+/**
+ * @brief Half-open [first, last) ranges of buffer elements that were modified
+ *
+ * Ranges can be added in any order, then coalesce() sorts and merges them. This lets whoever
+ * consumes chunk mesh buffers (GPU upload, serialization, ...) only copy what changed, instead of
+ * the entire vertex and index buffer.
+ */
+class DirtyRanges
+{
+public:
+
+    struct Range
+    {
+        constexpr std::uint32_t size() const noexcept { return last - first; }
+
+        friend bool operator==(Range const& lhs, Range const& rhs) = default;
+
+        std::uint32_t first;
+        std::uint32_t last;  ///< One past the last element
+    };
+
+    /**
+     * @brief Mark [first, first+count) as modified
+     */
+    void add(std::uint32_t const first, std::uint32_t const count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Cheap merge for sequential writes, which is the common case
+        if ( ! m_ranges.empty() && m_ranges.back().last == first )
+        {
+            m_ranges.back().last += count;
+        }
+        else
+        {
+            m_ranges.push_back({.first = first, .last = first + count});
+        }
+    }
+
+    /**
+     * @brief Sort and merge overlapping or touching ranges
+     *
+     * @param maxGap [in] Also merge ranges separated by this many or fewer untouched elements.
+     *                    Copying a few extra elements is often cheaper than an extra copy call.
+     */
+    void coalesce(std::uint32_t maxGap = 0);
+
+    void clear() noexcept { m_ranges.clear(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_ranges.empty(); }
+
+    /**
+     * @return Total number of elements covered by all ranges. Only accurate after coalesce().
+     */
+    [[nodiscard]] std::uint32_t element_count() const noexcept;
+
+    [[nodiscard]] std::vector<Range> const& ranges() const noexcept { return m_ranges; }
+
+private:
+    std::vector<Range> m_ranges;
+
+}; // class DirtyRanges
+
+/**
+ * @return Range of fill vertices owned by a chunk within the vertex buffer
+ */
+constexpr DirtyRanges::Range chunk_fill_vrtx_range(ChunkMeshBufferInfo const& info, ChunkId const chunkId) noexcept
+{
+    std::uint32_t const first = info.vbufFillOffset + info.fillVrtxCount * chunkId.value;
+    return { .first = first, .last = first + info.fillVrtxCount };
+}
+
+/**
+ * @return Range of faces owned by a chunk within the index buffer
+ */
+constexpr DirtyRanges::Range chunk_face_range(ChunkMeshBufferInfo const& info, ChunkId const chunkId) noexcept
+{
+    std::uint32_t const first = info.chunkMaxFaceCount * chunkId.value;
+    return { .first = first, .last = first + info.chunkMaxFaceCount };
+}
+
+//-----------------------------------------------------------------------------
+
 /**
  * Convert XY coordinates to a triangular number index
  *
@@ -241,6 +327,44 @@ private:
 
 ChunkFillSubdivLUT make_chunk_vrtx_subdiv_lut(std::uint8_t subdivLevel);
 
+/**
+ * @brief Connectivity of a chunk's fill faces, for calculating vertex normals by gathering
+ *
+ * Vertices are indexed by their place in the chunk's whole triangular grid, including shared
+ * vertices along the edges: xy_to_triangular(x, y) for 0 <= x <= y <= chunkWidth. Faces are in
+ * the same order as update_faces writes them to the index buffer.
+ *
+ * Knowing which faces touch each vertex ahead of time lets normals be summed per-vertex in a
+ * fixed-size loop, instead of each face adding its normal to its 3 vertices.
+ */
+struct ChunkFillFaceLUT
+{
+    /// Max number of faces that can touch a vertex in a regular triangle grid
+    static constexpr std::size_t smc_maxVrtxFaces = 6;
+
+    /// Faces touching a vertex. Unused slots are set to faces.size(), expected to be a zero normal
+    using VrtxFaces_t = std::array<std::uint32_t, smc_maxVrtxFaces>;
+
+    /// 3 grid vertices of each fill face
+    std::vector< std::array<std::uint32_t, 3> > faces;
+
+    /// Faces touching each fill vertex, indexed by fill vertex (triangular number)
+    std::vector<VrtxFaces_t>    fillVrtxFaces;
+
+    /// Faces touching each shared vertex, indexed by ChunkLocalSharedId
+    std::vector<VrtxFaces_t>    sharedVrtxFaces;
+
+    /// Grid vertex of each fill vertex
+    std::vector<std::uint32_t>  fillToGrid;
+
+    /// Grid vertex of each ChunkLocalSharedId
+    std::vector<std::uint32_t>  sharedToGrid;
+
+    std::uint32_t               gridVrtxCount{};
+};
+
+ChunkFillFaceLUT make_chunk_fill_face_lut(std::uint8_t subdivLevel);
+
 
 //-----------------------------------------------------------------------------
 
@@ -102,6 +102,13 @@ struct BasicChunkMeshGeometry
     /// Non-normalized sum of face normals of connected faces
     osp::KeyedVec<planeta::SharedVrtxId, osp::Vector3>  sharedNormalSum;
 
+    /// Vertices modified by the most recent chunk update, in units of vertices. A dirty vertex
+    /// means its position, normal, or both were written to.
+    DirtyRanges                                         dirtyVrtx;
+
+    /// Faces (elements of indxBuffer) modified by the most recent chunk update
+    DirtyRanges                                         dirtyFaces;
+
     /// Offset of vertex positions relative to the skeleton positions they were copied from
     /// "Chunk Mesh Vertex positions = to_float(skeleton positions + skelOffset)". This is intended
     /// to move the mesh's origin closer to the viewer, preventing floating point imprecision.
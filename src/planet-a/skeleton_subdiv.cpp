@@ -24,12 +24,22 @@
  */
 #include "skeleton_subdiv.h"
 
+#include <Corrade/Containers/ArrayViewStl.h>
+
+#include <algorithm>
+#include <latch>
+
+using osp::ArrayView;
 using osp::Vector3;
 using osp::Vector3l;
 
 namespace planeta
 {
 
+/// Handing work to another thread is only worth it for large batches. A distance test is only a
+/// few integer operations.
+static constexpr std::size_t gc_minDistanceTestsPerThread = 4096;
+
 void SkeletonSubdivScratchpad::resize(SubdivTriangleSkeleton &rSkel)
 {
     auto const triCapacity = rSkel.tri_group_ids().capacity() * 4;
@@ -522,6 +532,65 @@ SkTriGroupId subdivide(
 }
 
 
+void distance_test_near(
+        Vector3l                    const pos,
+        double                      const threshold,
+        ArrayView<SkTriId const>    const tris,
+        SkeletonVertexData          const &rSkData,
+        ArrayView<std::uint8_t>     const rNearOut) noexcept
+{
+    LGRN_ASSERT(tris.size() == rNearOut.size());
+
+    for (std::size_t i = 0; i < tris.size(); ++i)
+    {
+        rNearOut[i] = osp::is_distance_near(pos, rSkData.centers[tris[i]], threshold);
+    }
+}
+
+/**
+ * @brief Run distance_test_near over tris, split across workers if there's enough work
+ */
+static void distance_test_near_parallel(
+        Vector3l                    const pos,
+        double                      const threshold,
+        ArrayView<SkTriId const>    const tris,
+        SkeletonVertexData          const &rSkData,
+        ArrayView<std::uint8_t>     const rNearOut,
+        osp::WorkerPool                   &rWorkers)
+{
+    // Calling thread takes a slice too
+    std::size_t const sliceCount = std::clamp<std::size_t>(tris.size() / gc_minDistanceTestsPerThread, 1, rWorkers.thread_count() + 1);
+
+    if (sliceCount == 1)
+    {
+        distance_test_near(pos, threshold, tris, rSkData, rNearOut);
+        return;
+    }
+
+    std::size_t const sliceSize = (tris.size() + sliceCount - 1) / sliceCount;
+
+    auto const run_slice = [pos, threshold, tris, &rSkData, rNearOut, sliceSize] (std::size_t const index) noexcept
+    {
+        std::size_t const first = index * sliceSize;
+        std::size_t const count = std::min(sliceSize, tris.size() - first);
+        distance_test_near(pos, threshold, tris.sliceSize(first, count), rSkData, rNearOut.sliceSize(first, count));
+    };
+
+    std::latch done{std::ptrdiff_t(sliceCount - 1)};
+    for (std::size_t i = 1; i < sliceCount; ++i)
+    {
+        rWorkers.submit([&run_slice, &done, i]
+        {
+            run_slice(i);
+            done.count_down();
+        });
+    }
+
+    run_slice(0);
+
+    done.wait();
+}
+
 void subdivide_level_by_distance(
         Vector3l              const pos,
         std::uint8_t          const lvl,
@@ -541,15 +610,24 @@ void subdivide_level_by_distance(
         std::swap(rLvlSP.distanceTestProcessing, rLvlSP.distanceTestNext);
         rLvlSP.distanceTestNext.clear();
 
-        for (SkTriId const sktriId : rLvlSP.distanceTestProcessing)
+        std::vector<SkTriId> const &processing = rLvlSP.distanceTestProcessing;
+
+        // Distance test the whole batch first. This doesn't modify the skeleton, and a triangle's
+        // result doesn't depend on other triangles being subdivided, so it can be done in parallel.
+        rLvlSP.distanceTestNear.resize(processing.size());
+        distance_test_near_parallel(pos, rSP.distanceThresholdSubdiv[lvl], processing, rSkData,
+                                    rLvlSP.distanceTestNear, rSP.workers);
+        rSP.distanceCheckCount += std::uint32_t(processing.size());
+
+        // Commit subdivisions serially in list order, giving the same results as testing and
+        // subdividing one-by-one
+        for (std::size_t i = 0; i < processing.size(); ++i)
         {
-            Vector3l const center = rSkData.centers[sktriId];
+            SkTriId const sktriId = processing[i];
 
             LGRN_ASSERT(rSP.distanceTestDone.contains(sktriId));
-            bool const distanceNear = osp::is_distance_near(pos, center, rSP.distanceThresholdSubdiv[lvl]);
-            ++rSP.distanceCheckCount;
 
-            if (distanceNear)
+            if (rLvlSP.distanceTestNear[i] != 0)
             {
                 SkeletonTriangle &rTri = rSkel.tri_at(sktriId);
                 if (rTri.children.has_value())
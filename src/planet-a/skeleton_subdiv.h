@@ -32,6 +32,8 @@
 #include "skeleton.h"
 #include "geometry.h"
 
+#include <osp/tasks/worker_pool.h>
+
 namespace planeta
 {
 
@@ -39,6 +41,9 @@ struct SubdivScratchpadLevel
 {
     std::vector<planeta::SkTriId> distanceTestProcessing;
     std::vector<planeta::SkTriId> distanceTestNext;
+
+    /// Distance test results, parallel with distanceTestProcessing. Non-zero for near triangles.
+    std::vector<std::uint8_t>     distanceTestNear;
 };
 
 
@@ -85,9 +90,30 @@ struct SkeletonSubdivScratchpad
     osp::Vector3l viewerPosition;
 
     std::uint32_t distanceCheckCount{};
+
+    /// Large batches of distance tests in subdivide_level_by_distance are split across these
+    /// workers. Results are identical regardless of thread count. Runs serially if empty.
+    osp::WorkerPool workers;
 };
 
 
+/**
+ * @brief Distance test a list of triangles; writes non-zero to rNearOut for triangles closer
+ *        than threshold to pos
+ *
+ * This only reads skeleton data, and can safely run in parallel over non-overlapping slices.
+ *
+ * @param tris      [in] Triangles to test
+ * @param rNearOut  [out] Results parallel with tris, must be the same size
+ */
+void distance_test_near(
+        osp::Vector3l                   pos,
+        double                          threshold,
+        osp::ArrayView<SkTriId const>   tris,
+        SkeletonVertexData        const &rSkData,
+        osp::ArrayView<std::uint8_t>    rNearOut) noexcept;
+
+
 /**
  * @brief Selects triangles (within a subdiv level) that are too far away from pos
  *
@@ -136,6 +162,10 @@ SkTriGroupId subdivide(
 
 /**
  * @brief Subdivide all triangles (within a subdiv level) too close to pos
+ *
+ * Each batch of triangles is first distance-tested in parallel (see
+ * SkeletonSubdivScratchpad::workers), then near triangles are subdivided serially in the same
+ * order as the batch.
  */
 void subdivide_level_by_distance(
         osp::Vector3l                   pos,
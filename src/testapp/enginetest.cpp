@@ -148,6 +148,7 @@ entt::any make_scene(osp::Resources& rResources, osp::PkgId const pkg)
 
     rScene.m_scnRdr.m_needDrawTf.insert(cubeEnt);
     rScene.m_scnRdr.m_activeToDraw[cubeEnt] = cubeDraw;
+    rScene.m_scnRdr.m_drawTfChanged.push_back(cubeEnt);
     rScene.m_scnRdr.m_mesh[cubeDraw] = rScene.m_drawing.m_meshRefCounts.ref_add(meshCube);
     rScene.m_scnRdr.m_meshDirty.push_back(cubeDraw);
 
@@ -219,6 +220,10 @@ struct EngineTestRenderer
     // An ordered set of entities and draw function pointers intended to be
     // forward-rendered
     osp::draw::RenderGroup m_groupFwdOpaque;
+
+    // Entities of m_groupFwdOpaque sorted for drawing, rebuilt every frame
+    osp::draw::RenderQueue m_queueFwdOpaque;
+    osp::draw::DrawCommandBuffer m_cmdsFwdOpaque;
 };
 
 /**
@@ -235,9 +240,9 @@ void sync_test_scene(
     using namespace osp::draw;
     using namespace adera::shader;
 
-    rScene.m_scnRdr.m_drawTransform         .resize(rScene.m_scnRdr.m_drawIds.capacity());
-    rRenderer.m_sceneRenderGL.m_diffuseTexId.resize(rScene.m_scnRdr.m_drawIds.capacity());
-    rRenderer.m_sceneRenderGL.m_meshId      .resize(rScene.m_scnRdr.m_drawIds.capacity());
+    rScene.m_scnRdr.resize_draw();
+    rRenderer.m_sceneRenderGL.m_diffuseTexId.resize(rScene.m_scnRdr.m_drawCapacity);
+    rRenderer.m_sceneRenderGL.m_meshId      .resize(rScene.m_scnRdr.m_drawCapacity);
 
     // Assign or remove phong shaders from entities marked dirty
     sync_drawent_phong(rScene.m_matPhongDirty.cbegin(), rScene.m_matPhongDirty.cend(),
@@ -318,9 +323,11 @@ void render_test_scene(
                 | FramebufferClear::Stencil);
 
     // Forward Render fwd_opaque group to FBO
-    SysRenderGL::render_opaque(
-            rRenderer.m_groupFwdOpaque,
-            rScene.m_scnRdr.m_visible, viewProj);
+    SysRenderQueue::build(
+            rRenderer.m_queueFwdOpaque, rRenderer.m_groupFwdOpaque,
+            rScene.m_scnRdr.m_visible, rScene.m_scnRdr, viewProj, ERenderPass::Opaque);
+    SysDrawCommands::record(rRenderer.m_cmdsFwdOpaque, rRenderer.m_queueFwdOpaque, ERenderPass::Opaque);
+    SysRenderGL::render_opaque(rRenderer.m_cmdsFwdOpaque, viewProj);
 
     // Display FBO
     Texture2D &rFboColor = rRenderGl.m_texGl.get(rRenderGl.m_fboColor);
@@ -59,6 +59,8 @@ struct FIMagnumScene {
     struct DataIds {
         DataId scnRenderGl;
         DataId groupFwd;
+        DataId queueFwd;
+        DataId cmdsFwd;
         DataId camera;
     };
 
@@ -37,6 +37,8 @@
 #include <planet-a/activescene/terrain.h>
 
 #include <osp/activescene/basic_fn.h>
+#include <osp/drawing/culling.h>
+#include <osp/drawing/mesh_lod.h>
 #include <osp/drawing/drawing.h>
 #include <osp/universe/coordinates.h>
 #include <osp/universe/universe.h>
@@ -46,6 +48,8 @@
 #include <Magnum/GL/DefaultFramebuffer.h>
 #include <Magnum/GL/Renderer.h>
 
+#include <array>
+
 // for the 0xrrggbb_rgbf and angle literals
 using namespace Magnum::Math::Literals;
 
@@ -119,6 +123,8 @@ FeatureDef const ftrMagnumScene = feature_def("MagnumScene", [] (
 
     /* not used here */   rFB.data_emplace< ACtxSceneRenderGL > (magnumScn.di.scnRenderGl);
     /* not used here */   rFB.data_emplace< RenderGroup >       (magnumScn.di.groupFwd);
+    /* not used here */   rFB.data_emplace< RenderQueue >       (magnumScn.di.queueFwd);
+    /* not used here */   rFB.data_emplace< DrawCommandBuffer > (magnumScn.di.cmdsFwd);
     auto &rCamera       = rFB.data_emplace< Camera >            (magnumScn.di.camera);
 
     rCamera.m_far = 100000000.0f;
@@ -134,7 +140,7 @@ FeatureDef const ftrMagnumScene = feature_def("MagnumScene", [] (
         .args       ({ scnRender.di.scnRender, magnumScn.di.scnRenderGl })
         .func       ([] (ACtxSceneRender const &rScnRender, ACtxSceneRenderGL &rScnRenderGl) noexcept
     {
-        std::size_t const capacity = rScnRender.m_drawIds.capacity();
+        std::size_t const capacity = rScnRender.m_drawCapacity;
         rScnRenderGl.m_diffuseTexId   .resize(capacity);
         rScnRenderGl.m_meshId         .resize(capacity);
     });
@@ -247,19 +253,55 @@ FeatureDef const ftrMagnumScene = feature_def("MagnumScene", [] (
                     | FramebufferClear::Stencil);
     });
 
+    rFB.task()
+        .name       ("Select mesh levels of detail")
+        .run_on     ({windowApp.pl.sync(Run)})
+        .sync_with  ({scnRender.pl.mesh(Ready), scnRender.pl.entMesh(Modify), scnRender.pl.entMeshDirty(Modify_), scnRender.pl.drawEnt(Ready), scnRender.pl.drawEntResized(Done)})
+        .args       ({            comScn.di.drawing,            scnRender.di.scnRender,    scnRender.di.culling,     magnumScn.di.camera })
+        .func       ([] (ACtxDrawing &rDrawing, ACtxSceneRender &rScnRender, ACtxCulling const &rCulling, Camera const &rCamera) noexcept
+    {
+        // Uses the camera, draw transforms, and entities in view from the previous frame. This is
+        // fine since level changes are delayed by hysteresis anyways.
+        ViewProjMatrix viewProj{rCamera.m_transform.inverted(), rCamera.perspective()};
+
+        SysMeshLod::update(rScnRender, rDrawing, rCulling.inView, viewProj);
+    });
+
+    rFB.task()
+        .name       ("Frustum cull visible entities")
+        .run_on     ({scnRender.pl.render(Run)})
+        .sync_with  ({magnumScn.pl.camera(Ready), scnRender.pl.drawTransforms(UseOrRun), scnRender.pl.entMesh(Ready), scnRender.pl.mesh(Ready),
+                      scnRender.pl.culling(Modify_), scnRender.pl.drawEnt(Ready)})
+        .args       ({                  comScn.di.drawing,            scnRender.di.scnRender,    scnRender.di.culling,     magnumScn.di.camera })
+        .func       ([] (ACtxDrawing const &rDrawing, ACtxSceneRender const &rScnRender, ACtxCulling &rCulling, Camera const &rCamera) noexcept
+    {
+        ViewProjMatrix viewProj{rCamera.m_transform.inverted(), rCamera.perspective()};
+
+        SysCulling::update_bounds(rCulling, rScnRender, rDrawing);
+        SysCulling::cull(rCulling, frustum_from_view_proj(viewProj.m_viewProj), rScnRender.m_drawIds.capacity());
+    });
+
     rFB.task()
         .name       ("Render Entities")
         .run_on     ({scnRender.pl.render(Run)})
         .sync_with  ({scnRender.pl.group(Ready), scnRender.pl.groupEnts(Ready), magnumScn.pl.camera(Ready), scnRender.pl.drawTransforms(UseOrRun), scnRender.pl.entMesh(Ready), scnRender.pl.entTexture(Ready),
                       magnum.pl.entMeshGL(Ready), magnum.pl.entTextureGL(Ready),
-                      scnRender.pl.drawEnt(Ready)})
-        .args       ({            scnRender.di.scnRender,          magnum.di.renderGl,    magnumScn.di.groupFwd,     magnumScn.di.camera })
-        .func       ([] (ACtxSceneRender &rScnRender, RenderGL &rRenderGl, RenderGroup const &rGroupFwd, Camera const &rCamera) noexcept
+                      scnRender.pl.culling(UseOrRun), scnRender.pl.drawEnt(Ready)})
+        .args       ({            scnRender.di.scnRender,          magnum.di.renderGl,    magnumScn.di.groupFwd,    magnumScn.di.queueFwd,           magnumScn.di.cmdsFwd,     magnumScn.di.camera,   scnRender.di.culling,      mainApp.di.workerPool })
+        .func       ([] (ACtxSceneRender &rScnRender, RenderGL &rRenderGl, RenderGroup const &rGroupFwd, RenderQueue &rQueueFwd, DrawCommandBuffer &rCmdsFwd, Camera const &rCamera, ACtxCulling const &rCulling, osp::WorkerPool &rWorkers) noexcept
     {
         ViewProjMatrix viewProj{rCamera.m_transform.inverted(), rCamera.perspective()};
 
+        // Sort entities within the camera's view to reduce state changes, then record draw
+        // commands. Each RenderGroup is one job; only submitting needs the GL thread.
+        std::array const jobs
+        {
+            SysDrawCommands::RecordJob{&rGroupFwd, &rCulling.inView, ERenderPass::Opaque, &rQueueFwd, &rCmdsFwd}
+        };
+        SysDrawCommands::record_parallel(jobs, rScnRender, viewProj, rWorkers);
+
         // Forward Render fwd_opaque group to FBO
-        SysRenderGL::render_opaque(rGroupFwd, rScnRender.m_visible, viewProj);
+        SysRenderGL::render_opaque(rCmdsFwd, viewProj);
     });
 
     rFB.task()
@@ -602,6 +644,9 @@ FeatureDef const ftrTerrainDrawMagnum = feature_def("ShaderPhong", [] (
         .args       ({            scnRender.di.scnRender,             magnumScn.di.groupFwd,                         magnumScn.di.scnRenderGl,          magnum.di.renderGl,                   terrainMgn.di.drawTerrainGL,            terrain.di.terrain})
         .func([] (ACtxSceneRender &rScnRender, RenderGroup &rGroupFwd, ACtxSceneRenderGL const &rScnRenderGl, RenderGL &rRenderGl, ACtxDrawTerrainGL &rDrawTerrainGl, ACtxTerrain &rTerrain) noexcept
     {
+        auto const indxBuffer = arrayCast<unsigned char const>(rTerrain.chunkGeom.indxBuffer);
+        auto const vrtxBuffer = arrayView<std::byte const>(rTerrain.chunkGeom.vrtxBuffer);
+
         if ( ! rDrawTerrainGl.enabled )
         {
             rDrawTerrainGl.enabled = true;
@@ -621,21 +666,31 @@ FeatureDef const ftrTerrainDrawMagnum = feature_def("ShaderPhong", [] (
                  .addVertexBuffer(rDrawTerrainGl.vrtxBufGL, GLintptr(nrmFormat.offset), GLsizei(nrmFormat.stride - sizeof(Vector3u)), Magnum::Shaders::GenericGL3D::Normal{})
                  .setIndexBuffer(rDrawTerrainGl.indxBufGL, 0, Magnum::MeshIndexType::UnsignedInt)
                  .setCount(Magnum::Int(3*rTerrain.chunkInfo.faceTotal)); // 3 vertices in each triangle
-        }
-
-        auto const indxBuffer = arrayCast<unsigned char const>(rTerrain.chunkGeom.indxBuffer);
-        auto const vrtxBuffer = arrayView<std::byte const>(rTerrain.chunkGeom.vrtxBuffer);
 
-        // There's faster ways to sync the buffer, but keeping it simple for now
+            // Upload everything once, only dirty ranges are uploaded afterwards
+            rDrawTerrainGl.indxBufGL.setData(indxBuffer);
+            rDrawTerrainGl.vrtxBufGL.setData(vrtxBuffer);
+            return;
+        }
 
-        // see "Buffer re-specification" in
-        // https://www.khronos.org/opengl/wiki/Buffer_Object_Streaming
+        // Only upload parts of the buffers that were modified by the last chunk update
 
-        rDrawTerrainGl.indxBufGL.setData({nullptr, indxBuffer.size()});
-        rDrawTerrainGl.indxBufGL.setData(indxBuffer);
+        for (DirtyRanges::Range const range : rTerrain.chunkGeom.dirtyFaces.ranges())
+        {
+            std::size_t const offset = range.first * sizeof(Vector3u);
+            rDrawTerrainGl.indxBufGL.setSubData(GLintptr(offset), indxBuffer.sliceSize(offset, range.size() * sizeof(Vector3u)));
+        }
 
-        rDrawTerrainGl.vrtxBufGL.setData({nullptr, vrtxBuffer.size()});
-        rDrawTerrainGl.vrtxBufGL.setData(vrtxBuffer);
+        // Vertex buffer consists of separate position and normal blocks; upload the same range
+        // of vertices from each block.
+        for (DirtyRanges::Range const range : rTerrain.chunkGeom.dirtyVrtx.ranges())
+        {
+            for (BufAttribFormat<Vector3> const *pFormat : {&rTerrain.chunkGeom.vbufPositions, &rTerrain.chunkGeom.vbufNormals})
+            {
+                std::size_t const offset = pFormat->offset + range.first * std::size_t(pFormat->stride);
+                rDrawTerrainGl.vrtxBufGL.setSubData(GLintptr(offset), vrtxBuffer.sliceSize(offset, range.size() * std::size_t(pFormat->stride)));
+            }
+        }
     });
 
 }); // ftrShaderPhong
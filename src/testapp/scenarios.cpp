@@ -233,7 +233,8 @@ static ScenarioMap_t make_scenarios()
         .description = "Controls:\n"
                        "* [WASD]            - Move camera\n"
                        "* [QE]              - Move camera up/down\n"
-                       "* [Drag MouseRight] - Orbit camera\n",
+                       "* [Drag MouseRight] - Orbit camera\n"
+                       "* [Space]           - Throw spheres\n",
         .loadFunc = [] (TestApp& rTestApp)
     {
         auto        &rFW      = rTestApp.m_framework;
@@ -245,12 +246,22 @@ static ScenarioMap_t make_scenarios()
         ContextBuilder  sceneCB { sceneCtx, {rTestApp.m_mainContext}, rFW };
         sceneCB.add_feature(ftrScene);
         sceneCB.add_feature(ftrCommonScene, rTestApp.m_defaultPkg);
+        sceneCB.add_feature(ftrPhysics);
+        sceneCB.add_feature(ftrPhysicsShapes, osp::draw::MaterialId{0});
+
+        sceneCB.add_feature(ftrJolt);
+        sceneCB.add_feature(ftrJoltConstAccel);
+        sceneCB.add_feature(ftrPhysicsShapesJolt);
 
         sceneCB.add_feature(ftrTerrain);
         sceneCB.add_feature(ftrTerrainIcosahedron);
         sceneCB.add_feature(ftrTerrainSubdivDist);
+        sceneCB.add_feature(ftrTerrainCollidersJolt);
         ContextBuilder::finalize(std::move(sceneCB));
 
+        ospjolt::ForceFactors_t const gravity = add_constant_acceleration(sc_gravityForce, rFW, sceneCtx);
+        set_phys_shape_factors(gravity, rFW, sceneCtx);
+
         auto terrain = rFW.get_interface<FITerrain>(sceneCtx);
         auto &rTerrain = rFW.data_get<ACtxTerrain>(terrain.di.terrain);
         auto &rTerrainFrame = rFW.data_get<ACtxTerrainFrame>(terrain.di.terrainFrame);
@@ -277,7 +288,8 @@ static ScenarioMap_t make_scenarios()
         .description = "Controls:\n"
                        "* [WASD]            - Move camera\n"
                        "* [QE]              - Move camera up/down\n"
-                       "* [Drag MouseRight] - Orbit camera\n",
+                       "* [Drag MouseRight] - Orbit camera\n"
+                       "* [Space]           - Throw spheres\n",
         .loadFunc = [] (TestApp& rTestApp)
     {
         auto        &rFW      = rTestApp.m_framework;
@@ -289,12 +301,22 @@ static ScenarioMap_t make_scenarios()
         ContextBuilder  sceneCB { sceneCtx, {rTestApp.m_mainContext}, rFW };
         sceneCB.add_feature(ftrScene);
         sceneCB.add_feature(ftrCommonScene, rTestApp.m_defaultPkg);
+        sceneCB.add_feature(ftrPhysics);
+        sceneCB.add_feature(ftrPhysicsShapes, osp::draw::MaterialId{0});
+
+        sceneCB.add_feature(ftrJolt);
+        sceneCB.add_feature(ftrJoltConstAccel);
+        sceneCB.add_feature(ftrPhysicsShapesJolt);
 
         sceneCB.add_feature(ftrTerrain);
         sceneCB.add_feature(ftrTerrainIcosahedron);
         sceneCB.add_feature(ftrTerrainSubdivDist);
+        sceneCB.add_feature(ftrTerrainCollidersJolt);
         ContextBuilder::finalize(std::move(sceneCB));
 
+        ospjolt::ForceFactors_t const gravity = add_constant_acceleration(sc_gravityForce, rFW, sceneCtx);
+        set_phys_shape_factors(gravity, rFW, sceneCtx);
+
         auto terrain = rFW.get_interface<FITerrain>(sceneCtx);
         auto &rTerrain = rFW.data_get<ACtxTerrain>(terrain.di.terrain);
         auto &rTerrainFrame = rFW.data_get<ACtxTerrainFrame>(terrain.di.terrainFrame);
@@ -0,0 +1,365 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <osp/drawing/culling.h>
+#include <osp/drawing/mesh_lod.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace osp;
+using namespace osp::draw;
+
+/**
+ * @brief Scene with a single mesh instanced many times at random positions and scales
+ */
+struct CullScene
+{
+    CullScene(std::size_t count, float spread)
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> distPos(-spread, spread);
+        std::uniform_real_distribution<float> distScale(0.5f, 4.0f);
+
+        MeshId const mesh = drawing.m_meshIds.create();
+        drawing.m_meshRefCounts.resize(drawing.m_meshIds.capacity());
+        drawing.m_meshBounds.resize(drawing.m_meshIds.capacity());
+        drawing.m_meshBounds[mesh] = {.center = {0.0f, 0.0f, 1.0f}, .radius = 1.5f};
+
+        scnRender.m_drawIds.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            scnRender.m_drawIds.create();
+        }
+        scnRender.resize_draw();
+
+        for (DrawEnt const drawEnt : scnRender.m_drawIds)
+        {
+            scnRender.m_visible.insert(drawEnt);
+            scnRender.m_mesh[drawEnt] = drawing.m_meshRefCounts.ref_add(mesh);
+            scnRender.m_drawTransform[drawEnt]
+                    = Matrix4::translation({distPos(gen), distPos(gen), distPos(gen)})
+                    * Matrix4::scaling(Vector3{distScale(gen)});
+        }
+    }
+
+    ~CullScene()
+    {
+        for (MeshIdOwner_t &rOwner : scnRender.m_mesh)
+        {
+            if (rOwner.has_value())
+            {
+                drawing.m_meshRefCounts.ref_release(std::move(rOwner));
+            }
+        }
+    }
+
+    ACtxDrawing     drawing;
+    ACtxSceneRender scnRender;
+    ACtxCulling     culling;
+};
+
+Frustum test_frustum()
+{
+    Matrix4 const view = Matrix4::lookAt({0.0f, 0.0f, 0.0f}, {1.0f, 0.2f, -0.5f}, {0.0f, 1.0f, 0.0f}).inverted();
+    Matrix4 const proj = Matrix4::perspectiveProjection(Deg{60.0f}, 16.0f / 9.0f, 0.25f, 200.0f);
+    return frustum_from_view_proj(proj * view);
+}
+
+/// Reference sphere test without any acceleration structure
+bool sphere_touches(Frustum const& frustum, Vector3 const center, float const radius)
+{
+    for (Vector4 const& plane : frustum.planes)
+    {
+        if (Magnum::Math::dot(plane.xyz(), center) + plane.w() < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Test frustum planes extracted from a perspective projection
+TEST(Culling, FrustumPlanes)
+{
+    Matrix4 const proj = Matrix4::perspectiveProjection(Deg{90.0f}, 1.0f, 1.0f, 100.0f);
+    Frustum const frustum = frustum_from_view_proj(proj);
+
+    // Camera looks down -Z
+    EXPECT_TRUE (sphere_touches(frustum, {  0.0f, 0.0f,  -50.0f}, 0.0f));
+    EXPECT_FALSE(sphere_touches(frustum, {  0.0f, 0.0f,   50.0f}, 0.0f));  // behind
+    EXPECT_FALSE(sphere_touches(frustum, {  0.0f, 0.0f, -150.0f}, 0.0f));  // past far plane
+    EXPECT_FALSE(sphere_touches(frustum, {  0.0f, 0.0f,   -0.5f}, 0.0f));  // before near plane
+    EXPECT_FALSE(sphere_touches(frustum, {-20.0f, 0.0f,  -10.0f}, 0.0f));  // left of 45 degrees
+    EXPECT_TRUE (sphere_touches(frustum, {-20.0f, 0.0f,  -10.0f}, 8.0f));  // large radius reaches in
+
+    // Planes are normalized, so distances are in world units
+    for (Vector4 const& plane : frustum.planes)
+    {
+        EXPECT_NEAR(plane.xyz().length(), 1.0f, 1e-5f);
+    }
+    EXPECT_NEAR(Magnum::Math::dot(frustum.planes[4].xyz(), Vector3{0.0f, 0.0f, -3.0f}) + frustum.planes[4].w(), 2.0f, 1e-4f);
+}
+
+TEST(Culling, BoundingSphere)
+{
+    std::array<Vector3, 4> const positions{{{-1.0f, 0.0f, 0.0f}, {3.0f, 0.0f, 0.0f}, {1.0f, 2.0f, 0.0f}, {1.0f, -2.0f, 0.0f}}};
+    BoundingSphere const sphere = bounding_sphere(arrayView(positions));
+
+    for (Vector3 const& pos : positions)
+    {
+        EXPECT_LE((pos - sphere.center).length(), sphere.radius + 1e-5f);
+    }
+    EXPECT_NEAR(sphere.radius, 2.0f, 1e-5f);
+
+    // No positions gives infinite bounds, never culled
+    EXPECT_TRUE(std::isinf(bounding_sphere({}).radius));
+}
+
+// Test that the cluster hierarchy gives the same result as testing every entity individually
+TEST(Culling, MatchesBruteForce)
+{
+    CullScene scene{5000, 100.0f};
+
+    // One entity without a mesh and so without bounds
+    DrawEnt const noMesh = scene.scnRender.m_drawIds.create();
+    scene.scnRender.resize_draw();
+    scene.scnRender.m_visible.insert(noMesh);
+    scene.scnRender.m_drawTransform[noMesh] = Matrix4::translation({0.0f, 0.0f, 1000.0f});
+
+    // One entity that isn't visible at all
+    DrawEnt const hidden = *scene.scnRender.m_drawIds.begin();
+    scene.scnRender.m_visible.erase(hidden);
+
+    Frustum const frustum = test_frustum();
+
+    SysCulling::update_bounds(scene.culling, scene.scnRender, scene.drawing);
+    SysCulling::cull(scene.culling, frustum, scene.scnRender.m_drawIds.capacity());
+
+    std::size_t expectCount = 0;
+    for (DrawEnt const drawEnt : scene.scnRender.m_drawIds)
+    {
+        bool expectInView;
+        if ( ! scene.scnRender.m_visible.contains(drawEnt) )
+        {
+            expectInView = false;
+        }
+        else if ( ! scene.scnRender.m_mesh[drawEnt].has_value() )
+        {
+            expectInView = true;
+        }
+        else
+        {
+            Matrix4 const &tf = scene.scnRender.m_drawTransform[drawEnt];
+            expectInView = sphere_touches(frustum, tf.transformPoint({0.0f, 0.0f, 1.0f}), 1.5f * tf.scaling().x());
+        }
+
+        EXPECT_EQ(scene.culling.inView.contains(drawEnt), expectInView);
+        expectCount += expectInView ? 1 : 0;
+    }
+
+    EXPECT_TRUE(scene.culling.inView.contains(noMesh));
+    EXPECT_FALSE(scene.culling.inView.contains(hidden));
+    EXPECT_EQ(scene.culling.stats.entsInView, expectCount);
+
+    // Some clusters should be skipped without testing their entities
+    EXPECT_GT(scene.culling.stats.clustersOutside, 0u);
+    EXPECT_LT(scene.culling.stats.entsTested, scene.scnRender.m_visible.size());
+}
+
+TEST(MeshLod, SelectLevelHysteresis)
+{
+    MeshLodGroup group;
+    group.levels = {{MeshId(0), 0.2f}, {MeshId(1), 0.05f}, {MeshId(2), 0.0f}};
+
+    constexpr float sc_hysteresis = 0.1f;
+
+    EXPECT_EQ(SysMeshLod::select_level(group, 0, 0.5f,   sc_hysteresis), 0);
+    EXPECT_EQ(SysMeshLod::select_level(group, 0, 0.1f,   sc_hysteresis), 1);
+    EXPECT_EQ(SysMeshLod::select_level(group, 0, 0.01f,  sc_hysteresis), 2);
+    EXPECT_EQ(SysMeshLod::select_level(group, 2, 0.5f,   sc_hysteresis), 0);
+
+    // Just below the threshold, stay at the current level
+    EXPECT_EQ(SysMeshLod::select_level(group, 0, 0.19f,  sc_hysteresis), 0);
+    // Just above the threshold, stay at the lower level
+    EXPECT_EQ(SysMeshLod::select_level(group, 1, 0.21f,  sc_hysteresis), 1);
+    // Past the hysteresis band, switch
+    EXPECT_EQ(SysMeshLod::select_level(group, 0, 0.17f,  sc_hysteresis), 1);
+    EXPECT_EQ(SysMeshLod::select_level(group, 1, 0.23f,  sc_hysteresis), 0);
+}
+
+TEST(MeshLod, UpdateSwapsMeshes)
+{
+    CullScene scene{0, 0.0f};
+    ACtxDrawing     &rDrawing   = scene.drawing;
+    ACtxSceneRender &rScnRender = scene.scnRender;
+
+    MeshId const full   = *rDrawing.m_meshIds.begin();
+    MeshId const low    = rDrawing.m_meshIds.create();
+    rDrawing.m_meshRefCounts.resize(rDrawing.m_meshIds.capacity());
+    rDrawing.m_meshBounds   .resize(rDrawing.m_meshIds.capacity());
+    rDrawing.m_meshLods     .resize(rDrawing.m_meshIds.capacity());
+    rDrawing.m_meshLods[full].levels = {{full, 0.1f}, {low, 0.0f}};
+
+    DrawEnt const ent = rScnRender.m_drawIds.create();
+    rScnRender.resize_draw();
+    rScnRender.m_mesh[ent] = rDrawing.m_meshRefCounts.ref_add(full);
+
+    DrawEntSet_t ents;
+    ents.resize(rScnRender.m_drawIds.capacity());
+    ents.insert(ent);
+
+    ViewProjMatrix const viewProj{Matrix4{}, Matrix4::perspectiveProjection(Deg{90.0f}, 1.0f, 0.25f, 10000.0f)};
+
+    auto const place_at = [&rScnRender, ent] (float const distance)
+    {
+        // Scale the bounding sphere radius of 1.5 down to 1
+        rScnRender.m_drawTransform[ent] = Matrix4::translation({0.0f, 0.0f, -distance}) * Matrix4::scaling(Vector3{1.0f / 1.5f});
+    };
+
+    // Close, full detail. Not dirty since nothing changed.
+    place_at(5.0f);
+    SysMeshLod::update(rScnRender, rDrawing, ents, viewProj);
+    EXPECT_EQ(rScnRender.m_mesh[ent].value(), full);
+    EXPECT_TRUE(rScnRender.m_meshDirty.empty());
+
+    // Far, low detail
+    place_at(100.0f);
+    SysMeshLod::update(rScnRender, rDrawing, ents, viewProj);
+    EXPECT_EQ(rScnRender.m_mesh[ent].value(), low);
+    EXPECT_EQ(rScnRender.m_meshLod[ent].level, 1);
+    ASSERT_EQ(rScnRender.m_meshDirty.size(), 1u);
+    rScnRender.m_meshDirty.clear();
+
+    // Still far, nothing changes
+    SysMeshLod::update(rScnRender, rDrawing, ents, viewProj);
+    EXPECT_TRUE(rScnRender.m_meshDirty.empty());
+
+    // Back close, full detail again
+    place_at(5.0f);
+    SysMeshLod::update(rScnRender, rDrawing, ents, viewProj);
+    EXPECT_EQ(rScnRender.m_mesh[ent].value(), full);
+    EXPECT_EQ(rScnRender.m_meshDirty.size(), 1u);
+}
+
+TEST(SceneRender, PagedIdSet)
+{
+    DrawEntSet_t set;
+    set.resize(100);
+    EXPECT_EQ(set.size(), 100);
+    EXPECT_EQ(set.pages_allocated(), 0);
+    EXPECT_TRUE(set.empty());
+
+    std::array<DrawEnt, 5> const ents{DrawEnt(0), DrawEnt(63), DrawEnt(64), DrawEnt(99), DrawEnt(10000)};
+    for (DrawEnt const ent : ents)
+    {
+        EXPECT_TRUE(set.insert(ent));
+    }
+    EXPECT_FALSE(set.insert(DrawEnt(63)));
+
+    // Inserting past the end grows by pages, leaving the pages in between unallocated
+    EXPECT_EQ(set.size(), 10001);
+    EXPECT_EQ(set.pages_allocated(), 2);
+    EXPECT_EQ(set.count(), ents.size());
+    EXPECT_TRUE(std::equal(set.begin(), set.end(), ents.begin(), ents.end()));
+
+    EXPECT_FALSE(set.contains(DrawEnt(5000)));
+    EXPECT_FALSE(set.contains(DrawEnt(20000)));
+    EXPECT_FALSE(set.erase(DrawEnt(20000)));
+    EXPECT_TRUE(set.erase(DrawEnt(64)));
+    EXPECT_FALSE(set.contains(DrawEnt(64)));
+
+    // Shrinking drops IDs past the new size
+    set.resize(64);
+    EXPECT_EQ(set.count(), 2);
+    EXPECT_FALSE(set.contains(DrawEnt(99)));
+
+    set.clear();
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(set.size(), 64);
+}
+
+TEST(SceneRender, ResizeDrawGrowsGeometrically)
+{
+    ACtxSceneRender scnRender;
+
+    int reallocations = 0;
+    for (int i = 0; i < 10000; ++i)
+    {
+        DrawEnt const ent = scnRender.m_drawIds.create();
+        std::size_t const capacityBefore = scnRender.m_drawCapacity;
+        scnRender.resize_draw();
+        reallocations += (scnRender.m_drawCapacity != capacityBefore);
+
+        ASSERT_LT(std::size_t(ent), scnRender.m_drawTransform.size());
+        ASSERT_LT(std::size_t(ent), scnRender.m_visible.size());
+    }
+
+    EXPECT_LE(reallocations, 16);
+}
+
+// Run manually with --gtest_also_run_disabled_tests
+TEST(Culling, DISABLED_BenchmarkCull)
+{
+    using Clock_t = std::chrono::steady_clock;
+
+    constexpr int           sc_iterations   = 50;
+    constexpr std::size_t   sc_entities     = 100000;
+
+    CullScene scene{sc_entities, 500.0f};
+    Frustum const frustum = test_frustum();
+
+    auto const measure = [] (auto&& update) -> double
+    {
+        update(); // warm up
+        auto const start = Clock_t::now();
+        for (int i = 0; i < sc_iterations; ++i)
+        {
+            update();
+        }
+        std::chrono::duration<double, std::milli> const total = Clock_t::now() - start;
+        return total.count() / sc_iterations;
+    };
+
+    double const boundsMs = measure([&scene] { SysCulling::update_bounds(scene.culling, scene.scnRender, scene.drawing); });
+    double const cullMs   = measure([&scene, &frustum] { SysCulling::cull(scene.culling, frustum, scene.scnRender.m_drawIds.capacity()); });
+
+    std::vector<std::uint8_t> results(scene.culling.ents.size());
+    double const flatMs   = measure([&scene, &frustum, &results]
+    {
+        SysCulling::test_spheres(frustum, arrayView(scene.culling.posX), arrayView(scene.culling.posY),
+                                 arrayView(scene.culling.posZ), arrayView(scene.culling.radius), arrayView(results));
+    });
+
+    std::cout << "Culling " << sc_entities << " entities, " << scene.culling.stats.entsInView << " in view\n"
+              << "  update bounds:         " << boundsMs << "ms\n"
+              << "  cull with clusters:    " << cullMs   << "ms\n"
+              << "  test all spheres only: " << flatMs   << "ms\n";
+}
@@ -0,0 +1,779 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * @brief Physics stepping and interpolation, and headless physics scenes built from the
+ *        application's features, without a window
+ *
+ * Benchmarks are disabled by default, run with
+ * --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+ *
+ * Shape counts can be set with the OSP_BENCH_SPHERES, OSP_BENCH_BOXES, OSP_BENCH_CYLINDERS and
+ * OSP_BENCH_FRAMES environment variables.
+ */
+
+#include <adera_app/application.h>
+#include <adera_app/feature_interfaces.h>
+#include <adera_app/features/common.h>
+#include <adera_app/features/jolt.h>
+#include <adera_app/features/physics.h>
+#include <adera_app/features/shapes.h>
+
+#include <ospjolt/activescene/joltinteg.h>
+#include <ospjolt/activescene/joltinteg_fn.h>
+#include <ospnewton/activescene/newtoninteg_fn.h>
+
+#include <osp/activescene/basic.h>
+#include <osp/activescene/physics_fn.h>
+#include <osp/core/Resources.h>
+#include <osp/drawing/own_restypes.h>
+#include <osp/framework/builder.h>
+#include <osp/framework/executor.h>
+#include <osp/scientific/shapes.h>
+#include <osp/util/logging.h>
+
+#include <Magnum/Trade/MeshData.h>
+
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+using namespace adera;
+using namespace ftr_inter;
+using namespace osp;
+using namespace osp::active;
+using namespace osp::fw;
+
+using Clock_t = std::chrono::steady_clock;
+using Millis_t = std::chrono::duration<double, std::milli>;
+
+constexpr Vector3 sc_gravity{0.0f, 0.0f, -9.81f};
+
+static int bench_param(char const* name, int const defaultValue)
+{
+    char const* const value = std::getenv(name);
+    return (value != nullptr) ? std::atoi(value) : defaultValue;
+}
+
+/**
+ * @return Resident set size of this process in bytes, or 0 if unsupported on this platform
+ */
+static std::size_t resident_memory_bytes()
+{
+#if defined(__linux__)
+    std::ifstream statm{"/proc/self/statm"};
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    statm >> totalPages >> residentPages;
+    return residentPages * std::size_t(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @return Change in resident memory in KiB. Negative if pages were released in between.
+ */
+static std::int64_t memory_delta_kib(std::size_t const before, std::size_t const after)
+{
+    return (std::int64_t(after) - std::int64_t(before)) / 1024;
+}
+
+/**
+ * @brief Make a static floor followed by dynamic shapes arranged in a cube lattice above it
+ */
+static std::vector<SpawnShape> make_shape_grid(int const spheres, int const boxes, int const cylinders)
+{
+    constexpr float sc_spacing = 2.0f;
+
+    int const total = spheres + boxes + cylinders;
+    int const side  = std::max(1, int(std::ceil(std::cbrt(float(total)))));
+
+    std::vector<SpawnShape> out;
+    out.reserve(std::size_t(total) + 1);
+
+    out.push_back({
+        .m_position = {0.0f, 0.0f, -1.0f},
+        .m_velocity = {0.0f, 0.0f, 0.0f},
+        .m_size     = {1000.0f, 1000.0f, 1.0f},
+        .m_mass     = 0.0f,
+        .m_shape    = EShape::Box });
+
+    for (int i = 0; i < total; ++i)
+    {
+        EShape const shape = (i < spheres)         ? EShape::Sphere
+                           : (i < spheres + boxes) ? EShape::Box
+                           :                         EShape::Cylinder;
+
+        float const offset = float(side - 1) * sc_spacing * 0.5f;
+
+        out.push_back({
+            .m_position = { float(i % side)          * sc_spacing - offset,
+                            float(i / side % side)   * sc_spacing - offset,
+                            float(i / (side * side)) * sc_spacing + 1.0f },
+            .m_velocity = {0.0f, 0.0f, 0.0f},
+            .m_size     = {0.5f, 0.5f, 0.5f},
+            .m_mass     = 1.0f,
+            .m_shape    = shape });
+    }
+
+    return out;
+}
+
+/**
+ * @brief Main and scene contexts with the same physics features as the 'physics' scenario, but
+ *        without a window or renderer
+ */
+struct JoltScene
+{
+    JoltScene()
+    {
+        using namespace osp::restypes;
+
+        mainCtx = fw.m_contextIds.create();
+        ContextBuilder mainCB { mainCtx, {}, fw };
+        mainCB.add_feature(ftrMain);
+        ContextBuilder::finalize(std::move(mainCB));
+
+        auto const mainApp  = fw.get_interface<FIMainApp>(mainCtx);
+        auto &rResources    = fw.data_get<Resources>(mainApp.di.resources);
+        rResources.resize_types(ResTypeIdReg_t::size());
+        rResources.data_register<Magnum::Trade::MeshData>(gc_mesh);
+        PkgId const pkg = rResources.pkg_create();
+
+        // CommonScene looks these up by name. Nothing is drawn, so they can be left without data.
+        for (char const* name : {"cube", "cylinder", "sphere", "grid64solid"})
+        {
+            [[maybe_unused]] ResId const meshId = rResources.create(gc_mesh, pkg, SharedString::create(name));
+        }
+
+        sceneCtx = fw.m_contextIds.create();
+        fw.data_get<AppContexts>(mainApp.di.appContexts).scene = sceneCtx;
+
+        ContextBuilder sceneCB { sceneCtx, {mainCtx}, fw };
+        sceneCB.add_feature(ftrScene);
+        sceneCB.add_feature(ftrCommonScene, pkg);
+        sceneCB.add_feature(ftrPhysics);
+        sceneCB.add_feature(ftrPhysicsShapes);
+        sceneCB.add_feature(ftrJolt);
+        sceneCB.add_feature(ftrJoltConstAccel);
+        sceneCB.add_feature(ftrPhysicsShapesJolt);
+        ContextBuilder::finalize(std::move(sceneCB));
+
+        set_phys_shape_factors(add_constant_acceleration(sc_gravity, fw, sceneCtx), fw, sceneCtx);
+
+        executor.load(fw);
+        executor.run(fw, mainApp.pl.mainLoop);
+    }
+
+    JoltScene(JoltScene const& copy) = delete;
+    JoltScene(JoltScene&& move) = delete;
+
+    ~JoltScene()
+    {
+        auto const mainApp = fw.get_interface<FIMainApp>(mainCtx);
+        fw.data_get<MainLoopControl>(mainApp.di.mainLoopCtrl).doUpdate = false;
+        executor.signal(fw, mainApp.pl.mainLoop);
+        executor.wait(fw);
+
+        auto const cleanup = fw.get_interface<FICleanupContext>(sceneCtx);
+        executor.run(fw, cleanup.pl.cleanup);
+        executor.wait(fw);
+    }
+
+    /**
+     * @brief Run one iteration of the main loop, updating the scene by deltaTime
+     */
+    void update(float const deltaTime)
+    {
+        auto const mainApp  = fw.get_interface<FIMainApp>(mainCtx);
+        auto const scene    = fw.get_interface<FIScene>(sceneCtx);
+
+        fw.data_get<MainLoopControl> (mainApp.di.mainLoopCtrl).doUpdate     = true;
+        fw.data_get<SceneLoopControl>(scene.di.loopControl)   .doSceneUpdate = true;
+        fw.data_get<float>           (scene.di.deltaTimeIn)                  = deltaTime;
+
+        executor.signal(fw, mainApp.pl.mainLoop);
+        executor.wait(fw);
+    }
+
+    ACtxPhysShapes& phys_shapes()
+    {
+        return fw.data_get<ACtxPhysShapes>(fw.get_interface<FIPhysShapes>(sceneCtx).di.physShapes);
+    }
+
+    float fixed_step()
+    {
+        return fw.data_get<ACtxPhysStepper>(fw.get_interface<FIPhysics>(sceneCtx).di.stepper).fixedStep;
+    }
+
+    Framework               fw;
+    SingleThreadedExecutor  executor;
+    ContextId               mainCtx;
+    ContextId               sceneCtx;
+};
+
+static void setup_logger()
+{
+    auto pSink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    osp::set_thread_logger(std::make_shared<spdlog::logger>("physics", pSink));
+}
+
+//-----------------------------------------------------------------------------
+
+// Spawn a few shapes through the PhysicsShapes feature and let them fall onto the floor
+TEST(Physics, JoltShapesFall)
+{
+    setup_logger();
+
+    JoltScene scene;
+    float const fixedStep = scene.fixed_step();
+
+    scene.phys_shapes().m_spawnRequest = make_shape_grid(2, 2, 2);
+    scene.update(fixedStep);
+
+    ACtxPhysShapes const &rPhysShapes = scene.phys_shapes();
+    ASSERT_TRUE(rPhysShapes.m_spawnRequest.empty());
+
+    auto const scnCommon    = scene.fw.get_interface<FICommonScene>(scene.sceneCtx);
+    auto const jolt         = scene.fw.get_interface<FIJolt>(scene.sceneCtx);
+    auto const &rBasic      = scene.fw.data_get<ACtxBasic>(scnCommon.di.basic);
+    auto const &rJolt       = scene.fw.data_get<ospjolt::ACtxJoltWorld>(jolt.di.jolt);
+
+    // Floor + 6 shapes
+    EXPECT_EQ(rJolt.m_pPhysicsSystem->GetNumBodies(), 7u);
+
+    std::vector<std::pair<ActiveEnt, float>> startHeights;
+    for (ActiveEnt const ent : rPhysShapes.ownedEnts)
+    {
+        float const z = rBasic.m_transform.get(ent).m_transform.translation().z();
+        if (z > 0.0f) // skip floor
+        {
+            startHeights.emplace_back(ent, z);
+        }
+    }
+    ASSERT_EQ(startHeights.size(), 6u);
+
+    for (int i = 0; i < 120; ++i)
+    {
+        scene.update(fixedStep);
+    }
+
+    for (auto const [ent, startZ] : startHeights)
+    {
+        float const z = rBasic.m_transform.get(ent).m_transform.translation().z();
+        EXPECT_LT(z, startZ);
+        EXPECT_GT(z, -1.0f);
+    }
+}
+
+// Shift the scene origin while a body sleeps, on a frame that doesn't step physics
+TEST(Physics, JoltOriginShiftSleeping)
+{
+    setup_logger();
+
+    JoltScene scene;
+    float const fixedStep = scene.fixed_step();
+
+    scene.phys_shapes().m_spawnRequest = make_shape_grid(0, 1, 0);
+    scene.update(fixedStep);
+
+    auto const scnCommon    = scene.fw.get_interface<FICommonScene>(scene.sceneCtx);
+    auto const phys         = scene.fw.get_interface<FIPhysics>(scene.sceneCtx);
+    auto const jolt         = scene.fw.get_interface<FIJolt>(scene.sceneCtx);
+    auto const &rBasic      = scene.fw.data_get<ACtxBasic>(scnCommon.di.basic);
+    auto &rPhys             = scene.fw.data_get<ACtxPhysics>(phys.di.phys);
+    auto const &rJolt       = scene.fw.data_get<ospjolt::ACtxJoltWorld>(jolt.di.jolt);
+
+    ActiveEnt box = lgrn::id_null<ActiveEnt>();
+    for (ActiveEnt const ent : scene.phys_shapes().ownedEnts)
+    {
+        if (rBasic.m_transform.get(ent).m_transform.translation().z() > 0.0f) // skip floor
+        {
+            box = ent;
+        }
+    }
+    ASSERT_NE(box, lgrn::id_null<ActiveEnt>());
+
+    JPH::BodyID const boxBody = ospjolt::BToJolt(rJolt.m_entToBody.at(box));
+    JPH::BodyInterface const &bodyInterface = rJolt.m_pPhysicsSystem->GetBodyInterface();
+
+    // Let the box land on the floor and fall asleep
+    for (int i = 0; i < 600 && bodyInterface.IsActive(boxBody); ++i)
+    {
+        scene.update(fixedStep);
+    }
+    ASSERT_FALSE(bodyInterface.IsActive(boxBody));
+
+    Vector3 const before = rBasic.m_transform.get(box).m_transform.translation();
+
+    Vector3 const translate{100.0f, -50.0f, 25.0f};
+    rPhys.m_originTranslate = translate;
+    scene.update(0.0f);
+
+    Vector3 const after = rBasic.m_transform.get(box).m_transform.translation();
+    EXPECT_NEAR(after.x(), before.x() + translate.x(), 1e-3f);
+    EXPECT_NEAR(after.y(), before.y() + translate.y(), 1e-3f);
+    EXPECT_NEAR(after.z(), before.z() + translate.z(), 1e-3f);
+
+    EXPECT_FALSE(bodyInterface.IsActive(boxBody));
+    Vector3 const bodyPos = ospjolt::Vec3JoltToMagnum(bodyInterface.GetPosition(boxBody));
+    EXPECT_NEAR(bodyPos.z(), after.z(), 1e-3f);
+}
+
+static std::vector<Vector3> positions_of(ACompTransformStorage_t const& tf, ActiveEntSet_t const& ents)
+{
+    std::vector<Vector3> out;
+    for (ActiveEnt const ent : ents)
+    {
+        out.push_back(tf.get(ent).m_transform.translation());
+    }
+    return out;
+}
+
+// Stepping after restoring a snapshot must give the same results as stepping after saving it
+TEST(Physics, JoltSnapshotRestore)
+{
+    using ospjolt::SysJolt;
+
+    setup_logger();
+
+    JoltScene scene;
+    float const fixedStep = scene.fixed_step();
+
+    auto const scnCommon    = scene.fw.get_interface<FICommonScene>(scene.sceneCtx);
+    auto const phys         = scene.fw.get_interface<FIPhysics>(scene.sceneCtx);
+    auto const jolt         = scene.fw.get_interface<FIJolt>(scene.sceneCtx);
+    auto &rBasic            = scene.fw.data_get<ACtxBasic>(scnCommon.di.basic);
+    auto &rJolt             = scene.fw.data_get<ospjolt::ACtxJoltWorld>(jolt.di.jolt);
+
+    // Transforms are written straight from the world, so they don't depend on interpolation state
+    scene.fw.data_get<ACtxPhysInterp>(phys.di.interp).enabled = false;
+
+    scene.phys_shapes().m_spawnRequest = make_shape_grid(3, 3, 3);
+    for (int i = 0; i < 10; ++i)
+    {
+        scene.update(fixedStep);
+    }
+
+    ActiveEntSet_t const &ents = scene.phys_shapes().ownedEnts;
+
+    ospjolt::JoltSnapshot snapshot;
+    SysJolt::save_snapshot(rJolt, snapshot);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        scene.update(fixedStep);
+    }
+    std::vector<Vector3> const expected = positions_of(rBasic.m_transform, ents);
+
+    ASSERT_TRUE(SysJolt::restore_snapshot(rJolt, snapshot, rBasic.m_transform, rBasic.m_scnGraph.m_transformDirty));
+    EXPECT_EQ(rJolt.m_pPhysicsSystem->GetNumBodies(), 28u);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        scene.update(fixedStep);
+    }
+    std::vector<Vector3> const restored = positions_of(rBasic.m_transform, ents);
+
+    ASSERT_EQ(restored.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_NEAR((restored[i] - expected[i]).length(), 0.0f, 1e-3f);
+    }
+
+    // Bodies without an ActiveEnt (like terrain colliders) aren't in snapshots. Restoring must
+    // fail and leave the world as is.
+    ospjolt::BodyId const foreign = rJolt.m_bodyIds.create();
+    EXPECT_FALSE(SysJolt::restore_snapshot(rJolt, snapshot, rBasic.m_transform, rBasic.m_scnGraph.m_transformDirty));
+    EXPECT_TRUE(rJolt.m_bodyIds.exists(foreign));
+    EXPECT_EQ(rJolt.m_pPhysicsSystem->GetNumBodies(), 28u);
+    rJolt.m_bodyIds.remove(foreign);
+}
+
+// Test fixed step counts, dropped steps, and the interpolation factor of the stepper
+TEST(Physics, AccumulateSteps)
+{
+    constexpr float sc_step = 1.0f / 64.0f; // exact in binary
+
+    ACtxPhysStepper stepper{ .fixedStep = sc_step, .maxSubsteps = 4 };
+
+    // No time passed
+    EXPECT_EQ(SysPhysics::accumulate(stepper, 0.0f), 0);
+    EXPECT_EQ(stepper.substeps, 0);
+    EXPECT_EQ(stepper.alpha, 0.0f);
+
+    // Less than a step
+    EXPECT_EQ(SysPhysics::accumulate(stepper, sc_step * 0.5f), 0);
+    EXPECT_EQ(stepper.alpha, 0.5f);
+
+    // Remainder from before adds up to whole steps
+    EXPECT_EQ(SysPhysics::accumulate(stepper, sc_step * 2.5f), 3);
+    EXPECT_EQ(stepper.substeps, 3);
+    EXPECT_EQ(stepper.alpha, 0.0f);
+
+    // Steps beyond maxSubsteps are dropped, but the remainder is kept
+    EXPECT_EQ(SysPhysics::accumulate(stepper, sc_step * 10.25f), 4);
+    EXPECT_EQ(stepper.accumulator, sc_step * 0.25f);
+    EXPECT_EQ(stepper.alpha, 0.25f);
+
+    EXPECT_EQ(SysPhysics::accumulate(stepper, 0.0f), 0);
+    EXPECT_EQ(stepper.alpha, 0.25f);
+
+    // Frame times that don't divide evenly into steps
+    ACtxPhysStepper uneven{ .fixedStep = 1.0f / 60.0f, .maxSubsteps = 4 };
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> distDelta(0.0f, 0.1f);
+    for (int i = 0; i < 10000; ++i)
+    {
+        int const substeps = SysPhysics::accumulate(uneven, (i % 3 == 0) ? (1.0f / 60.0f) : distDelta(gen));
+        EXPECT_GE(substeps, 0);
+        EXPECT_LE(substeps, uneven.maxSubsteps);
+        EXPECT_GE(uneven.accumulator, 0.0f);
+        EXPECT_LT(uneven.accumulator, uneven.fixedStep);
+        EXPECT_GE(uneven.alpha, 0.0f);
+        EXPECT_LT(uneven.alpha, 1.0f);
+    }
+}
+
+// Test that recorded bodies are interpolated, and written at rest once they stop being recorded
+TEST(Physics, InterpApply)
+{
+    ACtxBasic       basic;
+    ACtxPhysInterp  interp;
+    ActiveEntSet_t  tfDirty;
+
+    std::array<ActiveEnt, 3> ents;
+    for (ActiveEnt &rEnt : ents)
+    {
+        rEnt = basic.m_activeIds.create();
+        basic.m_transform.emplace(rEnt, ACompTransform{});
+    }
+    tfDirty.resize(basic.m_activeIds.capacity());
+
+    auto const position = [&basic] (ActiveEnt const ent)
+    {
+        return basic.m_transform.get(ent).m_transform.translation();
+    };
+
+    // Nothing recorded, nothing written
+    SysPhysics::interp_apply(interp, 0.5f, basic.m_transform, tfDirty);
+    for (ActiveEnt const ent : ents)
+    {
+        EXPECT_FALSE(tfDirty.contains(ent));
+    }
+
+    for (float const x : {0.0f, 2.0f})
+    {
+        SysPhysics::interp_begin_step(interp);
+        for (ActiveEnt const ent : ents)
+        {
+            SysPhysics::interp_record(interp, ent, Matrix4::translation({x, 0.0f, 0.0f}));
+        }
+    }
+    ASSERT_EQ(interp.moving.size(), 3u);
+
+    SysPhysics::interp_apply(interp, 0.25f, basic.m_transform, tfDirty);
+    for (ActiveEnt const ent : ents)
+    {
+        EXPECT_EQ(position(ent), Vector3(0.5f, 0.0f, 0.0f));
+        EXPECT_TRUE(tfDirty.contains(ent));
+    }
+
+    // ents[0] keeps moving, the others stop being recorded (eg. asleep)
+    SysPhysics::interp_begin_step(interp);
+    SysPhysics::interp_record(interp, ents[0], Matrix4::translation({4.0f, 0.0f, 0.0f}));
+
+    tfDirty.clear();
+    SysPhysics::interp_apply(interp, 0.5f, basic.m_transform, tfDirty);
+    EXPECT_EQ(position(ents[0]), Vector3(3.0f, 0.0f, 0.0f));
+    EXPECT_EQ(position(ents[1]), Vector3(2.0f, 0.0f, 0.0f));
+    EXPECT_EQ(position(ents[2]), Vector3(2.0f, 0.0f, 0.0f));
+    for (ActiveEnt const ent : ents)
+    {
+        EXPECT_TRUE(tfDirty.contains(ent));
+    }
+    ASSERT_EQ(interp.moving.size(), 1u);
+    EXPECT_EQ(interp.moving[0], ents[0]);
+
+    // Bodies at rest are not visited again
+    tfDirty.clear();
+    SysPhysics::interp_apply(interp, 0.75f, basic.m_transform, tfDirty);
+    EXPECT_TRUE(tfDirty.contains(ents[0]));
+    EXPECT_FALSE(tfDirty.contains(ents[1]));
+    EXPECT_FALSE(tfDirty.contains(ents[2]));
+
+    // Recording again makes them move again
+    SysPhysics::interp_begin_step(interp);
+    for (ActiveEnt const ent : ents)
+    {
+        SysPhysics::interp_record(interp, ent, Matrix4::translation({6.0f, 0.0f, 0.0f}));
+    }
+    EXPECT_EQ(interp.moving.size(), 3u);
+
+    // Deleted entities are removed from moving
+    std::array const deleted{ents[0], ents[2]};
+    SysPhysics::update_delete_interp(interp, deleted.begin(), deleted.end());
+    ASSERT_EQ(interp.moving.size(), 1u);
+    EXPECT_EQ(interp.moving[0], ents[1]);
+    EXPECT_FALSE(interp.poses.contains(ents[0]));
+    EXPECT_FALSE(interp.poses.contains(ents[2]));
+
+    tfDirty.clear();
+    SysPhysics::interp_apply(interp, 0.5f, basic.m_transform, tfDirty);
+    EXPECT_TRUE(tfDirty.contains(ents[1]));
+    EXPECT_EQ(position(ents[1]), Vector3(4.0f, 0.0f, 0.0f));
+}
+
+// Reports frame time of a Jolt scene with many shapes, from spawning to settling
+TEST(Physics, DISABLED_BenchmarkJoltShapes)
+{
+    setup_logger();
+
+    int const spheres   = bench_param("OSP_BENCH_SPHERES",   1000);
+    int const boxes     = bench_param("OSP_BENCH_BOXES",     1000);
+    int const cylinders = bench_param("OSP_BENCH_CYLINDERS", 1000);
+    int const frames    = bench_param("OSP_BENCH_FRAMES",    300);
+
+    std::size_t const memStart = resident_memory_bytes();
+
+    JoltScene scene;
+    float const fixedStep = scene.fixed_step();
+
+    std::size_t const memScene = resident_memory_bytes();
+
+    // Spawning happens within a regular frame, which also runs one physics step
+    scene.phys_shapes().m_spawnRequest = make_shape_grid(spheres, boxes, cylinders);
+    auto const spawnStart = Clock_t::now();
+    scene.update(fixedStep);
+    Millis_t const spawnTime = Clock_t::now() - spawnStart;
+
+    std::size_t const memSpawned = resident_memory_bytes();
+
+    // One fixed step per frame
+    auto const stepStart = Clock_t::now();
+    for (int i = 0; i < frames; ++i)
+    {
+        scene.update(fixedStep);
+    }
+    Millis_t const stepTime = Clock_t::now() - stepStart;
+
+    // Zero time frames don't step, leaving only scheduling and writing interpolated transforms
+    auto const syncStart = Clock_t::now();
+    for (int i = 0; i < frames; ++i)
+    {
+        scene.update(0.0f);
+    }
+    Millis_t const syncTime = Clock_t::now() - syncStart;
+
+    std::cout << "Jolt: " << spheres << " spheres, " << boxes << " boxes, " << cylinders << " cylinders\n"
+              << "  spawn frame:    " << spawnTime.count()          << "ms\n"
+              << "  step frame:     " << stepTime.count() / frames  << "ms\n"
+              << "  no-step frame:  " << syncTime.count() / frames  << "ms\n"
+              << "  scene memory:   " << memory_delta_kib(memStart, memScene)   << "KiB\n"
+              << "  shape memory:   " << memory_delta_kib(memScene, memSpawned) << "KiB\n";
+}
+
+//-----------------------------------------------------------------------------
+
+static void newton_gravity(
+        NewtonBody const*                       pBody,
+        ospnewton::BodyId                       body,
+        ospnewton::ACtxNwtWorld const&          rNwt,
+        ospnewton::ACtxNwtWorld::ForceFactorFunc::UserData_t userData,
+        Vector3&                                rForce,
+        Vector3&                                rTorque) noexcept
+{
+    float mass = 0.0f;
+    float inertiaX = 0.0f;
+    float inertiaY = 0.0f;
+    float inertiaZ = 0.0f;
+    NewtonBodyGetMass(pBody, &mass, &inertiaX, &inertiaY, &inertiaZ);
+    rForce += sc_gravity * mass;
+}
+
+/**
+ * @brief Create an entity with a transform and a Newton body for each shape
+ *
+ * @return Entities created, parallel with shapes
+ */
+static std::vector<ActiveEnt> add_newton_shapes(
+        ACtxBasic&                          rBasic,
+        ospnewton::ACtxNwtWorld&            rNwt,
+        std::vector<SpawnShape> const&      shapes,
+        ospnewton::ForceFactors_t const     factors)
+{
+    using namespace ospnewton;
+
+    std::vector<ActiveEnt> ents(shapes.size());
+    rBasic.m_activeIds.create(ents.begin(), ents.end());
+    rBasic.m_scnGraph.resize(rBasic.m_activeIds.capacity());
+
+    std::vector<BodyId> bodies(shapes.size());
+    rNwt.m_bodyIds.create(bodies.begin(), bodies.end());
+    SysNewton::resize_body_data(rNwt);
+
+    for (std::size_t i = 0; i < shapes.size(); ++i)
+    {
+        SpawnShape const &spawn = shapes[i];
+        ActiveEnt const ent     = ents[i];
+        BodyId const bodyId     = bodies[i];
+
+        rBasic.m_transform.emplace(ent, ACompTransform{Matrix4::translation(spawn.m_position)});
+
+        NewtonCollision const *pCollision = SysNewton::get_primitive(rNwt, spawn.m_shape, spawn.m_size);
+        NewtonBody *pBody = NewtonCreateDynamicBody(rNwt.m_world.get(), pCollision, Matrix4::translation(spawn.m_position).data());
+
+        rNwt.m_bodyPtrs[bodyId].reset(pBody);
+        rNwt.m_bodyToEnt[bodyId]    = ent;
+        rNwt.m_bodyFactors[bodyId]  = factors;
+        rNwt.m_entToBody.emplace(ent, bodyId);
+
+        Vector3 const inertia = collider_inertia_tensor(spawn.m_shape, spawn.m_size, spawn.m_mass);
+
+        NewtonBodySetMassMatrix(pBody, spawn.m_mass, inertia.x(), inertia.y(), inertia.z());
+        NewtonBodySetLinearDamping(pBody, 0.0f);
+        NewtonBodySetForceAndTorqueCallback(pBody, &SysNewton::cb_force_torque);
+        NewtonBodySetTransformCallback(pBody, &SysNewton::cb_set_transform);
+        SysNewton::set_userdata_bodyid(pBody, bodyId);
+    }
+
+    return ents;
+}
+
+// Stepping after restoring a snapshot must give the same results as stepping after saving it
+TEST(Physics, NewtonSnapshotRestore)
+{
+    using namespace ospnewton;
+
+    constexpr float sc_fixedStep = 1.0f / 60.0f;
+
+    ACtxBasic       basic;
+    ACtxPhysics     phys;
+    ACtxNwtWorld    nwt{1};
+
+    nwt.m_factors.push_back({.m_func = &newton_gravity, .m_userData = {}});
+    std::vector<ActiveEnt> const ents = add_newton_shapes(basic, nwt, make_shape_grid(3, 3, 3), ForceFactors_t{1});
+
+    auto const step = [&] (int const count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            SysNewton::update_world(phys, nwt, sc_fixedStep, 1, basic.m_scnGraph,
+                                    basic.m_transform, basic.m_scnGraph.m_transformDirty);
+        }
+    };
+
+    auto const positions = [&basic, &ents] ()
+    {
+        std::vector<Vector3> out;
+        for (ActiveEnt const ent : ents)
+        {
+            out.push_back(basic.m_transform.get(ent).m_transform.translation());
+        }
+        return out;
+    };
+
+    step(10);
+
+    NwtSnapshot snapshot;
+    SysNewton::save_snapshot(nwt, snapshot);
+    ASSERT_EQ(snapshot.bodies.size(), 28u);
+
+    step(30);
+    std::vector<Vector3> const expected = positions();
+
+    ASSERT_TRUE(SysNewton::restore_snapshot(nwt, snapshot, basic.m_transform, basic.m_scnGraph.m_transformDirty));
+
+    step(30);
+    std::vector<Vector3> const restored = positions();
+
+    ASSERT_EQ(restored.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_NEAR((restored[i] - expected[i]).length(), 0.0f, 1e-3f);
+    }
+}
+
+// Reports Newton step time for the same shapes with different worker thread counts. Newton is
+// not wired into the application's features, so this uses SysNewton directly.
+TEST(Physics, DISABLED_BenchmarkNewtonThreads)
+{
+    using namespace ospnewton;
+
+    setup_logger();
+
+    int const spheres   = bench_param("OSP_BENCH_SPHERES",   1000);
+    int const boxes     = bench_param("OSP_BENCH_BOXES",     1000);
+    int const cylinders = bench_param("OSP_BENCH_CYLINDERS", 1000);
+    int const frames    = bench_param("OSP_BENCH_FRAMES",    300);
+
+    constexpr float sc_fixedStep = 1.0f / 60.0f;
+
+    std::vector<SpawnShape> const shapes = make_shape_grid(spheres, boxes, cylinders);
+
+    std::cout << "Newton: " << spheres << " spheres, " << boxes << " boxes, " << cylinders << " cylinders\n";
+
+    for (int const threads : {1, 2, 4, 8})
+    {
+        ACtxBasic       basic;
+        ACtxPhysics     phys;
+        ACtxNwtWorld    nwt{threads};
+
+        nwt.m_factors.push_back({.m_func = &newton_gravity, .m_userData = {}});
+        ForceFactors_t const gravityFactor{1};
+
+        auto const spawnStart = Clock_t::now();
+        add_newton_shapes(basic, nwt, shapes, gravityFactor);
+        Millis_t const spawnTime = Clock_t::now() - spawnStart;
+
+        auto const stepStart = Clock_t::now();
+        for (int i = 0; i < frames; ++i)
+        {
+            SysNewton::update_world(phys, nwt, sc_fixedStep, 1, basic.m_scnGraph,
+                                    basic.m_transform, basic.m_scnGraph.m_transformDirty);
+        }
+        Millis_t const stepTime = Clock_t::now() - stepStart;
+
+        std::cout << "  " << threads << " thread(s)\n"
+                  << "    spawn:  " << spawnTime.count()          << "ms\n"
+                  << "    step:   " << stepTime.count() / frames  << "ms\n";
+    }
+}
@@ -0,0 +1,545 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <planet-a/chunk_cache.h>
+#include <planet-a/chunk_generate.h>
+#include <planet-a/chunk_utils.h>
+#include <planet-a/icosahedron.h>
+#include <planet-a/skeleton_subdiv.h>
+
+#include <Corrade/Containers/ArrayViewStl.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+
+using namespace planeta;
+
+using Range_t = DirtyRanges::Range;
+
+// Test sorting and merging of ranges added out of order
+TEST(PlanetA, DirtyRangesCoalesce)
+{
+    DirtyRanges ranges;
+
+    ranges.add(100, 10);  // [100, 110)
+    ranges.add(110, 5);   // [110, 115) merged on add, sequential
+    ranges.add(10, 5);    // [10, 15)
+    ranges.add(12, 6);    // [12, 18) overlaps previous
+    ranges.add(50, 0);    // empty, ignored
+    ranges.add(18, 2);    // [18, 20) touches previous
+    ranges.add(30, 1);    // [30, 31)
+
+    ranges.coalesce();
+
+    std::vector<Range_t> const expected{ {10, 20}, {30, 31}, {100, 115} };
+    EXPECT_EQ(ranges.ranges(), expected);
+    EXPECT_EQ(ranges.element_count(), 10u + 1u + 15u);
+
+    // Merge the [30, 31) range into its neighbor, since it's within maxGap
+    ranges.coalesce(10);
+    std::vector<Range_t> const expectedGap{ {10, 31}, {100, 115} };
+    EXPECT_EQ(ranges.ranges(), expectedGap);
+
+    ranges.clear();
+    EXPECT_TRUE(ranges.empty());
+}
+
+// Test that ranges of neighboring chunks are reported as a single range
+TEST(PlanetA, DirtyRangesChunks)
+{
+    ChunkSkeleton skChunks = make_skeleton_chunks(3);
+    skChunks.chunk_reserve(8);
+    skChunks.shared_reserve(64);
+
+    ChunkMeshBufferInfo const info = make_chunk_mesh_buffer_info(skChunks);
+
+    DirtyRanges vrtx;
+    DirtyRanges faces;
+
+    for (ChunkId const chunkId : {ChunkId{5}, ChunkId{2}, ChunkId{1}})
+    {
+        Range_t const fill = chunk_fill_vrtx_range(info, chunkId);
+        Range_t const face = chunk_face_range(info, chunkId);
+        vrtx .add(fill.first, fill.size());
+        faces.add(face.first, face.size());
+    }
+
+    // A single shared vertex
+    vrtx.add(info.vbufSharedOffset + 3, 1);
+
+    vrtx .coalesce();
+    faces.coalesce();
+
+    std::vector<Range_t> const expectedVrtx{
+        { info.fillVrtxCount * 1,       info.fillVrtxCount * 3 },
+        { info.fillVrtxCount * 5,       info.fillVrtxCount * 6 },
+        { info.vbufSharedOffset + 3,    info.vbufSharedOffset + 4 } };
+
+    std::vector<Range_t> const expectedFaces{
+        { info.chunkMaxFaceCount * 1,   info.chunkMaxFaceCount * 3 },
+        { info.chunkMaxFaceCount * 5,   info.chunkMaxFaceCount * 6 } };
+
+    EXPECT_EQ(vrtx .ranges(), expectedVrtx);
+    EXPECT_EQ(faces.ranges(), expectedFaces);
+    EXPECT_EQ(vrtx .element_count(), info.fillVrtxCount * 3u + 1u);
+}
+
+// Test saving chunks to a cache file, reloading it, then adding more chunks
+TEST(PlanetA, ChunkCacheSaveReload)
+{
+    using osp::Vector3;
+
+    std::filesystem::path const path = std::filesystem::temp_directory_path() / "osp_test_planeta.chunkcache";
+    std::filesystem::remove(path);
+
+    auto const make_positions = [] (float seed) -> std::vector<Vector3>
+    {
+        return { {seed, 0.0f, 0.0f}, {0.0f, seed, 0.0f}, {0.0f, 0.0f, seed} };
+    };
+
+    ChunkGeometryCache cache;
+    cache.path          = path.string();
+    cache.planetId      = 42;
+    cache.fillVrtxCount = 3;
+
+    cache.added[0b1'00011'10] = make_positions(1.0f);
+    cache.added[0b1'00000]    = make_positions(2.0f);
+
+    ASSERT_TRUE(save_chunk_cache(cache));
+    EXPECT_TRUE(cache.added.empty());
+    ASSERT_TRUE(cache.file.is_open());
+    EXPECT_EQ(cache.file.record_count(), 2u);
+
+    // Adding a record keeps existing ones
+    cache.added[0b1'00001] = make_positions(3.0f);
+    ASSERT_TRUE(save_chunk_cache(cache));
+
+    // Mismatched parameters are rejected
+    EXPECT_FALSE(ChunkCacheFile::open(cache.path, 43, 3).is_open());
+    EXPECT_FALSE(ChunkCacheFile::open(cache.path, 42, 4).is_open());
+
+    ChunkCacheFile const reloaded = ChunkCacheFile::open(cache.path, 42, 3);
+    ASSERT_TRUE(reloaded.is_open());
+    ASSERT_EQ(reloaded.record_count(), 3u);
+
+    for (auto const& [triPath, seed] : { std::pair{SkTriPath_t{0b1'00011'10}, 1.0f},
+                                         std::pair{SkTriPath_t{0b1'00000},    2.0f},
+                                         std::pair{SkTriPath_t{0b1'00001},    3.0f} })
+    {
+        osp::ArrayView<Vector3 const> const found = reloaded.find(triPath);
+        std::vector<Vector3> const expected = make_positions(seed);
+        ASSERT_EQ(found.size(), expected.size());
+        EXPECT_TRUE(std::equal(found.begin(), found.end(), expected.begin()));
+    }
+
+    EXPECT_TRUE(reloaded.find(0b1'00010).isEmpty());
+
+    cache.file = {};
+    std::filesystem::remove(path);
+}
+
+// Test that flushes only write segments, which are merged on save or when reopened after a crash
+TEST(PlanetA, ChunkCacheSegments)
+{
+    using osp::Vector3;
+
+    std::filesystem::path const path = std::filesystem::temp_directory_path() / "osp_test_planeta_seg.chunkcache";
+    std::filesystem::remove(path);
+
+    auto const seg_path = [&path] (std::size_t index)
+    {
+        return std::filesystem::path{chunk_cache_segment_path(path.string(), index)};
+    };
+
+    ChunkGeometryCache cache;
+    cache.path          = path.string();
+    cache.planetId      = 42;
+    cache.fillVrtxCount = 1;
+
+    cache.added[0b1'00000] = { {1.0f, 0.0f, 0.0f} };
+    ASSERT_TRUE(flush_chunk_cache(cache));
+    cache.added[0b1'00001] = { {2.0f, 0.0f, 0.0f} };
+    ASSERT_TRUE(flush_chunk_cache(cache));
+
+    EXPECT_TRUE(cache.added.empty());
+    EXPECT_FALSE(std::filesystem::exists(path));
+    EXPECT_TRUE(std::filesystem::exists(seg_path(0)));
+    EXPECT_TRUE(std::filesystem::exists(seg_path(1)));
+    ASSERT_EQ(cache.segments.size(), 2u);
+    EXPECT_EQ(cache.find(0b1'00000)[0], (Vector3{1.0f, 0.0f, 0.0f}));
+    EXPECT_EQ(cache.find(0b1'00001)[0], (Vector3{2.0f, 0.0f, 0.0f}));
+
+    // Reopening without a clean save picks up the leftover segments
+    ChunkGeometryCache reopened;
+    reopened.path          = cache.path;
+    reopened.planetId      = cache.planetId;
+    reopened.fillVrtxCount = cache.fillVrtxCount;
+    cache = {};
+
+    open_chunk_cache(reopened);
+    EXPECT_TRUE(reopened.segments.empty());
+    EXPECT_FALSE(std::filesystem::exists(seg_path(0)));
+    EXPECT_FALSE(std::filesystem::exists(seg_path(1)));
+    ASSERT_EQ(reopened.file.record_count(), 2u);
+
+    // Save merges the file, segments, and added records
+    reopened.added[0b1'00010] = { {3.0f, 0.0f, 0.0f} };
+    ASSERT_TRUE(flush_chunk_cache(reopened));
+    reopened.added[0b1'00011] = { {4.0f, 0.0f, 0.0f} };
+    ASSERT_TRUE(save_chunk_cache(reopened));
+
+    EXPECT_TRUE(reopened.segments.empty());
+    EXPECT_TRUE(reopened.added.empty());
+    EXPECT_FALSE(std::filesystem::exists(seg_path(0)));
+    ASSERT_EQ(reopened.file.record_count(), 4u);
+    for (std::uint32_t i = 0; i < 4; ++i)
+    {
+        osp::ArrayView<Vector3 const> const found = reopened.file.find(SkTriPath_t{0b1'00000} + i);
+        ASSERT_EQ(found.size(), 1u);
+        EXPECT_EQ(found[0], (Vector3{float(i + 1), 0.0f, 0.0f}));
+    }
+
+    reopened.file = {};
+    std::filesystem::remove(path);
+}
+
+// Test that a failed save keeps records to retry later and doesn't leave a temporary file behind
+TEST(PlanetA, ChunkCacheSaveFailure)
+{
+    // A directory can't be replaced by the written file
+    std::filesystem::path const path = std::filesystem::temp_directory_path() / "osp_test_planeta_dir.chunkcache";
+    std::filesystem::create_directories(path);
+
+    ChunkGeometryCache cache;
+    cache.path           = path.string();
+    cache.planetId       = 42;
+    cache.fillVrtxCount  = 1;
+    cache.flushThreshold = 2;
+
+    cache.added[0b1'00000] = { {1.0f, 2.0f, 3.0f} };
+    EXPECT_FALSE(cache.should_flush());
+    cache.added[0b1'00001] = { {4.0f, 5.0f, 6.0f} };
+    EXPECT_TRUE(cache.should_flush());
+
+    EXPECT_FALSE(save_chunk_cache(cache));
+    EXPECT_EQ(cache.added.size(), 2u);
+    EXPECT_FALSE(std::filesystem::exists(cache.path + ".tmp"));
+
+    std::filesystem::remove(path);
+}
+
+/**
+ * @brief A single chunk on an icosahedron triangle, with two copies of mesh geometry
+ */
+struct SingleChunk
+{
+    SingleChunk(std::uint8_t const chunkLevel)
+     : skChunks{make_skeleton_chunks(chunkLevel)}
+    {
+        skel = create_skeleton_icosahedron(1.0, icoVrtx, icoGroups, icoTri, skData);
+
+        skChunks.chunk_reserve(1);
+        skChunks.shared_reserve(skChunks.m_chunkSharedCount);
+        info = make_chunk_mesh_buffer_info(skChunks);
+
+        chSP.lut         = make_chunk_vrtx_subdiv_lut(chunkLevel);
+        chSP.fillFaceLut = make_chunk_fill_face_lut(chunkLevel);
+        chSP.resize(skChunks);
+
+        std::size_t const edgeSize = skChunks.m_chunkEdgeVrtxCount - 1;
+        osp::ArrayView< osp::MaybeNewId<SkVrtxId> > const edges = chSP.edgeVertices;
+
+        auto const &corners = skel.tri_at(icoTri[0]).vertices;
+        skel.vrtx_create_chunk_edge_recurse(chunkLevel, corners[0], corners[1], edges.sliceSize(edgeSize * 0, edgeSize));
+        skel.vrtx_create_chunk_edge_recurse(chunkLevel, corners[1], corners[2], edges.sliceSize(edgeSize * 1, edgeSize));
+        skel.vrtx_create_chunk_edge_recurse(chunkLevel, corners[2], corners[0], edges.sliceSize(edgeSize * 2, edgeSize));
+
+        chunk = skChunks.chunk_create(icoTri[0], skel, chSP.sharedAdded,
+                                      edges.sliceSize(edgeSize * 0, edgeSize),
+                                      edges.sliceSize(edgeSize * 1, edgeSize),
+                                      edges.sliceSize(edgeSize * 2, edgeSize));
+
+        geomA.resize(skChunks, info);
+        geomB.resize(skChunks, info);
+
+        // Bumpy positions laid out on the chunk's triangular grid
+        std::vector<osp::Vector3> gridPos(chSP.fillFaceLut.gridVrtxCount);
+        for (std::uint32_t y = 0; y <= skChunks.m_chunkEdgeVrtxCount; ++y)
+        {
+            for (std::uint32_t x = 0; x <= y; ++x)
+            {
+                float const fx = float(x) - 0.5f * float(y);
+                float const fy = float(y) * 0.866f;
+                gridPos[xy_to_triangular(x, y)] = {fx, fy, 0.4f * std::sin(fx * 1.3f) * std::cos(fy * 0.7f)};
+            }
+        }
+
+        for (BasicChunkMeshGeometry *pGeom : {&geomA, &geomB})
+        {
+            auto const vbufPos = pGeom->vbufPositions.view(pGeom->vrtxBuffer, info.vrtxTotal);
+            auto const sharedUsed = skChunks.shared_vertices_used(chunk);
+            for (std::uint32_t fill = 0; fill < info.fillVrtxCount; ++fill)
+            {
+                vbufPos[info.vbufFillOffset + fill] = gridPos[chSP.fillFaceLut.fillToGrid[fill]];
+            }
+            for (std::uint32_t local = 0; local < sharedUsed.size(); ++local)
+            {
+                vbufPos[info.vbufSharedOffset + sharedUsed[local].value().value] = gridPos[chSP.fillFaceLut.sharedToGrid[local]];
+            }
+        }
+    }
+
+    ~SingleChunk()
+    {
+        skChunks.clear(skel);
+    }
+
+    std::array<SkVrtxId,     12>    icoVrtx;
+    std::array<SkTriGroupId, 5>     icoGroups;
+    std::array<SkTriId,      20>    icoTri;
+
+    SkeletonVertexData              skData;
+    SubdivTriangleSkeleton          skel;
+    ChunkSkeleton                   skChunks;
+    ChunkMeshBufferInfo             info{};
+    ChunkScratchpad                 chSP;
+    BasicChunkMeshGeometry          geomA;
+    BasicChunkMeshGeometry          geomB;
+    ChunkId                         chunk;
+};
+
+// Test that the face lookup table matches the chunk buffer layout
+TEST(PlanetA, ChunkFillFaceLUT)
+{
+    for (std::uint8_t level = 2; level < 7; ++level)
+    {
+        ChunkSkeleton       const skChunks = make_skeleton_chunks(level);
+        ChunkMeshBufferInfo const info     = make_chunk_mesh_buffer_info(skChunks);
+        ChunkFillFaceLUT    const lut      = make_chunk_fill_face_lut(level);
+
+        EXPECT_EQ(lut.faces.size(),           info.fillFaceCount);
+        EXPECT_EQ(lut.fillToGrid.size(),      info.fillVrtxCount);
+        EXPECT_EQ(lut.sharedToGrid.size(),    skChunks.m_chunkSharedCount);
+        EXPECT_EQ(lut.fillVrtxFaces.size(),   info.fillVrtxCount);
+
+        // Every fill vertex is touched by at least 4 faces
+        for (ChunkFillFaceLUT::VrtxFaces_t const& vrtxFaces : lut.fillVrtxFaces)
+        {
+            EXPECT_LT(vrtxFaces[3], lut.faces.size());
+        }
+    }
+}
+
+/**
+ * @brief Expect normals written by write_fill_faces_scatter into geomA to match those written by
+ *        write_fill_faces_gather into geomB
+ */
+static void expect_fill_normals_match(SingleChunk const& sc, float const tolerance)
+{
+    using osp::Vector3;
+
+    EXPECT_TRUE(std::equal(sc.geomA.indxBuffer.begin(), sc.geomA.indxBuffer.end(), sc.geomB.indxBuffer.begin()));
+
+    auto const near = [tolerance] (Vector3 const& lhs, Vector3 const& rhs) -> bool
+    {
+        return (lhs - rhs).length() < tolerance;
+    };
+
+    auto const nrmA = sc.geomA.vbufNormals.view_const(sc.geomA.vrtxBuffer, sc.info.vrtxTotal);
+    auto const nrmB = sc.geomB.vbufNormals.view_const(sc.geomB.vrtxBuffer, sc.info.vrtxTotal);
+    for (std::uint32_t fill = 0; fill < sc.info.fillVrtxCount; ++fill)
+    {
+        EXPECT_TRUE(near(nrmA[sc.info.vbufFillOffset + fill], nrmB[sc.info.vbufFillOffset + fill]));
+    }
+
+    for (std::size_t i = 0; i < sc.geomA.chunkFillSharedNormals.size(); ++i)
+    {
+        EXPECT_TRUE(near(sc.geomA.chunkFillSharedNormals[i], sc.geomB.chunkFillSharedNormals[i]));
+    }
+
+    for (std::size_t i = 0; i < sc.geomA.sharedNormalSum.size(); ++i)
+    {
+        EXPECT_TRUE(near(sc.geomA.sharedNormalSum.base()[i], sc.geomB.sharedNormalSum.base()[i]));
+    }
+}
+
+// Test that gathering normals gives the same results as scattering them
+TEST(PlanetA, ChunkFillNormalsGatherMatchesScatter)
+{
+    for (std::uint8_t level = 2; level < 7; ++level)
+    {
+        SingleChunk sc{level};
+
+        write_fill_faces_scatter(sc.chunk, sc.geomA, sc.info, sc.chSP, sc.skChunks);
+        sc.chSP.sharedNormalsDirty.clear();
+        write_fill_faces_gather (sc.chunk, sc.geomB, sc.info, sc.chSP, sc.skChunks);
+
+        expect_fill_normals_match(sc, 1e-5f);
+    }
+}
+
+// Compares time per chunk of the gather and scatter normal paths, run with
+// --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST(PlanetA, DISABLED_BenchmarkChunkFillNormals)
+{
+    constexpr int c_iterations = 2000;
+
+    for (std::uint8_t level = 3; level < 7; ++level)
+    {
+        SingleChunk sc{level};
+
+        auto const time = [&sc] (auto&& func, BasicChunkMeshGeometry &rGeom) -> double
+        {
+            auto const start = std::chrono::steady_clock::now();
+            for (int i = 0; i < c_iterations; ++i)
+            {
+                func(sc.chunk, rGeom, sc.info, sc.chSP, sc.skChunks);
+                sc.chSP.sharedNormalsDirty.clear();
+            }
+            std::chrono::duration<double, std::micro> const elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count() / c_iterations;
+        };
+
+        double const scatterUs = time(write_fill_faces_scatter, sc.geomA);
+        double const gatherUs  = time(write_fill_faces_gather,  sc.geomB);
+
+        std::cout << "Chunk subdiv level " << int(level) << ": "
+                  << "scatter " << scatterUs << "us, gather " << gatherUs << "us per chunk\n";
+
+        // Scatter subtracts and re-adds its previous contributions each iteration, so allow
+        // some accumulated rounding error
+        expect_fill_normals_match(sc, 1e-3f);
+    }
+}
+
+/**
+ * @brief Icosahedron skeleton subdivided around a viewer, the same way as ftrTerrainSubdivDist
+ */
+struct SubdivIco
+{
+    static constexpr double sc_radius = 1000.0;
+
+    SubdivIco(osp::WorkerPool workers)
+    {
+        skData.precision = 10;
+        skel = create_skeleton_icosahedron(sc_radius, icoVrtx, icoGroups, icoTri, skData);
+        skel.levelMax = 7;
+        skData.resize(skel);
+
+        for (SkTriGroupId const groupId : icoGroups)
+        {
+            ico_calc_sphere_tri_center(groupId, sc_radius, 0.0, skel, skData);
+        }
+
+        skSP.resize(skel);
+        skSP.workers = std::move(workers);
+        skSP.onSubdiv = [] (
+                SkTriId                                     tri,
+                SkTriGroupId                                groupId,
+                std::array<SkVrtxId, 3>                     corners,
+                std::array<osp::MaybeNewId<SkVrtxId>, 3>    middles,
+                SubdivTriangleSkeleton                      &rSkel,
+                SkeletonVertexData                          &rSkData,
+                SkeletonSubdivScratchpad::UserData_t        userData) noexcept
+        {
+            ico_calc_middles(sc_radius, corners, middles, rSkData);
+            ico_calc_sphere_tri_center(groupId, sc_radius, 0.0, rSkel, rSkData);
+        };
+        skSP.onUnsubdiv = [] (
+                SkTriId                                     tri,
+                SkeletonTriangle                            &rTri,
+                SubdivTriangleSkeleton                      &rSkel,
+                SkeletonVertexData                          &rSkData,
+                SkeletonSubdivScratchpad::UserData_t        userData) noexcept
+        { };
+
+        // Subdivide the first 5 levels completely, giving a batch of 20*4^5 triangles to distance
+        // test on level 5. This is large enough to be split across workers.
+        double const scale = std::exp2(double(skData.precision));
+        for (int level = 0; level < gc_maxSubdivLevels; ++level)
+        {
+            double const subdivRadius = (level < 5) ? 1e30 : 0.75 * gc_icoMaxEdgeVsLevel[level] * sc_radius * scale;
+            skSP.distanceThresholdSubdiv[level]   = subdivRadius;
+            skSP.distanceThresholdUnsubdiv[level] = 2.0 * subdivRadius;
+        }
+    }
+
+    void subdivide(osp::Vector3l const viewerPos)
+    {
+        for (SkTriId const sktriId : icoTri)
+        {
+            skSP.levels[0].distanceTestNext.push_back(sktriId);
+            skSP.distanceTestDone.insert(sktriId);
+        }
+        skSP.levelNeedProcess = 0;
+
+        for (int level = 0; level < skel.levelMax; ++level)
+        {
+            subdivide_level_by_distance(viewerPos, level, skel, skData, skSP);
+        }
+        skSP.distanceTestDone.clear();
+    }
+
+    std::array<SkVrtxId,     12>    icoVrtx;
+    std::array<SkTriGroupId, 5>     icoGroups;
+    std::array<SkTriId,      20>    icoTri;
+
+    SkeletonVertexData              skData;
+    SubdivTriangleSkeleton          skel;
+    SkeletonSubdivScratchpad        skSP;
+};
+
+// Test that distance testing on workers subdivides the exact same triangles as testing serially
+TEST(PlanetA, SubdivideParallelMatchesSerial)
+{
+    SubdivIco serial{osp::WorkerPool{}};
+    SubdivIco parallel{osp::WorkerPool{3}};
+
+    osp::Vector3l const viewerPos{0, 0, std::int64_t(SubdivIco::sc_radius * 1024.0)};
+    serial  .subdivide(viewerPos);
+    parallel.subdivide(viewerPos);
+
+    EXPECT_EQ(serial.skSP.distanceCheckCount, parallel.skSP.distanceCheckCount);
+    ASSERT_EQ(serial.skel.tri_group_ids().size(), parallel.skel.tri_group_ids().size());
+    ASSERT_EQ(serial.skel.vrtx_ids().size(),      parallel.skel.vrtx_ids().size());
+
+    // More than the full levels were subdivided, but not everything
+    EXPECT_GT(serial.skel.tri_group_ids().size(), 5u * (1u + 4u + 16u + 64u + 256u + 1024u));
+    EXPECT_LT(serial.skel.tri_group_ids().size(), 5u * (1u + 4u + 16u + 64u + 256u + 1024u + 4096u + 16384u));
+
+    for (SkTriGroupId const groupId : serial.skel.tri_group_ids())
+    {
+        ASSERT_TRUE(parallel.skel.tri_group_ids().exists(groupId));
+        for (std::uint8_t sibling = 0; sibling < 4; ++sibling)
+        {
+            SkTriId const sktriId = tri_id(groupId, sibling);
+            EXPECT_EQ(serial.skel.tri_at(sktriId).children, parallel.skel.tri_at(sktriId).children);
+            EXPECT_EQ(serial.skData.centers[sktriId],       parallel.skData.centers[sktriId]);
+        }
+    }
+}
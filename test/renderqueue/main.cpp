@@ -0,0 +1,344 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <osp/drawing/draw_commands.h>
+#include <osp/drawing/render_queue.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace osp;
+using namespace osp::draw;
+
+void draw_noop(DrawEnt, ViewProjMatrix const&, EntityToDraw::UserData_t) noexcept { }
+
+/**
+ * @brief RenderGroup of entities drawn with a few shaders, meshes, and textures
+ */
+struct QueueScene
+{
+    QueueScene(std::size_t count, std::size_t shaderCount, std::size_t meshCount, std::size_t texCount)
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> distPos(-100.0f, 100.0f);
+
+        for (std::size_t i = 0; i < meshCount; ++i)
+        {
+            meshes.push_back(drawing.m_meshIds.create());
+        }
+        for (std::size_t i = 0; i < texCount; ++i)
+        {
+            textures.push_back(drawing.m_texIds.create());
+        }
+        drawing.m_meshRefCounts.resize(drawing.m_meshIds.capacity());
+        drawing.m_texRefCounts .resize(drawing.m_texIds.capacity());
+
+        shaderData.resize(shaderCount);
+
+        scnRender.m_drawIds.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            scnRender.m_drawIds.create();
+        }
+        scnRender.resize_draw();
+
+        std::size_t i = 0;
+        for (DrawEnt const drawEnt : scnRender.m_drawIds)
+        {
+            scnRender.m_visible.insert(drawEnt);
+            scnRender.m_mesh[drawEnt]       = drawing.m_meshRefCounts.ref_add(meshes[i % meshCount]);
+            scnRender.m_diffuseTex[drawEnt] = drawing.m_texRefCounts .ref_add(textures[(i / 6) % texCount]);
+            scnRender.m_drawTransform[drawEnt] = Matrix4::translation({distPos(gen), distPos(gen), distPos(gen)});
+
+            group.entities.emplace(drawEnt, EntityToDraw{&draw_noop, {&shaderData[i % shaderCount]}});
+            ++i;
+        }
+    }
+
+    ~QueueScene()
+    {
+        for (MeshIdOwner_t &rOwner : scnRender.m_mesh)
+        {
+            if (rOwner.has_value())
+            {
+                drawing.m_meshRefCounts.ref_release(std::move(rOwner));
+            }
+        }
+        for (TexIdOwner_t &rOwner : scnRender.m_diffuseTex)
+        {
+            if (rOwner.has_value())
+            {
+                drawing.m_texRefCounts.ref_release(std::move(rOwner));
+            }
+        }
+    }
+
+    ACtxDrawing             drawing;
+    ACtxSceneRender         scnRender;
+    RenderGroup             group;
+    std::vector<MeshId>     meshes;
+    std::vector<TexId>      textures;
+    std::vector<int>        shaderData;
+};
+
+ViewProjMatrix test_view_proj()
+{
+    return {Matrix4::lookAt({0.0f, 0.0f, 200.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}).inverted(),
+            Matrix4::perspectiveProjection(Deg{60.0f}, 1.0f, 0.25f, 1000.0f)};
+}
+
+float view_depth(QueueScene const& scene, ViewProjMatrix const& viewProj, DrawEnt const ent)
+{
+    return -viewProj.m_view.transformPoint(scene.scnRender.m_drawTransform[ent].translation()).z();
+}
+
+TEST(RenderQueue, RadixSortMatchesStdSort)
+{
+    std::mt19937_64 gen(42);
+
+    std::vector<RenderQueue::Entry> entries(10000);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        // Many duplicates to test stability, and constant high bits to test skipped passes
+        entries[i] = {.key = 0xAB00'0000'0000'0000ull | (gen() % 500), .ent = DrawEnt(i)};
+    }
+
+    std::vector<RenderQueue::Entry> expected = entries;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [] (RenderQueue::Entry const& lhs, RenderQueue::Entry const& rhs) { return lhs.key < rhs.key; });
+
+    std::vector<RenderQueue::Entry> temp;
+    SysRenderQueue::radix_sort(entries, temp);
+
+    ASSERT_EQ(entries.size(), expected.size());
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        EXPECT_EQ(entries[i].key, expected[i].key);
+        EXPECT_EQ(entries[i].ent, expected[i].ent);
+    }
+}
+
+TEST(RenderQueue, OpaqueBatches)
+{
+    constexpr std::size_t sc_shaders  = 2;
+    constexpr std::size_t sc_meshes   = 3;
+    constexpr std::size_t sc_textures = 4;
+
+    QueueScene scene{600, sc_shaders, sc_meshes, sc_textures};
+    ViewProjMatrix const viewProj = test_view_proj();
+
+    // Hide one entity
+    DrawEnt const hidden = *scene.scnRender.m_drawIds.begin();
+    scene.scnRender.m_visible.erase(hidden);
+
+    RenderQueue queue;
+    SysRenderQueue::build(queue, scene.group, scene.scnRender.m_visible, scene.scnRender, viewProj, ERenderPass::Opaque);
+
+    ASSERT_EQ(queue.ents.size(), 599u);
+    EXPECT_EQ(std::count(queue.ents.begin(), queue.ents.end(), hidden), 0);
+    EXPECT_EQ(queue.shaders.size(), sc_shaders);
+
+    // Each distinct shader/mesh/texture combination becomes exactly one batch. With these counts,
+    // all 2*3*4 = 24 combinations are used.
+    EXPECT_EQ(queue.batches.size(), sc_shaders * sc_meshes * sc_textures);
+
+    std::size_t total = 0;
+    for (RenderQueue::Batch const& batch : queue.batches)
+    {
+        EXPECT_EQ(batch.first, total);
+        total += batch.count;
+
+        DrawEnt const firstEnt = queue.ents[batch.first];
+        for (std::uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+        {
+            DrawEnt const ent = queue.ents[i];
+            EXPECT_EQ(scene.group.entities.get(ent).data, queue.shaders[batch.shader].data);
+            EXPECT_EQ(scene.scnRender.m_mesh[ent].value(),       scene.scnRender.m_mesh[firstEnt].value());
+            EXPECT_EQ(scene.scnRender.m_diffuseTex[ent].value(), scene.scnRender.m_diffuseTex[firstEnt].value());
+
+            // Front-to-back within a batch, allow for depth precision lost in the key
+            if (i != batch.first)
+            {
+                EXPECT_LE(view_depth(scene, viewProj, queue.ents[i - 1]), view_depth(scene, viewProj, ent) * 1.001f);
+            }
+        }
+    }
+    EXPECT_EQ(total, queue.ents.size());
+}
+
+TEST(RenderQueue, TransparentBackToFront)
+{
+    QueueScene scene{500, 2, 3, 4};
+    ViewProjMatrix const viewProj = test_view_proj();
+
+    RenderQueue queue;
+    SysRenderQueue::build(queue, scene.group, scene.scnRender.m_visible, scene.scnRender, viewProj, ERenderPass::Transparent);
+
+    ASSERT_EQ(queue.ents.size(), 500u);
+    for (std::size_t i = 1; i < queue.ents.size(); ++i)
+    {
+        // Keys keep the top 22 bits of depth, allow for the lost precision
+        EXPECT_GE(view_depth(scene, viewProj, queue.ents[i - 1]) * 1.001f, view_depth(scene, viewProj, queue.ents[i]));
+    }
+
+    // Random depths rarely leave neighbours with the same shader, mesh, and texture
+    EXPECT_GT(queue.batches.size(), 24u);
+}
+
+TEST(RenderQueue, DrawCommandsSkipRedundantBinds)
+{
+    constexpr std::size_t sc_shaders  = 2;
+    constexpr std::size_t sc_meshes   = 3;
+    constexpr std::size_t sc_textures = 4;
+
+    QueueScene scene{600, sc_shaders, sc_meshes, sc_textures};
+    ViewProjMatrix const viewProj = test_view_proj();
+
+    RenderQueue         queue;
+    DrawCommandBuffer   buffer;
+    SysRenderQueue::build(queue, scene.group, scene.scnRender.m_visible, scene.scnRender, viewProj, ERenderPass::Opaque);
+    SysDrawCommands::record(buffer, queue, ERenderPass::Opaque);
+
+    DrawCommandCounter counter;
+    SysDrawCommands::submit(buffer, counter);
+
+    // Opaque keys sort by shader, then texture, then mesh
+    EXPECT_EQ(counter.shaderBinds,  sc_shaders);
+    EXPECT_EQ(counter.textureBinds, sc_shaders * sc_textures);
+    EXPECT_EQ(counter.meshBinds,    queue.batches.size());
+    EXPECT_EQ(counter.draws,        queue.batches.size());
+    EXPECT_EQ(counter.entsDrawn,    600u);
+}
+
+// Test that recording on multiple threads gives the same commands as recording on one
+TEST(RenderQueue, RecordParallel)
+{
+    constexpr std::size_t sc_groups = 8;
+
+    QueueScene scene{4000, 3, 5, 7};
+    ViewProjMatrix const viewProj = test_view_proj();
+
+    // Split entities across render groups
+    std::array<RenderGroup, sc_groups> groups;
+    std::size_t i = 0;
+    for (auto const& [ent, toDraw] : entt::basic_view{scene.group.entities}.each())
+    {
+        groups[i % sc_groups].entities.emplace(ent, toDraw);
+        ++i;
+    }
+
+    std::array<RenderQueue,       sc_groups> queues;
+    std::array<DrawCommandBuffer, sc_groups> buffers;
+    std::array<SysDrawCommands::RecordJob, sc_groups> jobs;
+    for (std::size_t j = 0; j < sc_groups; ++j)
+    {
+        ERenderPass const pass = (j % 2 == 0) ? ERenderPass::Opaque : ERenderPass::Transparent;
+        jobs[j] = {&groups[j], &scene.scnRender.m_visible, pass, &queues[j], &buffers[j]};
+    }
+
+    WorkerPool workers{3};
+    SysDrawCommands::record_parallel(jobs, scene.scnRender, viewProj, workers);
+
+    for (std::size_t j = 0; j < sc_groups; ++j)
+    {
+        RenderQueue         expectQueue;
+        DrawCommandBuffer   expectBuffer;
+        SysRenderQueue::build(expectQueue, groups[j], scene.scnRender.m_visible, scene.scnRender, viewProj, jobs[j].pass);
+        SysDrawCommands::record(expectBuffer, expectQueue, jobs[j].pass);
+
+        EXPECT_EQ(buffers[j].pass, jobs[j].pass);
+        EXPECT_EQ(buffers[j].ents, expectBuffer.ents);
+        ASSERT_EQ(buffers[j].commands.size(), expectBuffer.commands.size());
+        for (std::size_t k = 0; k < expectBuffer.commands.size(); ++k)
+        {
+            EXPECT_EQ(buffers[j].commands[k].type,  expectBuffer.commands[k].type);
+            EXPECT_EQ(buffers[j].commands[k].value, expectBuffer.commands[k].value);
+            EXPECT_EQ(buffers[j].commands[k].count, expectBuffer.commands[k].count);
+        }
+    }
+}
+
+// Run manually with --gtest_also_run_disabled_tests
+TEST(RenderQueue, DISABLED_BenchmarkRecord)
+{
+    using Clock_t = std::chrono::steady_clock;
+
+    constexpr int           sc_iterations   = 20;
+    constexpr std::size_t   sc_entities     = 100000;
+    constexpr std::size_t   sc_groups       = 16;
+
+    QueueScene scene{sc_entities, 8, 64, 32};
+    ViewProjMatrix const viewProj = test_view_proj();
+
+    std::array<RenderGroup, sc_groups> groups;
+    std::size_t i = 0;
+    for (auto const& [ent, toDraw] : entt::basic_view{scene.group.entities}.each())
+    {
+        groups[i % sc_groups].entities.emplace(ent, toDraw);
+        ++i;
+    }
+
+    std::array<RenderQueue,       sc_groups> queues;
+    std::array<DrawCommandBuffer, sc_groups> buffers;
+    std::array<SysDrawCommands::RecordJob, sc_groups> jobs;
+    for (std::size_t j = 0; j < sc_groups; ++j)
+    {
+        jobs[j] = {&groups[j], &scene.scnRender.m_visible, ERenderPass::Opaque, &queues[j], &buffers[j]};
+    }
+
+    auto const measure = [] (auto&& update) -> double
+    {
+        update(); // warm up
+        auto const start = Clock_t::now();
+        for (int k = 0; k < sc_iterations; ++k)
+        {
+            update();
+        }
+        std::chrono::duration<double, std::milli> const total = Clock_t::now() - start;
+        return total.count() / sc_iterations;
+    };
+
+    WorkerPool noWorkers;
+    WorkerPool workers{WorkerPool::default_thread_count()};
+    std::size_t const threads = workers.thread_count() + 1;
+
+    double const singleMs   = measure([&] { SysDrawCommands::record_parallel(jobs, scene.scnRender, viewProj, noWorkers); });
+    double const parallelMs = measure([&] { SysDrawCommands::record_parallel(jobs, scene.scnRender, viewProj, workers); });
+
+    DrawCommandCounter counter;
+    for (DrawCommandBuffer const& buffer : buffers)
+    {
+        SysDrawCommands::submit(buffer, counter);
+    }
+
+    std::cout << "Recording " << sc_entities << " entities in " << sc_groups << " groups, "
+              << counter.draws << " draws, " << counter.meshBinds << " mesh binds\n"
+              << "  1 thread:   " << singleMs   << "ms\n"
+              << "  " << threads << " threads: " << parallelMs << "ms\n";
+}
@@ -0,0 +1,601 @@
+/**
+ * Open Space Program
+ * Copyright © 2019-2024 Open Space Program Project
+ *
+ * MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <osp/activescene/basic.h>
+#include <osp/activescene/basic_fn.h>
+#include <osp/drawing/drawing_fn.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace osp;
+using namespace osp::active;
+using namespace osp::draw;
+
+/**
+ * @brief Scene graph with transforms, arranged like vehicles made of parts with attachments
+ *
+ * Each vehicle is a child of the root, each part is a child of a vehicle, and each attachment is
+ * a child of a part. Every ActiveEnt has a DrawEnt with the same value.
+ */
+struct VehicleScene
+{
+    VehicleScene(std::size_t vehicleCount, std::size_t partCount)
+    {
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> distPos(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> distAngle(-3.0f, 3.0f);
+
+        std::size_t const entCount = vehicleCount * (1 + partCount * 2);
+
+        basic.m_activeIds.reserve(entCount);
+        basic.m_scnGraph.resize(entCount);
+
+        auto const add_ent = [this, &gen, &distPos, &distAngle] () -> ActiveEnt
+        {
+            ActiveEnt const ent = basic.m_activeIds.create();
+            Matrix4 const tf = Matrix4::translation({distPos(gen), distPos(gen), distPos(gen)})
+                             * Matrix4::rotationY(Rad{distAngle(gen)});
+            basic.m_transform.emplace(ent, ACompTransform{tf});
+            return ent;
+        };
+
+        SubtreeBuilder bldRoot = SysSceneGraph::add_descendants(basic.m_scnGraph, std::uint32_t(entCount));
+        for (std::size_t i = 0; i < vehicleCount; ++i)
+        {
+            SubtreeBuilder bldVehicle = bldRoot.add_child(add_ent(), std::uint32_t(partCount * 2));
+            for (std::size_t j = 0; j < partCount; ++j)
+            {
+                SubtreeBuilder bldPart = bldVehicle.add_child(add_ent(), 1);
+                bldPart.add_child(add_ent());
+            }
+        }
+
+        std::size_t const capacity = basic.m_activeIds.capacity();
+        needDrawTf  .resize(capacity);
+        activeToDraw.resize(capacity, lgrn::id_null<DrawEnt>());
+        drawTf      .resize(capacity);
+        treeDrawTf  .resize(basic.m_scnGraph.m_treeToEnt.size());
+
+        for (ActiveEnt const ent : basic.m_activeIds)
+        {
+            activeToDraw[ent] = DrawEnt(ent.value);
+        }
+    }
+
+    SysRender::ArgsForUpdDrawTransform args()
+    {
+        return {
+            .scnGraph     = basic.m_scnGraph,
+            .transforms   = basic.m_transform,
+            .activeToDraw = activeToDraw,
+            .needDrawTf   = needDrawTf,
+            .rDrawTf      = drawTf
+        };
+    }
+
+    void update_recursive()
+    {
+        auto rootChildren = SysSceneGraph::children(basic.m_scnGraph);
+        SysRender::update_draw_transforms(args(), rootChildren.begin(), rootChildren.end());
+    }
+
+    void update_linear()
+    {
+        SysRender::gather_tree_transforms(args(), treeDrawTf);
+        SysRender::update_draw_transforms_linear(args(), treeDrawTf, 1, TreePos_t(treeDrawTf.drawTf.size()));
+    }
+
+    ACtxBasic                       basic;
+    ActiveEntSet_t                  needDrawTf;
+    KeyedVec<ActiveEnt, DrawEnt>    activeToDraw;
+    DrawTransforms_t                drawTf;
+    TreeDrawTransforms              treeDrawTf;
+};
+
+static void expect_equal_draw_transforms(DrawTransforms_t const& a, DrawTransforms_t const& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        DrawEnt const drawEnt{std::uint32_t(i)};
+        EXPECT_EQ(a[drawEnt], b[drawEnt]);
+    }
+}
+
+static std::vector<ActiveEnt> children_of(ACtxSceneGraph const& scnGraph, ActiveEnt parent)
+{
+    auto const children = SysSceneGraph::children(scnGraph, parent);
+    return {children.begin(), children.end()};
+}
+
+// Linear propagation must give the same results as the recursive version, including when only a
+// few entities need draw transforms
+TEST(SceneGraph, LinearDrawTransformsMatchRecursive)
+{
+    VehicleScene scene{20, 30};
+
+    for (ActiveEnt const ent : scene.basic.m_activeIds)
+    {
+        scene.needDrawTf.insert(ent);
+    }
+
+    scene.update_recursive();
+    DrawTransforms_t const expected = scene.drawTf;
+
+    std::fill(scene.drawTf.begin(), scene.drawTf.end(), Matrix4{Magnum::Math::ZeroInit});
+    scene.update_linear();
+    expect_equal_draw_transforms(expected, scene.drawTf);
+
+    // Only some attachments and their ancestors
+    scene.needDrawTf.clear();
+    std::size_t i = 0;
+    for (ActiveEnt const ent : scene.basic.m_activeIds)
+    {
+        if (i % 7 == 0 && scene.basic.m_scnGraph.m_treeDescendants[scene.basic.m_scnGraph.m_entToTreePos[ent]] == 0)
+        {
+            SysRender::needs_draw_transforms(scene.basic.m_scnGraph, scene.needDrawTf, ent);
+        }
+        ++i;
+    }
+
+    std::fill(scene.drawTf.begin(), scene.drawTf.end(), Matrix4{Magnum::Math::ZeroInit});
+    scene.update_recursive();
+    DrawTransforms_t const expectedPartial = scene.drawTf;
+
+    std::fill(scene.drawTf.begin(), scene.drawTf.end(), Matrix4{Magnum::Math::ZeroInit});
+    scene.update_linear();
+    expect_equal_draw_transforms(expectedPartial, scene.drawTf);
+}
+
+// Each child of the root can be updated on its own
+TEST(SceneGraph, LinearDrawTransformsPerSubtree)
+{
+    VehicleScene scene{8, 10};
+
+    for (ActiveEnt const ent : scene.basic.m_activeIds)
+    {
+        scene.needDrawTf.insert(ent);
+    }
+
+    scene.update_recursive();
+    DrawTransforms_t const expected = scene.drawTf;
+
+    std::fill(scene.drawTf.begin(), scene.drawTf.end(), Matrix4{Magnum::Math::ZeroInit});
+
+    ACtxSceneGraph const &scnGraph = scene.basic.m_scnGraph;
+    SysRender::gather_tree_transforms(scene.args(), scene.treeDrawTf);
+    for (ActiveEnt const vehicle : SysSceneGraph::children(scnGraph))
+    {
+        TreePos_t const first = scnGraph.m_entToTreePos[vehicle];
+        TreePos_t const last  = first + 1 + scnGraph.m_treeDescendants[first];
+        SysRender::update_draw_transforms_linear(scene.args(), scene.treeDrawTf, first, last);
+    }
+
+    expect_equal_draw_transforms(expected, scene.drawTf);
+}
+
+// Only subtrees of dirty entities are recalculated, and give the same results as recalculating
+// everything
+TEST(SceneGraph, DirtyDrawTransforms)
+{
+    VehicleScene scene{10, 10};
+    ACtxSceneGraph &rScnGraph = scene.basic.m_scnGraph;
+
+    for (ActiveEnt const ent : scene.basic.m_activeIds)
+    {
+        scene.needDrawTf.insert(ent);
+    }
+
+    scene.update_linear();
+    rScnGraph.m_transformDirty.clear();
+
+    // Move a vehicle and a single attachment of another vehicle
+    auto const vehicles = children_of(rScnGraph, lgrn::id_null<ActiveEnt>());
+    ActiveEnt const movedVehicle    = vehicles[3];
+    ActiveEnt const movedPart       = children_of(rScnGraph, vehicles[6])[2];
+    ActiveEnt const movedAttachment = children_of(rScnGraph, movedPart)[0];
+
+    for (ActiveEnt const ent : {movedVehicle, movedAttachment})
+    {
+        scene.basic.m_transform.get(ent).m_transform = Matrix4::translation({1.0f, 2.0f, 3.0f})
+                                                      * scene.basic.m_transform.get(ent).m_transform;
+        rScnGraph.m_transformDirty.insert(ent);
+    }
+    rScnGraph.m_transformDirty.insert(movedAttachment); // duplicate
+
+    std::vector<ActiveEnt> visited;
+    SysRender::update_draw_transforms_dirty(scene.args(), scene.treeDrawTf,
+                                            rScnGraph.m_transformDirty.begin(),
+                                            rScnGraph.m_transformDirty.end(),
+                                            [&visited] (Matrix4 const&, ActiveEnt ent, int)
+    {
+        visited.push_back(ent);
+    });
+
+    // Vehicle and its 10 parts with 1 attachment each, plus the single attachment
+    EXPECT_EQ(visited.size(), 1u + 10u * 2u + 1u);
+    DrawTransforms_t const dirtyResult = scene.drawTf;
+
+    scene.update_recursive();
+    expect_equal_draw_transforms(scene.drawTf, dirtyResult);
+}
+
+// Cutting from and adding to a subtree in the middle of the tree shifts positions within it
+// without changing m_version. The dirty pass must still give the same results as recalculating
+// everything.
+TEST(SceneGraph, DirtyDrawTransformsAfterShift)
+{
+    VehicleScene scene{10, 10};
+    ACtxSceneGraph &rScnGraph = scene.basic.m_scnGraph;
+
+    for (ActiveEnt const ent : scene.basic.m_activeIds)
+    {
+        scene.needDrawTf.insert(ent);
+    }
+
+    scene.update_linear();
+    rScnGraph.m_transformDirty.clear();
+
+    auto const update_dirty_and_compare = [&scene, &rScnGraph] ()
+    {
+        SysRender::update_draw_transforms_dirty(scene.args(), scene.treeDrawTf,
+                                                rScnGraph.m_transformDirty.begin(),
+                                                rScnGraph.m_transformDirty.end());
+        rScnGraph.m_transformDirty.clear();
+        DrawTransforms_t const dirtyResult = scene.drawTf;
+
+        scene.update_recursive();
+        expect_equal_draw_transforms(scene.drawTf, dirtyResult);
+    };
+
+    uint32_t const version = rScnGraph.m_version;
+    ActiveEnt const vehicle = children_of(rScnGraph, lgrn::id_null<ActiveEnt>())[4];
+
+    // Cut a part near the start of the vehicle, shifting the parts after it left
+    ActiveEnt const cutPart = children_of(rScnGraph, vehicle)[1];
+    std::array const cutParts{cutPart};
+    SysSceneGraph::cut(rScnGraph, cutParts.begin(), cutParts.end());
+    scene.needDrawTf.erase(cutPart);
+    EXPECT_EQ(rScnGraph.m_version, version);
+
+    update_dirty_and_compare();
+
+    // Give the first part another attachment, shifting the parts after it right into the gap
+    // left by the cut
+    ActiveEnt const part = children_of(rScnGraph, vehicle)[0];
+
+    scene.basic.m_activeIds.reserve(scene.basic.m_activeIds.capacity() + 1);
+    ActiveEnt const added = scene.basic.m_activeIds.create();
+    std::size_t const capacity = scene.basic.m_activeIds.capacity();
+    rScnGraph.resize(capacity);
+    scene.needDrawTf  .resize(capacity);
+    scene.activeToDraw.resize(capacity, lgrn::id_null<DrawEnt>());
+    scene.drawTf      .resize(capacity);
+
+    scene.basic.m_transform.emplace(added, ACompTransform{Matrix4::translation({0.0f, 1.0f, 0.0f})});
+    scene.activeToDraw[added] = DrawEnt(added.value);
+    scene.needDrawTf.insert(added);
+    {
+        SubtreeBuilder bldPart = SysSceneGraph::add_descendants(rScnGraph, 1, part);
+        bldPart.add_child(added);
+    }
+    EXPECT_EQ(rScnGraph.m_version, version);
+    scene.treeDrawTf.resize(rScnGraph.m_treeToEnt.size());
+
+    update_dirty_and_compare();
+}
+
+/**
+ * @brief Check that tree positions, descendant counts, parents, and gaps agree with each other
+ */
+static void expect_consistent(ACtxSceneGraph const& scnGraph)
+{
+    auto const treeSize = TreePos_t(scnGraph.m_treeToEnt.size());
+    ASSERT_EQ(scnGraph.m_treeDescendants.size(), treeSize);
+    EXPECT_EQ(scnGraph.m_treeDescendants[0] + 1, treeSize);
+
+    uint32_t gaps = 0;
+    TreePos_t pos = 1;
+    while (pos < treeSize)
+    {
+        ActiveEnt const ent = scnGraph.m_treeToEnt[pos];
+        if (ent == lgrn::id_null<ActiveEnt>())
+        {
+            // Gap runs are only allowed between children of the root
+            gaps += 1 + scnGraph.m_treeDescendants[pos];
+            pos  += 1 + scnGraph.m_treeDescendants[pos];
+            continue;
+        }
+
+        EXPECT_EQ(scnGraph.m_entParent[ent], lgrn::id_null<ActiveEnt>());
+
+        TreePos_t const last = pos + 1 + scnGraph.m_treeDescendants[pos];
+        ASSERT_LE(last, treeSize);
+        for (TreePos_t subPos = pos; subPos < last; ++subPos)
+        {
+            ActiveEnt const subEnt = scnGraph.m_treeToEnt[subPos];
+            ASSERT_NE(subEnt, lgrn::id_null<ActiveEnt>());
+            EXPECT_EQ(scnGraph.m_entToTreePos[subEnt], subPos);
+
+            // Parent must contain this entity within its descendants
+            ActiveEnt const parent = scnGraph.m_entParent[subEnt];
+            if (parent != lgrn::id_null<ActiveEnt>())
+            {
+                TreePos_t const parentPos = scnGraph.m_entToTreePos[parent];
+                EXPECT_LT(parentPos, subPos);
+                EXPECT_LE(subPos, parentPos + scnGraph.m_treeDescendants[parentPos]);
+            }
+        }
+        pos = last;
+    }
+    EXPECT_EQ(gaps, scnGraph.m_gapCount);
+}
+
+// Adding to and removing from subtrees in the middle of the tree only shifts within the subtree
+// and the unused positions after it
+TEST(SceneGraph, SubtreeGaps)
+{
+    ACtxBasic basic;
+    ACtxSceneGraph &rScnGraph = basic.m_scnGraph;
+
+    constexpr std::size_t sc_entMax = 4096;
+    basic.m_activeIds.reserve(sc_entMax);
+    rScnGraph.resize(sc_entMax);
+
+    // 3 vehicles with 2 parts each
+    std::array<ActiveEnt, 3> vehicles;
+    {
+        SubtreeBuilder bldRoot = SysSceneGraph::add_descendants(rScnGraph, 9);
+        for (ActiveEnt &rVehicle : vehicles)
+        {
+            rVehicle = basic.m_activeIds.create();
+            SubtreeBuilder bldVehicle = bldRoot.add_child(rVehicle, 2);
+            bldVehicle.add_child(basic.m_activeIds.create());
+            bldVehicle.add_child(basic.m_activeIds.create());
+        }
+    }
+    expect_consistent(rScnGraph);
+    EXPECT_EQ(rScnGraph.m_gapCount, 0u);
+
+    // Add parts to the middle vehicle, making a gap after it
+    std::vector<ActiveEnt> added;
+    {
+        SubtreeBuilder bldVehicle = SysSceneGraph::add_descendants(rScnGraph, 2, vehicles[1]);
+        for (int i = 0; i < 2; ++i)
+        {
+            added.push_back(basic.m_activeIds.create());
+            bldVehicle.add_child(added.back());
+        }
+    }
+    expect_consistent(rScnGraph);
+    EXPECT_GT(rScnGraph.m_gapCount, 0u);
+    EXPECT_EQ(rScnGraph.m_treeDescendants[rScnGraph.m_entToTreePos[vehicles[1]]], 4u);
+    EXPECT_EQ(children_of(rScnGraph, lgrn::id_null<ActiveEnt>()),
+              std::vector<ActiveEnt>(vehicles.begin(), vehicles.end()));
+
+    // Adding more fits into the existing gap, entities after it don't move
+    TreePos_t const lastVehiclePos = rScnGraph.m_entToTreePos[vehicles[2]];
+    {
+        SubtreeBuilder bldPart = SysSceneGraph::add_descendants(rScnGraph, 1, added[0]);
+        bldPart.add_child(basic.m_activeIds.create());
+    }
+    expect_consistent(rScnGraph);
+    EXPECT_EQ(rScnGraph.m_entToTreePos[vehicles[2]], lastVehiclePos);
+    EXPECT_EQ(rScnGraph.m_treeDescendants[rScnGraph.m_entToTreePos[vehicles[1]]], 5u);
+
+    // Remove a part from the middle vehicle
+    std::array const cutParts{added[0]};
+    SysSceneGraph::cut(rScnGraph, cutParts.begin(), cutParts.end());
+    expect_consistent(rScnGraph);
+    EXPECT_EQ(rScnGraph.m_entToTreePos[vehicles[2]], lastVehiclePos);
+    EXPECT_EQ(rScnGraph.m_treeDescendants[rScnGraph.m_entToTreePos[vehicles[1]]], 3u);
+    EXPECT_EQ(children_of(rScnGraph, vehicles[1]).size(), 3u);
+
+    // Remove a whole vehicle
+    std::array const cutVehicles{vehicles[0]};
+    SysSceneGraph::cut(rScnGraph, cutVehicles.begin(), cutVehicles.end());
+    expect_consistent(rScnGraph);
+    EXPECT_EQ(children_of(rScnGraph, lgrn::id_null<ActiveEnt>()),
+              (std::vector<ActiveEnt>{vehicles[1], vehicles[2]}));
+
+    SysSceneGraph::compact(rScnGraph);
+    expect_consistent(rScnGraph);
+    EXPECT_EQ(rScnGraph.m_gapCount, 0u);
+    EXPECT_EQ(rScnGraph.m_treeToEnt.size(), 1u + 4u + 3u);
+}
+
+// Randomly add and remove subtrees, checking the tree stays consistent as gaps are made, reused,
+// and compacted
+TEST(SceneGraph, RandomAddRemove)
+{
+    std::mt19937 gen(1337);
+
+    ACtxBasic basic;
+    ACtxSceneGraph &rScnGraph = basic.m_scnGraph;
+
+    constexpr std::size_t sc_entMax = 1u << 16;
+    basic.m_activeIds.reserve(sc_entMax);
+    rScnGraph.resize(sc_entMax);
+
+    std::vector<ActiveEnt> alive;
+
+    for (int step = 0; step < 2000; ++step)
+    {
+        bool const doAdd = alive.size() < 8 || std::uniform_int_distribution<int>(0, 2)(gen) != 0;
+        if (doAdd && basic.m_activeIds.size() + 8 < sc_entMax)
+        {
+            ActiveEnt const parent = (alive.empty() || std::uniform_int_distribution<int>(0, 3)(gen) == 0)
+                                   ? lgrn::id_null<ActiveEnt>()
+                                   : alive[std::uniform_int_distribution<std::size_t>(0, alive.size() - 1)(gen)];
+
+            auto const count = std::uniform_int_distribution<uint32_t>(1, 4)(gen);
+
+            SubtreeBuilder bld = SysSceneGraph::add_descendants(rScnGraph, count, parent);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                alive.push_back(basic.m_activeIds.create());
+                bld.add_child(alive.back());
+            }
+        }
+        else if ( ! alive.empty() )
+        {
+            ActiveEnt const toCut = alive[std::uniform_int_distribution<std::size_t>(0, alive.size() - 1)(gen)];
+
+            ActiveEntVec_t deleted;
+            std::array const cutEnts{toCut};
+            SysSceneGraph::queue_delete_entities(rScnGraph, deleted, cutEnts.begin(), cutEnts.end());
+
+            for (ActiveEnt const ent : deleted)
+            {
+                std::erase(alive, ent);
+                basic.m_activeIds.remove(ent);
+            }
+        }
+
+        expect_consistent(rScnGraph);
+        if (::testing::Test::HasFailure())
+        {
+            return;
+        }
+    }
+}
+
+// Delete many random entities at once, including some that are descendants of others, like
+// out-of-bounds cleanup does
+TEST(SceneGraph, BulkDelete)
+{
+    std::mt19937 gen(4242);
+
+    ACtxBasic basic;
+    ACtxSceneGraph &rScnGraph = basic.m_scnGraph;
+
+    constexpr std::size_t sc_entMax = 1u << 14;
+    basic.m_activeIds.reserve(sc_entMax);
+    rScnGraph.resize(sc_entMax);
+
+    std::vector<ActiveEnt> alive;
+    while (basic.m_activeIds.size() + 8 < sc_entMax)
+    {
+        ActiveEnt const parent = (alive.empty() || std::uniform_int_distribution<int>(0, 15)(gen) == 0)
+                               ? lgrn::id_null<ActiveEnt>()
+                               : alive[std::uniform_int_distribution<std::size_t>(0, alive.size() - 1)(gen)];
+
+        auto const count = std::uniform_int_distribution<uint32_t>(1, 4)(gen);
+
+        SubtreeBuilder bld = SysSceneGraph::add_descendants(rScnGraph, count, parent);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            alive.push_back(basic.m_activeIds.create());
+            bld.add_child(alive.back());
+        }
+    }
+
+    for (int round = 0; round < 4; ++round)
+    {
+        std::vector<ActiveEnt> toCut;
+        std::sample(alive.begin(), alive.end(), std::back_inserter(toCut), alive.size() / 8, gen);
+        std::shuffle(toCut.begin(), toCut.end(), gen);
+
+        // Expected deletions are the given entities and all of their descendants
+        ActiveEntSet_t expectDeleted;
+        expectDeleted.resize(sc_entMax);
+        for (ActiveEnt const ent : toCut)
+        {
+            expectDeleted.insert(ent);
+            for (ActiveEnt const descendant : SysSceneGraph::descendants(rScnGraph, ent))
+            {
+                expectDeleted.insert(descendant);
+            }
+        }
+
+        ActiveEntVec_t deleted;
+        SysSceneGraph::queue_delete_entities(rScnGraph, deleted, toCut.begin(), toCut.end());
+
+        expect_consistent(rScnGraph);
+        for (ActiveEnt const ent : deleted)
+        {
+            ASSERT_TRUE(expectDeleted.contains(ent));
+            EXPECT_EQ(rScnGraph.m_entToTreePos[ent], lgrn::id_null<TreePos_t>());
+        }
+
+        std::erase_if(alive, [&expectDeleted] (ActiveEnt const ent) { return expectDeleted.contains(ent); });
+        for (ActiveEnt const ent : alive)
+        {
+            ASSERT_NE(rScnGraph.m_entToTreePos[ent], lgrn::id_null<TreePos_t>());
+            EXPECT_EQ(rScnGraph.m_treeToEnt[rScnGraph.m_entToTreePos[ent]], ent);
+        }
+        for (ActiveEnt const ent : deleted)
+        {
+            if (basic.m_activeIds.exists(ent))
+            {
+                basic.m_activeIds.remove(ent);
+            }
+        }
+    }
+}
+
+// Compares recursive and linear propagation on a large scene. Disabled by default, run with
+// --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST(SceneGraph, DISABLED_BenchmarkDrawTransforms)
+{
+    using Clock_t = std::chrono::steady_clock;
+
+    constexpr int           sc_iterations   = 50;
+    constexpr std::size_t   sc_vehicles     = 1000;
+    constexpr std::size_t   sc_parts        = 50;
+
+    VehicleScene scene{sc_vehicles, sc_parts};
+
+    for (ActiveEnt const ent : scene.basic.m_activeIds)
+    {
+        scene.needDrawTf.insert(ent);
+    }
+
+    auto const measure = [&scene] (auto&& update) -> double
+    {
+        update(); // warm up
+        auto const start = Clock_t::now();
+        for (int i = 0; i < sc_iterations; ++i)
+        {
+            update();
+        }
+        std::chrono::duration<double, std::milli> const total = Clock_t::now() - start;
+        return total.count() / sc_iterations;
+    };
+
+    double const recursiveMs = measure([&scene] { scene.update_recursive(); });
+    double const linearMs    = measure([&scene] { scene.update_linear(); });
+
+    std::cout << "Draw transforms for " << scene.basic.m_activeIds.size() << " entities\n"
+              << "  recursive: " << recursiveMs << "ms\n"
+              << "  linear:    " << linearMs    << "ms\n";
+}
@@ -26,9 +26,12 @@
 
 #include <osp/tasks/tasks.h>
 #include <osp/tasks/execute.h>
+#include <osp/tasks/worker_pool.h>
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <latch>
 #include <numeric>
 #include <random>
 #include <set>
@@ -721,5 +724,32 @@ TEST(Tasks, BasicSingleThreadedGameWorld)
 }
 
 
+// Jobs submitted through any copy of a WorkerPool run exactly once
+TEST(Tasks, WorkerPoolRunsAllJobs)
+{
+    constexpr int sc_jobs = 1000;
+
+    std::atomic<int> ran{0};
+    {
+        osp::WorkerPool pool{4};
+        osp::WorkerPool copy = pool;
+        EXPECT_EQ(copy.thread_count(), 4);
+
+        std::latch done{sc_jobs};
+        for (int i = 0; i < sc_jobs; ++i)
+        {
+            osp::WorkerPool &rTarget = (i % 2 == 0) ? pool : copy;
+            rTarget.submit([&ran, &done] { ++ran; done.count_down(); });
+        }
+        done.wait();
+    }
+    EXPECT_EQ(ran, sc_jobs);
+
+    // No threads, runs on the calling thread right away
+    osp::WorkerPool none;
+    none.submit([&ran] { ++ran; });
+    EXPECT_EQ(ran, sc_jobs + 1);
+}
+
 // TODO: Multi-threaded test with limits. Actual multithreading isn't needed;
 //       as long as task_start/finish are called at the right times